@@ -0,0 +1,206 @@
+#include "Benchmark.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+
+namespace {
+    atomic<uint64_t> allocationTotal{0};
+    atomic<uint64_t> byteTotal{0};
+
+    void *countedAllocate(size_t size, size_t alignment) {
+        allocationTotal.fetch_add(1, memory_order_relaxed);
+        byteTotal.fetch_add(size, memory_order_relaxed);
+        if (size == 0) {
+            size = 1;
+        }
+        void *block = alignment <= alignof(max_align_t)
+                          ? malloc(size)
+                          : aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        if (block == nullptr) {
+            throw bad_alloc();
+        }
+        return block;
+    }
+
+    // JSON string literal for text
+    string quoted(const string &text) {
+        string json = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                json += '\\';
+            }
+            json += c;
+        }
+        return json + "\"";
+    }
+}
+
+// Replacements for the global allocation functions; the array and nothrow forms forward to these
+void *operator new(size_t size) {
+    return countedAllocate(size, alignof(max_align_t));
+}
+
+void *operator new(size_t size, align_val_t alignment) {
+    return countedAllocate(size, (size_t) alignment);
+}
+
+void operator delete(void *block) noexcept {
+    free(block);
+}
+
+void operator delete(void *block, size_t) noexcept {
+    free(block);
+}
+
+void operator delete(void *block, align_val_t) noexcept {
+    free(block);
+}
+
+void operator delete(void *block, size_t, align_val_t) noexcept {
+    free(block);
+}
+
+Benchmark::State::State(long size, uint64_t iterations)
+    : size(size), iterations(iterations), structureAllocationsAtStart(structures.size()),
+      structureAllocations(structures.size()), started(chrono::steady_clock::now()),
+      allocationsAtStart(allocationCount()), bytesAtStart(allocatedByteCount()) {
+    for (size_t i = 0; i < structures.size(); i++) {
+        structureAllocationsAtStart[i] = structures[i]->usage().allocations;
+    }
+}
+
+void Benchmark::State::pause() {
+    if (running) {
+        elapsed += chrono::steady_clock::now() - started;
+        allocations += allocationCount() - allocationsAtStart;
+        allocatedBytes += allocatedByteCount() - bytesAtStart;
+        for (size_t i = 0; i < structures.size(); i++) {
+            structureAllocations[i] += structures[i]->usage().allocations - structureAllocationsAtStart[i];
+        }
+        running = false;
+    }
+}
+
+void Benchmark::State::resume() {
+    if (!running) {
+        allocationsAtStart = allocationCount();
+        bytesAtStart = allocatedByteCount();
+        for (size_t i = 0; i < structures.size(); i++) {
+            structureAllocationsAtStart[i] = structures[i]->usage().allocations;
+        }
+        running = true;
+        started = chrono::steady_clock::now();
+    }
+}
+
+void Benchmark::add(const string &name, const vector<long> &sizes, const Body &body) {
+    benchmarks.push_back(Registered{name, sizes, body});
+}
+
+vector<Benchmark::Result> Benchmark::run(const string &filter, double minSeconds) const {
+    vector<Result> results;
+    for (const Registered &benchmark : benchmarks) {
+        if (benchmark.name.find(filter) == string::npos) {
+            continue;
+        }
+        for (long size : benchmark.sizes) {
+            // Grow the run until it is long enough to time, aiming a bit past the minimum
+            uint64_t iterations = 1;
+            while (true) {
+                for (CountingResource *structure : CountingResource::all()) {
+                    structure->resetPeak();
+                }
+                State state(size, iterations);
+                benchmark.body(state);
+                state.pause();
+                double seconds = chrono::duration<double>(state.getElapsed()).count();
+                if (seconds >= minSeconds || iterations >= 1000000000) {
+                    Result result{benchmark.name, size, iterations, seconds * 1e9 / iterations,
+                                  (double) state.getAllocations() / iterations,
+                                  (double) state.getAllocatedBytes() / iterations, {}};
+                    for (size_t i = 0; i < state.structures.size(); i++) {
+                        uint64_t structureAllocations = state.getStructureAllocations()[i];
+                        if (structureAllocations > 0) {
+                            result.memory.push_back(StructureMemory{
+                                state.structures[i]->getName(), (double) structureAllocations / iterations,
+                                state.structures[i]->usage().peakBytes});
+                        }
+                    }
+                    sort(result.memory.begin(), result.memory.end(),
+                         [](const StructureMemory &a, const StructureMemory &b) { return a.name < b.name; });
+                    results.push_back(result);
+                    break;
+                }
+                double estimate = seconds > 0 ? minSeconds * 1.4 / seconds * iterations : iterations * 100.0;
+                iterations = (uint64_t) min(max(estimate, iterations * 2.0), iterations * 100.0);
+            }
+        }
+    }
+    return results;
+}
+
+void Benchmark::printTable(ostream &out, const vector<Result> &results) {
+    char line[160];
+    snprintf(line, sizeof(line), "%-36s %8s %12s %14s %11s %11s\n", "Benchmark", "Size", "Iterations", "ns/op",
+             "allocs/op", "bytes/op");
+    out << line;
+    for (const Result &result : results) {
+        snprintf(line, sizeof(line), "%-36s %8ld %12llu %14.1f %11.2f %11.1f\n", result.name.c_str(), result.size,
+                 (unsigned long long) result.iterations, result.nsPerOp, result.allocsPerOp, result.bytesPerOp);
+        out << line;
+    }
+
+    out << "\n";
+    snprintf(line, sizeof(line), "%-36s %8s %-20s %11s %14s\n", "Benchmark", "Size", "Structure", "allocs/op",
+             "peak bytes");
+    out << line;
+    for (const Result &result : results) {
+        for (const StructureMemory &memory : result.memory) {
+            snprintf(line, sizeof(line), "%-36s %8ld %-20s %11.2f %14zu\n", result.name.c_str(), result.size,
+                     memory.name.c_str(), memory.allocsPerOp, memory.peakBytes);
+            out << line;
+        }
+    }
+}
+
+void Benchmark::printJson(ostream &out, const vector<Result> &results) {
+    char date[32];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+#ifdef NDEBUG
+    const char *build = "release";
+#else
+    const char *build = "debug";
+#endif
+    out << "{\n  \"context\": {\"date\": " << quoted(date) << ", \"build\": " << quoted(build) << "},\n"
+        << "  \"benchmarks\": [";
+    char numbers[160];
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &result = results[i];
+        snprintf(numbers, sizeof(numbers),
+                 "\"size\": %ld, \"iterations\": %llu, \"ns_per_op\": %.3f, \"allocs_per_op\": %.4f, "
+                 "\"bytes_per_op\": %.2f", result.size, (unsigned long long) result.iterations, result.nsPerOp,
+                 result.allocsPerOp, result.bytesPerOp);
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": " << quoted(result.name) << ", " << numbers
+            << ", \"memory\": {";
+        for (size_t j = 0; j < result.memory.size(); j++) {
+            const StructureMemory &memory = result.memory[j];
+            snprintf(numbers, sizeof(numbers), "\"allocs_per_op\": %.4f, \"peak_bytes\": %zu", memory.allocsPerOp,
+                     memory.peakBytes);
+            out << (j == 0 ? "" : ", ") << quoted(memory.name) << ": {" << numbers << "}";
+        }
+        out << "}}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+uint64_t Benchmark::allocationCount() {
+    return allocationTotal.load(memory_order_relaxed);
+}
+
+uint64_t Benchmark::allocatedByteCount() {
+    return byteTotal.load(memory_order_relaxed);
+}
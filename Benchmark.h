@@ -0,0 +1,158 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "CountingResource.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  Benchmark                                                             *
+ *  A small microbenchmark harness. Each benchmark is run at several     *
+ *  data sizes; the number of operations is raised until a run takes at  *
+ *  least the minimum time, and the harness reports nanoseconds,         *
+ *  heap allocations and allocated bytes per operation. Allocations are  *
+ *  counted by the replacement operator new linked into the benchmark   *
+ *  executable with Benchmark.cpp. The accounts of the data structures  *
+ *  (see CountingResource) break them down: allocations per operation   *
+ *  and peak bytes of each structure that allocated during a run.       *
+ *------------------------------------------------------------------------*/
+class Benchmark {
+public:
+    // Measures one run of a benchmark: size is its data size, iterations the operations to do
+    class State {
+    public:
+        const long size;
+        const uint64_t iterations;
+        const vector<CountingResource *> structures = CountingResource::all(); // the accounts there are
+
+        State(long size, uint64_t iterations);
+
+        // Stop and restart the clock and the allocation counters, e.g. around setup
+        void pause();
+
+        void resume();
+
+        /*------------------------------------------------------------------------*
+         *  repeat                                                                *
+         *  Does the run's iterations: operation(fixture, i) up to               *
+         *  opsPerFixture times on each fixture made by setup. Only the         *
+         *  operations are measured, not making and destroying the fixtures.   *
+         *                                                                        *
+         *  Precondition:  The clock is running; opsPerFixture > 0.              *
+         *  Postcondition: operation ran iterations times; the clock is paused.  *
+         *------------------------------------------------------------------------*/
+        template <typename Setup, typename Operation>
+        void repeat(Setup setup, Operation operation, uint64_t opsPerFixture) {
+            uint64_t done = 0;
+            while (done < iterations) {
+                pause();
+                auto fixture = setup();
+                uint64_t count = min(opsPerFixture, iterations - done);
+                resume();
+                for (uint64_t i = 0; i < count; i++) {
+                    operation(fixture, i);
+                }
+                pause(); // the fixture is destroyed unmeasured
+                done += count;
+            }
+        }
+
+        chrono::steady_clock::duration getElapsed() const { return elapsed; }
+
+        uint64_t getAllocations() const { return allocations; }
+
+        uint64_t getAllocatedBytes() const { return allocatedBytes; }
+
+        // Allocations each structure made while the clock ran, in the order of structures
+        const vector<uint64_t> &getStructureAllocations() const { return structureAllocations; }
+
+    private:
+        // Sized before the clock starts, so that the counters themselves allocate nothing measured
+        vector<uint64_t> structureAllocationsAtStart;
+        vector<uint64_t> structureAllocations;
+
+        bool running = true;
+        chrono::steady_clock::time_point started;
+        uint64_t allocationsAtStart;
+        uint64_t bytesAtStart;
+
+        chrono::steady_clock::duration elapsed{};
+        uint64_t allocations = 0;
+        uint64_t allocatedBytes = 0;
+    };
+
+    // The memory one structure used in a run
+    struct StructureMemory {
+        string name;
+        double allocsPerOp;
+        size_t peakBytes;
+    };
+
+    // One benchmark at one size
+    struct Result {
+        string name;
+        long size;
+        uint64_t iterations;
+        double nsPerOp;
+        double allocsPerOp;
+        double bytesPerOp;
+        vector<StructureMemory> memory; // structures that allocated, by name
+    };
+
+    using Body = function<void(State &state)>;
+
+    /*------------------------------------------------------------------------*
+     *  add                                                                   *
+     *  Registers a benchmark to run at each of sizes.                        *
+     *                                                                        *
+     *  Precondition:  body does state.iterations operations.                 *
+     *  Postcondition: run() will measure it.                                 *
+     *------------------------------------------------------------------------*/
+    void add(const string &name, const vector<long> &sizes, const Body &body);
+
+    /*------------------------------------------------------------------------*
+     *  run                                                                   *
+     *  Runs every registered benchmark whose name contains filter.           *
+     *                                                                        *
+     *  Precondition:  minSeconds > 0.                                        *
+     *  Postcondition: Returns a result per benchmark and size.               *
+     *------------------------------------------------------------------------*/
+    vector<Result> run(const string &filter, double minSeconds) const;
+
+    // Writes results as an aligned table
+    static void printTable(ostream &out, const vector<Result> &results);
+
+    // Writes results as JSON, for comparing builds and versions
+    static void printJson(ostream &out, const vector<Result> &results);
+
+    // Heap allocations and bytes allocated since the program started
+    static uint64_t allocationCount();
+
+    static uint64_t allocatedByteCount();
+
+    // Keeps the compiler from optimizing value, and the work that made it, away
+    template <typename T>
+    static void keep(const T &value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+private:
+    struct Registered {
+        string name;
+        vector<long> sizes;
+        Body body;
+    };
+
+    vector<Registered> benchmarks;
+};
+
+#endif //BENCHMARK_H
@@ -0,0 +1,130 @@
+#include "BestSellers.h"
+#include "LocalTime.h"
+
+#include <algorithm>
+#include <cmath>
+
+BestSellers::BestSellers(int k, double epsilon, double delta) {
+    this->k = k;
+    width = (int) ceil(exp(1.0) / epsilon);
+    depth = (int) ceil(log(1.0 / delta));
+    counters.assign((size_t) width * depth, 0);
+
+    // Fixed, distinct odd seeds so estimates are reproducible across runs
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (int row = 0; row < depth; row++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        seeds.push_back(seed | 1);
+    }
+
+    day = -1;
+}
+
+int BestSellers::column(int row, int itemId) const {
+    /*------------------------------------------------------------*
+     *  column                                                    *
+     *  Seeded multiply followed by a 64-bit finalizer mix, then  *
+     *  reduced onto the row's width.                             *
+     *------------------------------------------------------------*/
+    uint64_t x = (uint64_t) (uint32_t) itemId * seeds[row];
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    return (int) (x % (uint64_t) width);
+}
+
+void BestSellers::record(int itemId, int64_t count, time_t when) {
+    long long saleDay = localDay(when);
+    if (saleDay < day) {
+        return; // the counts of that day are gone
+    }
+    if (saleDay > day) {
+        fill(counters.begin(), counters.end(), 0);
+        heap.clear();
+        heapIndex.clear();
+        day = saleDay;
+    }
+
+    int64_t estimated = INT64_MAX;
+    for (int row = 0; row < depth; row++) {
+        int64_t &counter = counters[(size_t) row * width + column(row, itemId)];
+        counter += count;
+        estimated = min(estimated, counter);
+    }
+
+    auto found = heapIndex.find(itemId);
+    if (found != heapIndex.end()) {
+        // Estimates only grow, so the entry can only move away from the root
+        heap[found->second].count = estimated;
+        siftDown(found->second);
+    } else if ((int) heap.size() < k) {
+        heap.push_back(Entry{itemId, estimated});
+        int position = (int) heap.size() - 1;
+        heapIndex[itemId] = position;
+        while (position > 0 && heap[(position - 1) / 2].count > heap[position].count) {
+            swapEntries(position, (position - 1) / 2);
+            position = (position - 1) / 2;
+        }
+    } else if (estimated > heap[0].count) {
+        heapIndex.erase(heap[0].itemId);
+        heap[0] = Entry{itemId, estimated};
+        heapIndex[itemId] = 0;
+        siftDown(0);
+    }
+}
+
+int64_t BestSellers::estimate(int itemId, time_t now) const {
+    if (localDay(now) != day) {
+        return 0;
+    }
+    int64_t estimated = INT64_MAX;
+    for (int row = 0; row < depth; row++) {
+        estimated = min(estimated, counters[(size_t) row * width + column(row, itemId)]);
+    }
+    return estimated;
+}
+
+const vector<BestSellers::Entry> &BestSellers::top(time_t now) const {
+    static const vector<Entry> none;
+    return localDay(now) == day ? heap : none;
+}
+
+vector<BestSellers::Entry> BestSellers::topSorted(time_t now) const {
+    vector<Entry> sorted = top(now);
+    sort(sorted.begin(), sorted.end(), [](const Entry &a, const Entry &b) { return a.count > b.count; });
+    return sorted;
+}
+
+int BestSellers::getWidth() const {
+    return width;
+}
+
+int BestSellers::getDepth() const {
+    return depth;
+}
+
+void BestSellers::siftDown(int position) {
+    int size = (int) heap.size();
+    while (true) {
+        int smallest = position;
+        int left = 2 * position + 1;
+        int right = left + 1;
+        if (left < size && heap[left].count < heap[smallest].count) {
+            smallest = left;
+        }
+        if (right < size && heap[right].count < heap[smallest].count) {
+            smallest = right;
+        }
+        if (smallest == position) {
+            return;
+        }
+        swapEntries(position, smallest);
+        position = smallest;
+    }
+}
+
+void BestSellers::swapEntries(int a, int b) {
+    swap(heap[a], heap[b]);
+    heapIndex[heap[a].itemId] = a;
+    heapIndex[heap[b].itemId] = b;
+}
@@ -0,0 +1,106 @@
+#ifndef BESTSELLERS_H
+#define BESTSELLERS_H
+
+#include <cstdint>
+#include <ctime>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  BestSellers                                                           *
+ *  Streaming heavy hitters over the menu items of completed orders. A    *
+ *  Count-Min sketch estimates how often each item sold, in memory fixed *
+ *  by the error bounds rather than by the number of items, and a min-    *
+ *  heap of the k largest estimates answers "what sold most?" without     *
+ *  looking at any order.                                                 *
+ *                                                                        *
+ *  Estimates never undercount; with probability 1 - delta they over-     *
+ *  count by at most epsilon times the total number of items recorded.    *
+ *                                                                        *
+ *  The counts cover one local calendar day, like the day buckets of     *
+ *  RevenueRollup: the first sale of a new day starts them over, and a    *
+ *  day with no sales yet has no best sellers.                            *
+ *------------------------------------------------------------------------*/
+class BestSellers {
+public:
+    // One menu item and its estimated number of sales
+    struct Entry {
+        int itemId;
+        int64_t count;
+    };
+
+    /*------------------------------------------------------------------------*
+     *  BestSellers                                                           *
+     *  Parameterized constructor. Sizes the sketch for the given error       *
+     *  bounds: width e / epsilon and depth ln(1 / delta).                    *
+     *                                                                        *
+     *  Precondition:  k > 0, 0 < epsilon < 1 and 0 < delta < 1.              *
+     *  Postcondition: The sketch and the top-k heap are empty.               *
+     *------------------------------------------------------------------------*/
+    BestSellers(int k = 10, double epsilon = 0.001, double delta = 0.01);
+
+    /*------------------------------------------------------------------------*
+     *  record                                                                *
+     *  Adds count sales of a menu item, made at when. A sale on a later day *
+     *  than the counts cover first clears them; one on an earlier day is    *
+     *  dropped.                                                              *
+     *                                                                        *
+     *  Precondition:  count > 0.                                             *
+     *  Postcondition: The sketch and, if the item qualifies, the heap        *
+     *                 include the sales. Runs in O(depth + log k), plus     *
+     *                 O(width * depth) once a day.                           *
+     *------------------------------------------------------------------------*/
+    void record(int itemId, int64_t count = 1, time_t when = time(0));
+
+    /*------------------------------------------------------------------------*
+     *  estimate                                                              *
+     *  Returns the estimated number of sales of a menu item on the day of   *
+     *  now.                                                                  *
+     *------------------------------------------------------------------------*/
+    int64_t estimate(int itemId, time_t now = time(0)) const;
+
+    /*------------------------------------------------------------------------*
+     *  top                                                                   *
+     *  Returns the top-k items of the day of now, in heap order (unsorted). *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: At most k entries are returned, in constant time.      *
+     *------------------------------------------------------------------------*/
+    const vector<Entry> &top(time_t now = time(0)) const;
+
+    /*------------------------------------------------------------------------*
+     *  topSorted                                                             *
+     *  Returns the top-k items of the day of now, from best to least        *
+     *  selling.                                                              *
+     *------------------------------------------------------------------------*/
+    vector<Entry> topSorted(time_t now = time(0)) const;
+
+    // Shape of the sketch
+    int getWidth() const;
+
+    int getDepth() const;
+
+private:
+    int k; // Number of heavy hitters kept
+    int width; // Counters per row
+    int depth; // Rows, one hash function each
+    vector<int64_t> counters; // depth rows of width counters, row-major
+    vector<uint64_t> seeds; // Hash seed of each row
+
+    vector<Entry> heap; // Min-heap on count of the current top k
+    unordered_map<int, int> heapIndex; // itemId -> position in heap
+
+    long long day; // local day the counts cover, -1 before the first sale
+
+    // Column of itemId in a row
+    int column(int row, int itemId) const;
+
+    // Heap maintenance keeping heapIndex in step
+    void siftDown(int position);
+
+    void swapEntries(int a, int b);
+};
+
+#endif //BESTSELLERS_H
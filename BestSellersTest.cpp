@@ -0,0 +1,58 @@
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+#include "BestSellers.h"
+#include "TestCheck.h"
+
+using namespace std;
+
+namespace {
+    // A local wall-clock time in the test's time zone
+    time_t localAt(int year, int month, int day, int hour, int minute) {
+        tm fields{};
+        fields.tm_year = year - 1900;
+        fields.tm_mon = month - 1;
+        fields.tm_mday = day;
+        fields.tm_hour = hour;
+        fields.tm_min = minute;
+        fields.tm_isdst = -1;
+        return mktime(&fields);
+    }
+
+    void testTopOfTheDay() {
+        BestSellers sellers(2);
+        time_t noon = localAt(2024, 1, 15, 12, 0);
+        sellers.record(1, 5, noon);
+        sellers.record(2, 9, noon);
+        sellers.record(3, 1, noon);
+        sellers.record(1, 6, noon);
+
+        vector<BestSellers::Entry> top = sellers.topSorted(noon);
+        CHECK(top.size() == 2 && top[0].itemId == 1 && top[0].count >= 11 && top[1].itemId == 2);
+        CHECK(sellers.estimate(2, noon) >= 9);
+        CHECK(sellers.top(localAt(2024, 1, 16, 12, 0)).empty());
+    }
+
+    // The day of a sale follows the offset in effect at the sale, in winter and in summer
+    void testDaysFollowTheOffsetOfTheirDate() {
+        BestSellers winter;
+        winter.record(7, 3, localAt(2024, 1, 15, 23, 30));
+        CHECK(winter.estimate(7, localAt(2024, 1, 15, 0, 10)) == 3);
+        CHECK(winter.estimate(7, localAt(2024, 1, 16, 0, 10)) == 0);
+
+        BestSellers summer;
+        summer.record(7, 3, localAt(2024, 7, 14, 23, 30));
+        summer.record(7, 4, localAt(2024, 7, 15, 0, 30)); // a new day starts the counts over
+        CHECK(summer.estimate(7, localAt(2024, 7, 15, 23, 50)) == 4);
+        CHECK(summer.estimate(7, localAt(2024, 7, 14, 23, 50)) == 0);
+    }
+}
+
+int main() {
+    setenv("TZ", "EST5EDT,M3.2.0,M11.1.0", 1);
+    tzset();
+    testTopOfTheDay();
+    testDaysFollowTheOffsetOfTheirDate();
+    return testResult();
+}
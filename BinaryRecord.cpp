@@ -0,0 +1,41 @@
+#include "BinaryRecord.h"
+
+void RecordWriter::putString(const string &value) {
+    put<uint32_t>((uint32_t) value.size());
+    buffer += value;
+}
+
+void RecordWriter::putMenuItem(const MenuItem &item) {
+    put<int32_t>(item.getId());
+    putString(item.getName());
+    putString(item.getDescription());
+    put<double>(item.getPrice());
+    putString(item.getCategory());
+}
+
+string RecordReader::getString() {
+    return string(getBytes());
+}
+
+string_view RecordReader::getBytes() {
+    uint32_t length = get<uint32_t>();
+    need(length);
+    string_view value(data + pos, length);
+    pos += length;
+    return value;
+}
+
+MenuItem RecordReader::getMenuItem() {
+    int32_t id = get<int32_t>();
+    string name = getString();
+    string description = getString();
+    double price = get<double>();
+    string category = getString();
+    return MenuItem(id, name, description, price, category);
+}
+
+void RecordReader::need(size_t count) const {
+    if (size - pos < count) {
+        throw runtime_error("Truncated record");
+    }
+}
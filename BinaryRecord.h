@@ -0,0 +1,82 @@
+#ifndef BINARYRECORD_H
+#define BINARYRECORD_H
+
+#include "MenuItem.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  RecordWriter                                                          *
+ *  Appends fixed-width values (host byte order), length-prefixed         *
+ *  strings and menu items to a byte buffer. Used by the journal and its  *
+ *  checkpoints, which store orders as OrderCodec batches inside strings. *
+ *------------------------------------------------------------------------*/
+class RecordWriter {
+public:
+    template <typename T>
+    void put(T value) {
+        buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    void putString(const string &value);
+
+    void putMenuItem(const MenuItem &item);
+
+    // Bytes written so far
+    const string &data() const { return buffer; }
+
+    void clear() { buffer.clear(); }
+
+private:
+    string buffer; // encoded bytes
+};
+
+/*------------------------------------------------------------------------*
+ *  RecordReader                                                          *
+ *  Reads back what a RecordWriter wrote. Reading past the end of the     *
+ *  bytes throws runtime_error, so a truncated record is never taken for  *
+ *  a complete one.                                                       *
+ *------------------------------------------------------------------------*/
+class RecordReader {
+public:
+    RecordReader(const char *data, size_t size) : data(data), size(size), pos(0) {
+    }
+
+    template <typename T>
+    T get() {
+        T value;
+        need(sizeof(T));
+        memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    string getString();
+
+    // A string written by putString, viewed in place
+    string_view getBytes();
+
+    MenuItem getMenuItem();
+
+    // True once every byte has been read
+    bool atEnd() const { return pos == size; }
+
+    size_t getPosition() const { return pos; }
+
+private:
+    const char *data; // bytes being read, not owned
+    size_t size; // number of bytes
+    size_t pos; // next byte to read
+
+    // Throws unless count more bytes are available
+    void need(size_t count) const;
+};
+
+#endif //BINARYRECORD_H
@@ -0,0 +1,222 @@
+#include "CommandScript.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+    // Copy of value without leading and trailing blanks
+    string trim(const string &value) {
+        size_t first = value.find_first_not_of(" \t\r");
+        if (first == string::npos) {
+            return "";
+        }
+        size_t last = value.find_last_not_of(" \t\r");
+        return value.substr(first, last - first + 1);
+    }
+
+    // Parses all of text as a whole number from low to INT_MAX
+    bool parseInt(const string &text, int &value, int low) {
+        char *end;
+        errno = 0;
+        long parsed = strtol(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0' || errno == ERANGE || parsed < low || parsed > INT_MAX) {
+            return false;
+        }
+        value = (int) parsed;
+        return true;
+    }
+}
+
+CommandScript::CommandScript(DynamicArrayList &menu, MenuCatalog &catalog, Queue &active, Stack &completed,
+                             OrderPipeline &pipeline, Journal &journal, const function<void()> &checkpoint)
+    : menu(menu), catalog(catalog), active(active), completed(completed), pipeline(pipeline), journal(journal),
+      checkpoint(checkpoint) {
+}
+
+int CommandScript::run(istream &in) {
+    auto start = chrono::steady_clock::now();
+    int failedBefore = failedCount;
+    string line;
+    for (int lineNumber = 1; getline(in, line); lineNumber++) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t space = line.find_first_of(" \t");
+        string command = line.substr(0, space);
+        string arguments = space == string::npos ? "" : trim(line.substr(space));
+
+        commandCount++;
+        string error = execute(command, arguments);
+        if (!error.empty()) {
+            cerr << "Line " << lineNumber << ": " << error << endl;
+            failedCount++;
+        }
+        if (journal.checkpointDue()) {
+            checkpoint();
+        }
+    }
+    publishMenu();
+    elapsed += chrono::steady_clock::now() - start;
+    return failedCount - failedBefore;
+}
+
+void CommandScript::printSummary(ostream &out) const {
+    double seconds = chrono::duration<double>(elapsed).count();
+    out << commandCount << " commands in " << seconds << " s";
+    if (seconds > 0) {
+        out << " (" << (long) (commandCount / seconds) << " commands/s)";
+    }
+    out << ", " << failedCount << " failed" << endl;
+    out << "Menu items added: " << itemsAdded << ", orders added: " << ordersAdded
+        << ", orders processed: " << ordersProcessed << endl;
+    char revenue[32];
+    snprintf(revenue, sizeof(revenue), "%.2f", completed.getTotalRevenue());
+    out << "Active orders: " << active.size() << ", completed orders: " << completed.getSize()
+        << ", total revenue: $" << revenue << endl;
+}
+
+string CommandScript::execute(const string &command, const string &arguments) {
+    if (command == "add-item") {
+        // name,description,price like a line of menu.txt
+        size_t first = arguments.find(',');
+        size_t last = arguments.rfind(',');
+        if (first == string::npos || first == last) {
+            return "add-item needs <name>,<description>,<price>";
+        }
+        string name = trim(arguments.substr(0, first));
+        string description = trim(arguments.substr(first + 1, last - first - 1));
+        char *end;
+        string priceText = trim(arguments.substr(last + 1));
+        double price = strtod(priceText.c_str(), &end);
+        if (name.empty() || priceText.empty() || *end != '\0' || price < 0) {
+            return "Bad menu item: " + arguments;
+        }
+        int id = menu.addMenuItem(name, description, price);
+        journal.menuItemAdded(menu.getMenuItem(menu.getSize() - 1));
+        if (!indexStale) {
+            itemIndex[id] = menu.getSize() - 1;
+        }
+        catalogStale = true;
+        itemsAdded++;
+        return "";
+    }
+    if (command == "delete-item") {
+        int id;
+        if (!parseInt(arguments, id, 0)) {
+            return "delete-item needs an item ID";
+        }
+        if (!menu.deleteMenuItem(id)) {
+            return "Menu item with ID " + arguments + " not found";
+        }
+        journal.menuItemDeleted(id);
+        indexStale = true; // later items moved down
+        catalogStale = true;
+        return "";
+    }
+    if (command == "reset-menu") {
+        menu.resetMenu();
+        journal.menuReset();
+        indexStale = true;
+        catalogStale = true;
+        return "";
+    }
+    if (command == "add-order") {
+        return addOrder(arguments);
+    }
+    if (command == "process") {
+        int count = 1;
+        if (arguments == "all") {
+            ordersProcessed += active.drainAll(&completed);
+            return "";
+        }
+        if (!arguments.empty() && !parseInt(arguments, count, 1)) {
+            return "process needs a count or all";
+        }
+        ordersProcessed += active.processNextOrders(&completed, count);
+        return "";
+    }
+    if (command == "pipeline") {
+        publishMenu();
+        int before = pipeline.getCompletedCount();
+        while (!active.isEmpty()) {
+            pipeline.submit(active.dequeue());
+        }
+        pipeline.waitIdle();
+        ordersProcessed += pipeline.getCompletedCount() - before;
+        return "";
+    }
+    if (command == "save") {
+        completed.saveCompletedOrders(menu);
+        journal.completedSaved();
+        checkpoint();
+        return "";
+    }
+    if (command == "checkpoint") {
+        checkpoint();
+        return "";
+    }
+    return "Unknown command " + command;
+}
+
+string CommandScript::addOrder(const string &arguments) {
+    stringstream fields(arguments);
+    string customerName;
+    getline(fields, customerName, ',');
+    customerName = trim(customerName);
+    if (customerName.empty()) {
+        return "add-order needs <customer>,<item>[,<item>...]";
+    }
+
+    Order order(customerName, OrderLines());
+    string field;
+    while (getline(fields, field, ',')) {
+        // <id> or <id>x<quantity>
+        field = trim(field);
+        size_t times = field.find('x');
+        int id;
+        int quantity = 1;
+        if (!parseInt(field.substr(0, times), id, 0)
+            || (times != string::npos && !parseInt(field.substr(times + 1), quantity, 1))) {
+            return "Bad order item: " + field;
+        }
+        int index = findItem(id);
+        if (index == -1) {
+            return "Menu item with ID " + to_string(id) + " not found";
+        }
+        for (const OrderLine &line : order.getLines()) {
+            if (line.menuItemId == id && line.quantity > INT_MAX - quantity) {
+                return "Bad order item: " + field + " (too many in total)";
+            }
+        }
+        order.addItem(menu.getMenuItem(index), quantity);
+    }
+    if (order.getLines().empty()) {
+        return "Order for " + customerName + " has no items";
+    }
+    active.enqueue(std::move(order));
+    ordersAdded++;
+    return "";
+}
+
+int CommandScript::findItem(int id) {
+    if (indexStale) {
+        itemIndex.clear();
+        for (int i = 0; i < menu.getSize(); i++) {
+            itemIndex[menu.getMenuItem(i).getId()] = i;
+        }
+        indexStale = false;
+    }
+    auto found = itemIndex.find(id);
+    return found == itemIndex.end() ? -1 : found->second;
+}
+
+void CommandScript::publishMenu() {
+    if (catalogStale) {
+        catalog.publish(menu);
+        catalogStale = false;
+    }
+}
@@ -0,0 +1,120 @@
+#ifndef COMMANDSCRIPT_H
+#define COMMANDSCRIPT_H
+
+#include "DynamicArrayList.h"
+#include "Journal.h"
+#include "MenuCatalog.h"
+#include "OrderPipeline.h"
+#include "Queue.h"
+#include "Stack.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  QuietConsole                                                          *
+ *  Silences cout while it lives. With badbit set, every << on cout      *
+ *  returns at once, so the per-item messages of the menu and order       *
+ *  classes cost nothing, not even formatting. cerr is left alone.        *
+ *------------------------------------------------------------------------*/
+class QuietConsole {
+public:
+    QuietConsole() : state(cout.rdstate()) {
+        cout.setstate(ios::badbit);
+    }
+
+    ~QuietConsole() {
+        cout.clear(state);
+    }
+
+    QuietConsole(const QuietConsole &console) = delete;
+
+    QuietConsole &operator=(const QuietConsole &console) = delete;
+
+private:
+    ios::iostate state; // cout's state before it was silenced
+};
+
+/*------------------------------------------------------------------------*
+ *  CommandScript                                                         *
+ *  Runs the console's operations from a stream of commands, one per     *
+ *  line, without prompting:                                              *
+ *                                                                        *
+ *    add-item <name>,<description>,<price>                               *
+ *    delete-item <id>                                                    *
+ *    reset-menu                                                          *
+ *    add-order <customer>,<item>[,<item>...]   item: <id> or <id>x<qty>  *
+ *    process [<count>|all]      move active orders to the completed ones *
+ *    pipeline                   process every active order in parallel  *
+ *    save                       save the completed orders to the file    *
+ *    checkpoint                 write a journal checkpoint               *
+ *                                                                        *
+ *  Blank lines and lines starting with # are skipped. A bad command is  *
+ *  reported on cerr with its line number and the script goes on.         *
+ *------------------------------------------------------------------------*/
+class CommandScript {
+public:
+    /*------------------------------------------------------------------------*
+     *  CommandScript                                                         *
+     *  Parameterized constructor. The script works on the given state, the  *
+     *  same objects the interactive console uses.                            *
+     *                                                                        *
+     *  Precondition:  The objects outlive the script; checkpoint writes a   *
+     *                 journal checkpoint of them.                            *
+     *  Postcondition: No command has run yet.                                *
+     *------------------------------------------------------------------------*/
+    CommandScript(DynamicArrayList &menu, MenuCatalog &catalog, Queue &active, Stack &completed,
+                  OrderPipeline &pipeline, Journal &journal, const function<void()> &checkpoint);
+
+    /*------------------------------------------------------------------------*
+     *  run                                                                   *
+     *  Runs every command read from in.                                      *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: Returns the number of commands that failed. The       *
+     *                 catalog holds the final menu.                          *
+     *------------------------------------------------------------------------*/
+    int run(istream &in);
+
+    // Writes what was run, and how fast, to out
+    void printSummary(ostream &out) const;
+
+private:
+    DynamicArrayList &menu;
+    MenuCatalog &catalog;
+    Queue &active;
+    Stack &completed;
+    OrderPipeline &pipeline;
+    Journal &journal;
+    function<void()> checkpoint;
+
+    unordered_map<int, int> itemIndex; // menu item ID -> position in menu
+    bool indexStale = true; // itemIndex must be rebuilt before use
+    bool catalogStale = false; // the menu changed since it was last published
+
+    // Totals for the summary
+    int commandCount = 0;
+    int failedCount = 0;
+    int itemsAdded = 0;
+    int ordersAdded = 0;
+    int ordersProcessed = 0;
+    chrono::steady_clock::duration elapsed{};
+
+    // Runs one command; returns an error message, empty on success
+    string execute(const string &command, const string &arguments);
+
+    string addOrder(const string &arguments);
+
+    // Position of item id in the menu, or -1
+    int findItem(int id);
+
+    // Publishes the menu to the pipeline's catalog if it changed
+    void publishMenu();
+};
+
+#endif //COMMANDSCRIPT_H
@@ -0,0 +1,48 @@
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+#include "CommandScript.h"
+#include "TestCheck.h"
+
+using namespace std;
+
+int main() {
+    string prefix = (filesystem::temp_directory_path() / ("command-script-test-" + to_string(getpid()))).string();
+    {
+        Journal journal(prefix + ".ckpt", prefix + ".wal", 1000, false);
+        DynamicArrayList menu;
+        menu.add(MenuItem(1, "Pizza", "Cheese", 8.99));
+        menu.add(MenuItem(2, "Burger", "Beef", 5.49));
+        MenuCatalog catalog(menu);
+        Queue active;
+        Stack completed;
+        OrderPipeline pipeline(completed, &catalog);
+        CommandScript script(menu, catalog, active, completed, pipeline, journal, [] {});
+
+        // Each out-of-range number is one failed line; nothing is truncated into range
+        stringstream in("add-order Ada,1x3,2\n"
+                        "add-order Bob,4294967297\n"
+                        "add-order Bob,1x4294967297\n"
+                        "add-order Bob,1x-2\n"
+                        "add-order Bob,-1\n"
+                        "add-order Bob,1x2147483647,1x1\n"
+                        "add-order Cy,1x2147483647\n"
+                        "process 4294967297\n"
+                        "process 0\n"
+                        "process -1\n"
+                        "delete-item 4294967297\n"
+                        "process 1\n");
+        CHECK(script.run(in) == 9);
+        CHECK(completed.getSize() == 1 && active.size() == 1);
+        CHECK(menu.getSize() == 2);
+
+        const OrderLines &lines = active.peek().getLines();
+        CHECK(lines.size() == 1 && lines[0].menuItemId == 1 && lines[0].quantity == 2147483647);
+    }
+    remove((prefix + ".ckpt").c_str());
+    remove((prefix + ".wal").c_str());
+    return testResult();
+}
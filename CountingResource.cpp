@@ -0,0 +1,127 @@
+#include "CountingResource.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+
+namespace {
+    // Every live resource; a function-local static, so resources at namespace scope can register
+    struct Registry {
+        mutex lock;
+        vector<CountingResource *> resources;
+    };
+
+    Registry &registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    // Formats bytes with a unit that keeps it short
+    string formatBytes(size_t bytes) {
+        char text[32];
+        if (bytes < 1024) {
+            snprintf(text, sizeof(text), "%zu B", bytes);
+        } else if (bytes < 1024 * 1024) {
+            snprintf(text, sizeof(text), "%.1f KiB", bytes / 1024.0);
+        } else {
+            snprintf(text, sizeof(text), "%.1f MiB", bytes / (1024.0 * 1024.0));
+        }
+        return text;
+    }
+}
+
+CountingResource::CountingResource(const string &name, pmr::memory_resource *upstream)
+    : name(name), upstream(upstream) {
+    Registry &resources = registry();
+    lock_guard<mutex> guard(resources.lock);
+    resources.resources.push_back(this);
+}
+
+CountingResource::~CountingResource() {
+    Registry &resources = registry();
+    lock_guard<mutex> guard(resources.lock);
+    resources.resources.erase(find(resources.resources.begin(), resources.resources.end(), this));
+}
+
+void CountingResource::recordAllocation(size_t bytes) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    addLive(bytes);
+}
+
+void CountingResource::recordDeallocation(size_t bytes) {
+    liveBytes.fetch_sub(bytes, memory_order_relaxed);
+    deallocations.fetch_add(1, memory_order_relaxed);
+}
+
+void CountingResource::moveTo(CountingResource &other, size_t bytes, size_t blocks) {
+    if (&other == this || blocks == 0) {
+        return;
+    }
+    liveBytes.fetch_sub(bytes, memory_order_relaxed);
+    movedBlocks.fetch_sub((int64_t) blocks, memory_order_relaxed);
+    other.movedBlocks.fetch_add((int64_t) blocks, memory_order_relaxed);
+    other.addLive(bytes);
+}
+
+void CountingResource::resetPeak() {
+    peakBytes.store(liveBytes.load(memory_order_relaxed), memory_order_relaxed);
+}
+
+CountingResource::Usage CountingResource::usage() const {
+    Usage usage;
+    usage.liveBytes = liveBytes.load(memory_order_relaxed);
+    usage.peakBytes = max(peakBytes.load(memory_order_relaxed), usage.liveBytes);
+    usage.allocations = allocations.load(memory_order_relaxed);
+    usage.liveBlocks = (size_t) ((int64_t) (usage.allocations - deallocations.load(memory_order_relaxed)) +
+                                 movedBlocks.load(memory_order_relaxed));
+    return usage;
+}
+
+vector<CountingResource *> CountingResource::all() {
+    Registry &resources = registry();
+    lock_guard<mutex> guard(resources.lock);
+    return resources.resources;
+}
+
+void CountingResource::printAll(ostream &out) {
+    char line[160];
+    snprintf(line, sizeof(line), "%-20s %12s %12s %12s %12s\n", "Structure", "Live", "Live blocks", "Peak",
+             "Allocations");
+    out << line;
+    vector<CountingResource *> resources = all();
+    sort(resources.begin(), resources.end(),
+         [](CountingResource *a, CountingResource *b) { return a->getName() < b->getName(); });
+    for (CountingResource *resource : resources) {
+        Usage usage = resource->usage();
+        if (usage.peakBytes == 0) {
+            continue;
+        }
+        // A stack that only took nodes over from queues shows no allocations of its own
+        snprintf(line, sizeof(line), "%-20s %12s %12zu %12s %12llu\n", resource->getName().c_str(),
+                 formatBytes(usage.liveBytes).c_str(), usage.liveBlocks, formatBytes(usage.peakBytes).c_str(),
+                 (unsigned long long) usage.allocations);
+        out << line;
+    }
+}
+
+void *CountingResource::do_allocate(size_t bytes, size_t alignment) {
+    void *block = upstream->allocate(bytes, alignment);
+    recordAllocation(bytes);
+    return block;
+}
+
+void CountingResource::do_deallocate(void *block, size_t bytes, size_t alignment) {
+    upstream->deallocate(block, bytes, alignment);
+    recordDeallocation(bytes);
+}
+
+bool CountingResource::do_is_equal(const pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+void CountingResource::addLive(size_t bytes) {
+    size_t live = liveBytes.fetch_add(bytes, memory_order_relaxed) + bytes;
+    size_t peak = peakBytes.load(memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed)) {
+    }
+}
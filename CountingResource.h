@@ -0,0 +1,133 @@
+#ifndef COUNTINGRESOURCE_H
+#define COUNTINGRESOURCE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  CountingResource                                                      *
+ *  Accounts for the memory of one kind of data structure: the bytes and *
+ *  blocks it holds now, the most bytes it ever held, and how many       *
+ *  allocations it made. As a pmr::memory_resource it counts what it     *
+ *  hands out from its upstream resource; memory that comes from         *
+ *  elsewhere, such as order nodes from a shift arena, is counted with   *
+ *  recordAllocation and recordDeallocation, and moved to another        *
+ *  structure's account with moveTo when a node changes containers.      *
+ *                                                                        *
+ *  Counters are shared by every thread and updated with relaxed atomic  *
+ *  operations. Resources are meant to be long-lived objects at          *
+ *  namespace scope, one per structure; every live resource is listed by *
+ *  all().                                                                *
+ *------------------------------------------------------------------------*/
+class CountingResource : public pmr::memory_resource {
+public:
+    // The counters at one point in time
+    struct Usage {
+        size_t liveBytes = 0;
+        size_t liveBlocks = 0;
+        size_t peakBytes = 0;
+        uint64_t allocations = 0;
+    };
+
+    /*------------------------------------------------------------------------*
+     *  CountingResource                                                      *
+     *  Parameterized constructor. Lists the resource under name; memory it  *
+     *  hands out comes from upstream.                                        *
+     *                                                                        *
+     *  Precondition:  upstream outlives the resource.                        *
+     *  Postcondition: all() includes the resource until it is destroyed.     *
+     *------------------------------------------------------------------------*/
+    explicit CountingResource(const string &name, pmr::memory_resource *upstream = pmr::new_delete_resource());
+
+    ~CountingResource() override;
+
+    CountingResource(const CountingResource &resource) = delete;
+
+    CountingResource &operator=(const CountingResource &resource) = delete;
+
+    // Counts memory the structure got, or gave back, other than through this resource
+    void recordAllocation(size_t bytes);
+
+    void recordDeallocation(size_t bytes);
+
+    /*------------------------------------------------------------------------*
+     *  moveTo                                                                *
+     *  Hands blocks live blocks of bytes in total over to other's account,   *
+     *  for memory that changes structures without being reallocated.        *
+     *                                                                        *
+     *  Precondition:  This resource holds at least that much.                *
+     *  Postcondition: The live counts moved; no allocation was counted.      *
+     *------------------------------------------------------------------------*/
+    void moveTo(CountingResource &other, size_t bytes, size_t blocks);
+
+    // Forgets the peak, so the next one is measured from the bytes live now
+    void resetPeak();
+
+    Usage usage() const;
+
+    const string &getName() const { return name; }
+
+    /*------------------------------------------------------------------------*
+     *  newArray / deleteArray                                                *
+     *  Allocate and default-construct, or destroy and free, an array of     *
+     *  count T, like new T[count] and delete[] but from this resource.     *
+     *  deleteArray takes the count the array was made with.                 *
+     *------------------------------------------------------------------------*/
+    template <typename T>
+    T *newArray(size_t count) {
+        T *items = static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+        try {
+            uninitialized_default_construct_n(items, count);
+        } catch (...) {
+            deallocate(items, count * sizeof(T), alignof(T));
+            throw;
+        }
+        return items;
+    }
+
+    template <typename T>
+    void deleteArray(T *items, size_t count) {
+        if (items != nullptr) {
+            destroy_n(items, count);
+            deallocate(items, count * sizeof(T), alignof(T));
+        }
+    }
+
+    // Every live resource
+    static vector<CountingResource *> all();
+
+    // Writes the usage of every resource that ever held memory, by name
+    static void printAll(ostream &out);
+
+protected:
+    // pmr::memory_resource
+    void *do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void *block, size_t bytes, size_t alignment) override;
+
+    bool do_is_equal(const pmr::memory_resource &other) const noexcept override;
+
+private:
+    string name;
+    pmr::memory_resource *upstream;
+
+    // As few counters as the hot path can afford: live blocks are derived from the others
+    atomic<size_t> liveBytes{0};
+    atomic<size_t> peakBytes{0};
+    atomic<uint64_t> allocations{0};
+    atomic<uint64_t> deallocations{0};
+    atomic<int64_t> movedBlocks{0}; // moved in minus moved out
+
+    // Adds bytes to the live count and raises the peak to match
+    void addLive(size_t bytes);
+};
+
+#endif //COUNTINGRESOURCE_H
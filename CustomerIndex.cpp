@@ -0,0 +1,18 @@
+#include "CustomerIndex.h"
+
+void CustomerIndex::add(uint32_t customer, int64_t orderId) {
+    if (customer >= orders.size()) {
+        orders.resize((size_t) customer + 1);
+    }
+    orders[customer].push_back(orderId);
+    orderCount++;
+}
+
+const vector<int64_t> &CustomerIndex::ordersOf(uint32_t customer) const {
+    static const vector<int64_t> none;
+    return customer < orders.size() ? orders[customer] : none;
+}
+
+size_t CustomerIndex::getOrderCount() const {
+    return orderCount;
+}
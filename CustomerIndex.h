@@ -0,0 +1,46 @@
+#ifndef CUSTOMERINDEX_H
+#define CUSTOMERINDEX_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  CustomerIndex                                                         *
+ *  Order history per customer. Customers are identified by the dense     *
+ *  handle a StringInterner gave their name, so the name hash is paid     *
+ *  once and a lookup is one hash probe followed by an array index into   *
+ *  the customer's list of order ids, oldest first.                       *
+ *------------------------------------------------------------------------*/
+class CustomerIndex {
+public:
+    /*------------------------------------------------------------------------*
+     *  add                                                                   *
+     *  Appends an order to a customer's history.                             *
+     *                                                                        *
+     *  Precondition:  customer is a handle of the interner that names the    *
+     *                 customers of this index.                               *
+     *  Postcondition: orderId is the last entry of ordersOf(customer).       *
+     *------------------------------------------------------------------------*/
+    void add(uint32_t customer, int64_t orderId);
+
+    /*------------------------------------------------------------------------*
+     *  ordersOf                                                              *
+     *  Returns the order ids of a customer, oldest first.                    *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: An empty list is returned for an unknown customer.     *
+     *------------------------------------------------------------------------*/
+    const vector<int64_t> &ordersOf(uint32_t customer) const;
+
+    // Total number of orders indexed
+    size_t getOrderCount() const;
+
+private:
+    vector<vector<int64_t>> orders; // orders[handle] is that customer's history
+
+    size_t orderCount = 0; // sum of the sizes of every history
+};
+
+#endif //CUSTOMERINDEX_H
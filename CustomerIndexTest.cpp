@@ -0,0 +1,58 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CustomerIndex.h"
+#include "Queue.h"
+#include "Stack.h"
+#include "StringInterner.h"
+#include "TestCheck.h"
+#include "TestOrders.h"
+
+using namespace std;
+
+namespace {
+    void testInterner() {
+        StringInterner names;
+        CHECK(names.intern("Ada") == 0 && names.intern("Grace") == 1 && names.intern("Ada") == 0);
+        CHECK(names.getSize() == 2 && names.lookup(1) == "Grace");
+
+        uint32_t handle = 99;
+        CHECK(names.find("Grace", handle) && handle == 1);
+        CHECK(!names.find("Linus", handle) && names.getSize() == 2); // find never interns
+    }
+
+    void testIndex() {
+        CustomerIndex index;
+        index.add(2, 10);
+        index.add(0, 11);
+        index.add(2, 12);
+        CHECK(index.ordersOf(2) == vector<int64_t>({10, 12}));
+        CHECK(index.ordersOf(0) == vector<int64_t>({11}));
+        CHECK(index.ordersOf(1).empty() && index.ordersOf(UINT32_MAX).empty());
+        CHECK(index.getOrderCount() == 3);
+    }
+
+    // The completed stack feeds the index on push, splice included
+    void testStackHistory() {
+        Stack stack;
+        stack.push(testOrder(1, "Ada"));
+        stack.push(testOrder(2, "Grace"));
+        Queue queue;
+        queue.enqueue(testOrder(3, "Ada"));
+        queue.enqueue(testOrder(4, "Ada"));
+        queue.drainAll(&stack);
+
+        CHECK(stack.findCustomerOrders("Ada") == vector<int64_t>({1, 3, 4}));
+        CHECK(stack.findCustomerOrders("Grace") == vector<int64_t>({2}));
+        CHECK(stack.findCustomerOrders("Linus").empty());
+        CHECK(stack.getCustomers().getSize() == 2);
+    }
+}
+
+int main() {
+    testInterner();
+    testIndex();
+    testStackHistory();
+    return testResult();
+}
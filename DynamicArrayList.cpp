@@ -1,9 +1,20 @@
 #include "DynamicArrayList.h"
 #include "MenuItem.h"
 #include "FileHandler.h"
+#include "CountingResource.h"
+#include "LatencyHistogram.h"
+#include "Logger.h"
+#include "Trace.h"
 
 using namespace std;
 
+namespace {
+    LatencyHistogram loadLatency("DynamicArrayList::loadMenu");
+    LatencyHistogram saveLatency("DynamicArrayList::saveMenu");
+
+    CountingResource itemMemory("DynamicArrayList"); // the MenuItem arrays of every list
+}
+
 /*------------------------------------------------------------------------*
  *  DynamicArrayList                                                      *
  *  Represents a dynamic array list for storing MenuItem objects.          *
@@ -17,7 +28,8 @@ DynamicArrayList::DynamicArrayList() {
      *  with a default capacity of 100.                                       *
      *------------------------------------------------------------------------*/
     capacity = 100;
-    menuItem = new MenuItem[capacity];
+    size = 0;
+    menuItem = itemMemory.newArray<MenuItem>(capacity);
 }
 
 DynamicArrayList::DynamicArrayList(int capacity) {
@@ -31,7 +43,64 @@ DynamicArrayList::DynamicArrayList(int capacity) {
      *                 created.                                                *
      *------------------------------------------------------------------------*/
     this->capacity = capacity;
-    menuItem = new MenuItem[capacity];
+    size = 0;
+    menuItem = itemMemory.newArray<MenuItem>(capacity);
+}
+
+DynamicArrayList::DynamicArrayList(const DynamicArrayList &list) {
+    /*------------------------------------------------------------------------*
+     *  DynamicArrayList                                                      *
+     *  Copy constructor. Allocates an array of the same capacity and copies  *
+     *  the MenuItems that are in use.                                        *
+     *------------------------------------------------------------------------*/
+    capacity = list.capacity;
+    size = list.size;
+    menuItem = itemMemory.newArray<MenuItem>(capacity);
+    for (int i = 0; i < size; i++)
+        menuItem[i] = list.menuItem[i];
+}
+
+DynamicArrayList::DynamicArrayList(DynamicArrayList &&list) noexcept {
+    /*------------------------------------------------------------------------*
+     *  DynamicArrayList                                                      *
+     *  Move constructor. Steals the array pointer of list.                   *
+     *------------------------------------------------------------------------*/
+    menuItem = list.menuItem;
+    size = list.size;
+    capacity = list.capacity;
+    list.menuItem = nullptr;
+    list.size = 0;
+    list.capacity = 0;
+}
+
+DynamicArrayList &DynamicArrayList::operator=(const DynamicArrayList &list) {
+    /*------------------------------------------------------------------------*
+     *  operator=                                                             *
+     *  Copy assignment. Builds the copy first so that this list is left     *
+     *  untouched if the allocation fails.                                    *
+     *------------------------------------------------------------------------*/
+    if (this != &list) {
+        DynamicArrayList copy(list);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+DynamicArrayList &DynamicArrayList::operator=(DynamicArrayList &&list) noexcept {
+    /*------------------------------------------------------------------------*
+     *  operator=                                                             *
+     *  Move assignment. Releases the current array and steals list's.        *
+     *------------------------------------------------------------------------*/
+    if (this != &list) {
+        itemMemory.deleteArray(menuItem, capacity);
+        menuItem = list.menuItem;
+        size = list.size;
+        capacity = list.capacity;
+        list.menuItem = nullptr;
+        list.size = 0;
+        list.capacity = 0;
+    }
+    return *this;
 }
 
 DynamicArrayList::~DynamicArrayList() {
@@ -39,7 +108,7 @@ DynamicArrayList::~DynamicArrayList() {
      *  ~DynamicArrayList                                                     *
      *  Destructor. Deallocates memory used by the menuItem array.            *
      *------------------------------------------------------------------------*/
-    delete[] menuItem;
+    itemMemory.deleteArray(menuItem, capacity);
 }
 
 void DynamicArrayList::add(const MenuItem &item) {
@@ -58,6 +127,17 @@ void DynamicArrayList::add(const MenuItem &item) {
     size++;
 }
 
+void DynamicArrayList::add(MenuItem &&item) {
+    /*------------------------------------------------------------------------*
+     *  add                                                                  *
+     *  Same as add(const MenuItem &), but moves the item into the list.      *
+     *------------------------------------------------------------------------*/
+    if (size >= capacity)
+        resize();
+    menuItem[size] = std::move(item);
+    size++;
+}
+
 void DynamicArrayList::remove(int pos) {
     /*------------------------------------------------------------------------*
      *  remove                                                               *
@@ -75,7 +155,7 @@ void DynamicArrayList::remove(int pos) {
         size--;
     } else {
         for (int i = pos; i < size - 1; i++)
-            menuItem[i] = menuItem[i + 1];
+            menuItem[i] = std::move(menuItem[i + 1]);
         size--;
     }
 }
@@ -91,6 +171,18 @@ MenuItem &DynamicArrayList::getMenuItem(int pos) const {
     return menuItem[pos];
 }
 
+int DynamicArrayList::findById(int id) const {
+    /*------------------------------------------------------------------------*
+     *  findById                                                             *
+     *  Linear search for the item with the given ID.                         *
+     *------------------------------------------------------------------------*/
+    for (int i = 0; i < size; i++) {
+        if (menuItem[i].getId() == id)
+            return i;
+    }
+    return -1;
+}
+
 int DynamicArrayList::getSize() const {
     /*------------------------------------------------------------------------*
      *  getSize                                                              *
@@ -110,15 +202,16 @@ void DynamicArrayList::resize() {
      *                                                                        *
      *  Precondition:  The list has reached its capacity.                     *
      *  Postcondition: The array is resized, and the existing items are       *
-     *                 copied into the new array.                             *
+     *                 moved into the new array.                              *
      *------------------------------------------------------------------------*/
-    MenuItem *newMenuItem = new MenuItem[capacity * 2];
+    int newCapacity = capacity > 0 ? capacity * 2 : 1; // a moved-from list has no capacity
+    MenuItem *newMenuItem = itemMemory.newArray<MenuItem>(newCapacity);
     for (int i = 0; i < size; i++)
-        newMenuItem[i] = menuItem[i];
+        newMenuItem[i] = std::move(menuItem[i]);
 
-    delete[] menuItem; // Deallocate old array
+    itemMemory.deleteArray(menuItem, capacity); // Deallocate old array
     menuItem = newMenuItem; // Assign new resized array
-    capacity *= 2;
+    capacity = newCapacity;
 }
 
 void DynamicArrayList::display() const {
@@ -142,14 +235,19 @@ void DynamicArrayList::loadMenu() {
     /*------------------------------------------------------------------------*
      *  loadMenu                                                             *
      *  Loads the menu items from a file using the provided FileHandler       *
-     *  object. The file must have valid data in the correct format.          *
+     *  object. The file must have valid data in the correct format:         *
+     *  id,name,description,price and optionally ,category. Without a         *
+     *  category column the name column is the category.                      *
      *                                                                        *
      *  Precondition:  fileHandler has a valid file with menu item data.      *
      *  Postcondition: The menu items are read from the file and added to the *
      *                 list.                                                  *
      *------------------------------------------------------------------------*/
+    LatencyHistogram::Timer timer(loadLatency);
+    TRACE_SPAN("DynamicArrayList::loadMenu");
     string fileName = "menu.txt";
     FileHandler fileHandler(fileName);
+    fileHandler.read();
 
     if (fileHandler.getLines() == nullptr || fileHandler.getSize() == 0) {
         cerr << "No data to load. Ensure the file has been read first.\n";
@@ -158,7 +256,7 @@ void DynamicArrayList::loadMenu() {
         for (int i = 0; i < fileHandler.getSize(); i++) {
             string line = fileHandler.getLines()[i];
             stringstream ss(line);
-            string id, name, description;
+            string id, name, description, category;
             double price;
 
             // Check if the line is empty
@@ -170,20 +268,32 @@ void DynamicArrayList::loadMenu() {
             getline(ss, name, ',');
             getline(ss, description, ',');
             ss >> price;
+            if (ss.good() && ss.peek() == ',') {
+                ss.get();
+                getline(ss, category);
+                if (!category.empty() && category.back() == '\r') {
+                    category.pop_back();
+                }
+            }
 
-            if (!ss.fail() || !id.empty() || !name.empty() || !description.empty() || price != 0.0000) {
+            if (ss.fail() || id.empty() || name.empty() || description.empty()) {
                 cerr << "Error parsing line: " << line << endl;
                 continue;
+            }
 
+            int itemId = atoi(id.c_str());
+            if (itemId <= 0) {
+                cerr << "Error parsing line: " << line << endl;
+                continue;
+            }
 
-                MenuItem menuItem = MenuItem(name, description, price);
+            // Keep the ID from the file, so saved orders still name the right items
+            MenuItem menuItem = MenuItem(itemId, name, description, price, category);
+            MenuItem::reserveIdsThrough(itemId);
 
-                cout << "\033[1;32m";
-                cout << "Created MenuItem: " << menuItem.getId() << " " << menuItem.getName() << " "
-                        << menuItem.getDescription() << " " << menuItem.getPrice() << endl;
-                cout << "\033[0m";
-                add(menuItem);
-            }
+            LOG_DEBUG("Created MenuItem: " << menuItem.getId() << " " << menuItem.getName() << " "
+                      << menuItem.getDescription() << " " << menuItem.getPrice());
+            add(std::move(menuItem));
         }
     }
 }
@@ -196,6 +306,8 @@ void DynamicArrayList::saveMenu() const {
      *  Precondition:  The menu has items, and fileName is a valid file path. *
      *  Postcondition: The menu items are written to the file in CSV format.  *
      *------------------------------------------------------------------------*/
+    LatencyHistogram::Timer timer(saveLatency);
+    TRACE_SPAN("DynamicArrayList::saveMenu");
     string fileName = "menu.txt";
 
     FileHandler fileHandler(fileName);
@@ -206,7 +318,11 @@ void DynamicArrayList::saveMenu() const {
         content << item.getId() << ","
                 << item.getName() << ","
                 << item.getDescription() << ","
-                << item.getPrice() << "\n";
+                << item.getPrice();
+        if (item.getCategory() != item.getName()) {
+            content << "," << item.getCategory();
+        }
+        content << "\n";
     }
 
     fileHandler.write(content.str());
@@ -238,7 +354,7 @@ void DynamicArrayList::displayMenu() {
     }
 }
 
-void DynamicArrayList::addMenuItem() {
+int DynamicArrayList::addMenuItem() {
     /*------------------------------------------------------------------------*
      *  addMenuItem                                                           *
      *  Adds a new menu item to the list after prompting the user for input.  *
@@ -259,14 +375,21 @@ void DynamicArrayList::addMenuItem() {
     cout << "Enter the price of the menu item: ";
     cin >> price;
 
-    MenuItem newItem = MenuItem(name, description, price);
-    add(newItem);
+    int id = addMenuItem(name, description, price);
 
     cout << "Menu item added successfully!" << endl;
     saveMenu();
+    return id;
 }
 
-void DynamicArrayList::deleteMenuItem() {
+int DynamicArrayList::addMenuItem(const string &name, const string &description, double price) {
+    string itemName = name;
+    string itemDescription = description;
+    add(MenuItem(itemName, itemDescription, price));
+    return menuItem[size - 1].getId();
+}
+
+int DynamicArrayList::deleteMenuItem() {
     /*------------------------------------------------------------------------*
      *  deleteMenuItem                                                        *
      *  Deletes a menu item from the list based on its ID.                    *
@@ -280,25 +403,27 @@ void DynamicArrayList::deleteMenuItem() {
     cout << "Enter the ID of the menu item to delete: ";
     cin >> idToDelete;
 
-    // Find the index of the item with the given ID
-    int indexToDelete = -1;
-    for (int i = 0; i < getSize(); i++) {
-        if (getMenuItem(i).getId() == idToDelete) {
-            indexToDelete = i;
-            break;
-        }
+    // If no item with the given ID was found
+    if (!deleteMenuItem(idToDelete)) {
+        cout << "Menu item with ID " << idToDelete << " not found." << endl;
+        return -1;
     }
 
-    // If no item with the given ID was found
+    cout << "Menu item with ID " << idToDelete << " has been deleted." << endl;
+    saveMenu();
+    return idToDelete;
+}
+
+bool DynamicArrayList::deleteMenuItem(int id) {
+    // Find the index of the item with the given ID
+    int indexToDelete = findById(id);
     if (indexToDelete == -1) {
-        cout << "Menu item with ID " << idToDelete << " not found." << endl;
-        return;
+        return false;
     }
 
     // Delete the item by calling the remove method from DynamicArrayList
     remove(indexToDelete);
-    cout << "Menu item with ID " << idToDelete << " has been deleted." << endl;
-    saveMenu();
+    return true;
 }
 
 
@@ -320,5 +445,5 @@ void DynamicArrayList::clear() {
         menuItem[i] = MenuItem(); // Reset each menu item to the default constructor
     }
 
-    cout << "Menu has been cleared!" << endl;
+    LOG_INFO("Menu has been cleared!");
 }
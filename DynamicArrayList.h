@@ -34,6 +34,37 @@ public:
      *------------------------------------------------------------------------*/
     DynamicArrayList(int capacity);
 
+    /*------------------------------------------------------------------------*
+     *  DynamicArrayList                                                       *
+     *  Copy constructor. Creates a deep copy of another list.                *
+     *                                                                        *
+     *  Precondition:  list is a valid DynamicArrayList object.               *
+     *  Postcondition: This list owns its own copy of list's MenuItems.       *
+     *------------------------------------------------------------------------*/
+    DynamicArrayList(const DynamicArrayList &list);
+
+    /*------------------------------------------------------------------------*
+     *  DynamicArrayList                                                       *
+     *  Move constructor. Takes over the array of another list without        *
+     *  copying any MenuItem.                                                 *
+     *                                                                        *
+     *  Precondition:  list is a valid DynamicArrayList object.               *
+     *  Postcondition: This list owns list's array; list is left empty.       *
+     *------------------------------------------------------------------------*/
+    DynamicArrayList(DynamicArrayList &&list) noexcept;
+
+    /*------------------------------------------------------------------------*
+     *  operator=                                                             *
+     *  Copy and move assignment, with the same semantics as the copy and     *
+     *  move constructors.                                                    *
+     *                                                                        *
+     *  Precondition:  list is a valid DynamicArrayList object.               *
+     *  Postcondition: This list holds the items of list.                     *
+     *------------------------------------------------------------------------*/
+    DynamicArrayList &operator=(const DynamicArrayList &list);
+
+    DynamicArrayList &operator=(DynamicArrayList &&list) noexcept;
+
     /*------------------------------------------------------------------------*
      *  ~DynamicArrayList                                                      *
      *  Destructor. Deallocates the memory used by the dynamic array of Menu  *
@@ -51,6 +82,8 @@ public:
      *------------------------------------------------------------------------*/
     void add(const MenuItem &item);
 
+    void add(MenuItem &&item);
+
     /*------------------------------------------------------------------------*
      *  remove                                                                *
      *  Removes the MenuItem at the specified position in the list.           *
@@ -70,6 +103,16 @@ public:
      *------------------------------------------------------------------------*/
     MenuItem &getMenuItem(int pos) const;
 
+    /*------------------------------------------------------------------------*
+     *  findById                                                              *
+     *  Returns the position of the MenuItem with the given ID.               *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: Returns the index of the item, or -1 if no item in     *
+     *                 the list has that ID.                                  *
+     *------------------------------------------------------------------------*/
+    int findById(int id) const;
+
     /*------------------------------------------------------------------------*
      *  getSize                                                               *
      *  Returns the current size (number of items) of the list.               *
@@ -85,7 +128,7 @@ public:
      *                                                                        *
      *  Precondition: The list is full (size == capacity).                    *
      *  Postcondition: The array capacity is doubled, and existing items are *
-     *                 copied to the new array.                               *
+     *                 moved to the new array.                                *
      *------------------------------------------------------------------------*/
     void resize();
 
@@ -133,18 +176,41 @@ public:
      *                                                                        *
      *  Precondition: User input is valid (non-empty name, description, and   *
      *                valid price).                                           *
-     *  Postcondition: A new MenuItem is added to the menu.                   *
+     *  Postcondition: A new MenuItem is added to the menu and its ID is      *
+     *                 returned.                                              *
      *------------------------------------------------------------------------*/
-    void addMenuItem();
+    int addMenuItem();
+
+    /*------------------------------------------------------------------------*
+     *  addMenuItem                                                           *
+     *  Adds a new MenuItem with the given details, without prompting or      *
+     *  saving the menu file.                                                 *
+     *                                                                        *
+     *  Precondition: name and description are not empty.                    *
+     *  Postcondition: A new MenuItem is added to the menu and its ID is      *
+     *                 returned.                                              *
+     *------------------------------------------------------------------------*/
+    int addMenuItem(const string &name, const string &description, double price);
 
     /*------------------------------------------------------------------------*
      *  deleteMenuItem                                                        *
      *  Deletes a MenuItem from the list based on the provided ID.            *
      *                                                                        *
      *  Precondition: The ID to delete exists in the list.                    *
-     *  Postcondition: The MenuItem is removed from the list.                 *
+     *  Postcondition: The MenuItem is removed from the list and its ID is    *
+     *                 returned, or -1 if no item had the entered ID.         *
+     *------------------------------------------------------------------------*/
+    int deleteMenuItem();
+
+    /*------------------------------------------------------------------------*
+     *  deleteMenuItem                                                        *
+     *  Deletes the MenuItem with the given ID, without prompting or saving   *
+     *  the menu file.                                                        *
+     *                                                                        *
+     *  Precondition: None.                                                   *
+     *  Postcondition: Returns true if an item was found and removed.         *
      *------------------------------------------------------------------------*/
-    void deleteMenuItem();
+    bool deleteMenuItem(int id);
 
     /*------------------------------------------------------------------------*
      *  resetMenu                                                             *
@@ -0,0 +1,71 @@
+#include "Executor.h"
+
+Executor::Executor(int threadCount) {
+    /*------------------------------------------------------------*
+     *  Executor                                                  *
+     *  Starts threadCount workers (at least one).                *
+     *------------------------------------------------------------*/
+    stopping = false;
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back(&Executor::workerLoop, this);
+    }
+}
+
+Executor::~Executor() {
+    /*------------------------------------------------------------*
+     *  ~Executor                                                 *
+     *  Lets the workers drain the ready queue, then joins them.  *
+     *------------------------------------------------------------*/
+    {
+        lock_guard<mutex> lock(readyMutex);
+        stopping = true;
+    }
+    readyCondition.notify_all();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+Executor::ScheduleAwaiter Executor::schedule() {
+    return ScheduleAwaiter{this};
+}
+
+void Executor::post(coroutine_handle<> handle) {
+    /*------------------------------------------------------------*
+     *  post                                                      *
+     *  Queues handle and wakes one worker.                       *
+     *------------------------------------------------------------*/
+    {
+        lock_guard<mutex> lock(readyMutex);
+        ready.push_back(handle);
+    }
+    readyCondition.notify_one();
+}
+
+int Executor::getThreadCount() const {
+    return (int) workers.size();
+}
+
+void Executor::workerLoop() {
+    /*------------------------------------------------------------*
+     *  workerLoop                                                *
+     *  Pops one coroutine at a time and resumes it outside the   *
+     *  lock, so a long stage never blocks the other workers.     *
+     *------------------------------------------------------------*/
+    while (true) {
+        coroutine_handle<> handle;
+        {
+            unique_lock<mutex> lock(readyMutex);
+            readyCondition.wait(lock, [this] { return stopping || !ready.empty(); });
+            if (ready.empty()) {
+                return; // stopping and nothing left to run
+            }
+            handle = ready.front();
+            ready.pop_front();
+        }
+        handle.resume();
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  Executor                                                              *
+ *  A small fixed pool of worker threads that resume suspended coroutines.*
+ *  A coroutine moves onto the pool with  co_await executor.schedule();   *
+ *  so any number of in-flight coroutines share the same few threads.     *
+ *------------------------------------------------------------------------*/
+class Executor {
+public:
+    /*------------------------------------------------------------------------*
+     *  ScheduleAwaiter                                                       *
+     *  Awaitable returned by schedule(). Suspends the awaiting coroutine and *
+     *  queues it to be resumed by one of the worker threads.                 *
+     *------------------------------------------------------------------------*/
+    struct ScheduleAwaiter {
+        Executor *executor;
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(coroutine_handle<> handle) { executor->post(handle); }
+
+        void await_resume() const noexcept {}
+    };
+
+    /*------------------------------------------------------------------------*
+     *  Executor                                                              *
+     *  Parameterized constructor. Starts the worker threads.                 *
+     *                                                                        *
+     *  Precondition:  threadCount is a positive integer.                     *
+     *  Postcondition: threadCount workers are waiting for coroutines.        *
+     *------------------------------------------------------------------------*/
+    explicit Executor(int threadCount);
+
+    /*------------------------------------------------------------------------*
+     *  ~Executor                                                             *
+     *  Destructor. Runs the coroutines that are still queued, then stops     *
+     *  and joins the workers.                                                *
+     *------------------------------------------------------------------------*/
+    ~Executor();
+
+    Executor(const Executor &executor) = delete;
+
+    Executor &operator=(const Executor &executor) = delete;
+
+    /*------------------------------------------------------------------------*
+     *  schedule                                                              *
+     *  Returns an awaitable that continues the awaiting coroutine on a       *
+     *  worker thread.                                                        *
+     *                                                                        *
+     *  Precondition:  Called from inside a coroutine with co_await.          *
+     *  Postcondition: The coroutine resumes on one of the workers.           *
+     *------------------------------------------------------------------------*/
+    ScheduleAwaiter schedule();
+
+    /*------------------------------------------------------------------------*
+     *  post                                                                  *
+     *  Queues a suspended coroutine to be resumed by a worker.               *
+     *                                                                        *
+     *  Precondition:  handle refers to a suspended coroutine.                *
+     *  Postcondition: handle will be resumed exactly once.                   *
+     *------------------------------------------------------------------------*/
+    void post(coroutine_handle<> handle);
+
+    /*------------------------------------------------------------------------*
+     *  getThreadCount                                                        *
+     *  Returns the number of worker threads.                                 *
+     *------------------------------------------------------------------------*/
+    int getThreadCount() const;
+
+private:
+    vector<thread> workers; // Worker threads resuming coroutines
+    deque<coroutine_handle<>> ready; // Coroutines waiting for a worker
+    mutex readyMutex; // Guards ready and stopping
+    condition_variable readyCondition; // Signalled when ready gains work
+    bool stopping; // Set by the destructor to stop the workers
+
+    /*------------------------------------------------------------------------*
+     *  workerLoop                                                            *
+     *  Body of each worker thread: resumes queued coroutines until the       *
+     *  executor stops and the ready queue is empty.                          *
+     *------------------------------------------------------------------------*/
+    void workerLoop();
+};
+
+#endif //EXECUTOR_H
@@ -1,9 +1,15 @@
 #include "FileHandler.h"
+#include "CountingResource.h"
+#include "Trace.h"
 #include <fstream>
 #include <iostream>
 #include <string>
 using namespace std;
 
+namespace {
+    CountingResource lineMemory("FileHandler"); // the lines arrays of every handler
+}
+
 /*------------------------------------------------------------------------*
  *  FileHandler                                                           *
  *  A class that handles reading, writing, appending, and clearing content *
@@ -18,12 +24,20 @@ FileHandler::FileHandler(const string& fileName) {
     this->fileName = fileName;  // Set the file name to the provided argument
     lines = nullptr;            // Initialize lines to nullptr
     size = 0;                   // Initialize size to 0
+    capacity = 0;
+}
+
+// Destructor
+// Releases the lines array allocated by read().
+FileHandler::~FileHandler() {
+    lineMemory.deleteArray(lines, capacity);
 }
 
 // write
 // This method overwrites the content of the file with the provided string.
 // It opens the file in truncate mode and writes the content.
 void FileHandler::write(const string& content) {
+    TRACE_SPAN("FileHandler::write");
     ofstream outFile(fileName, ios::trunc);  // Open file in truncate mode to overwrite
     if (outFile.is_open()) {                 // Check if the file was successfully opened
         outFile << content << "\n";          // Write the content to the file
@@ -38,6 +52,7 @@ void FileHandler::write(const string& content) {
 // Appends the given content to the end of the file.
 // It opens the file in append mode and writes the content.
 void FileHandler::append(const string& content) {
+    TRACE_SPAN("FileHandler::append");
     ofstream outFile(fileName, ios::app);  // Open file in append mode
     if (outFile.is_open()) {               // Check if the file was successfully opened
         outFile << content << "\n";        // Append the content to the file
@@ -52,6 +67,7 @@ void FileHandler::append(const string& content) {
 // Reads the content of the file and stores each line in a dynamic array.
 // If the file is empty, it prints an error message.
 void FileHandler::read() {
+    TRACE_SPAN("FileHandler::read");
     ifstream inFile(fileName);  // Open file for reading
     if (!inFile.is_open()) {    // Check if the file was successfully opened
         cerr << "Unable to open file for reading.\n";  // Error message if the file can't be opened
@@ -70,8 +86,10 @@ void FileHandler::read() {
         return;
     }
 
-    // Allocate memory for storing lines
-    lines = new string[size];
+    // Allocate memory for storing lines, dropping any previous read
+    lineMemory.deleteArray(lines, capacity);
+    lines = lineMemory.newArray<string>(size);
+    capacity = size;
 
     // Reset file pointer to the beginning
     inFile.clear();
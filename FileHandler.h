@@ -14,6 +14,7 @@ private:
     string fileName;    // Name of the file to operate on
     string* lines;      // Pointer to a dynamic array that stores file content
     int size;           // The number of lines in the file
+    int capacity;       // Length of the lines array, which outlives an empty read
 
 public:
     /*------------------------------------------------------------------------*
@@ -27,6 +28,16 @@ public:
      *------------------------------------------------------------------------*/
     FileHandler(const string& fileName);
 
+    /*------------------------------------------------------------------------*
+     *  ~FileHandler                                                          *
+     *  Destructor. Deallocates the array of lines read from the file.        *
+     *------------------------------------------------------------------------*/
+    ~FileHandler();
+
+    // The lines array is owned by a single handler
+    FileHandler(const FileHandler&) = delete;
+    FileHandler& operator=(const FileHandler&) = delete;
+
     /*------------------------------------------------------------------------*
      *  write                                                                 *
      *  Overwrites the content of the file with the given string.             *
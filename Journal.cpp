@@ -0,0 +1,388 @@
+#include "Journal.h"
+
+#include "BinaryRecord.h"
+#include "OrderCodec.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace {
+    const uint32_t checkpointMagic = 0x354B434F; // "OCK5": completed orders in a file of their own
+
+    // Reads a whole file; returns false if it does not exist
+    bool readFile(const string &path, string &content) {
+        ifstream file(path, ios::binary);
+        if (!file) {
+            return false;
+        }
+        content.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        return true;
+    }
+
+    // The order of a batch holding a single order
+    Order firstOrder(string_view bytes) {
+        OrderBatchView batch(bytes);
+        if (batch.size() != 1) {
+            throw runtime_error("Expected a single order");
+        }
+        return (*batch.begin()).toOrder();
+    }
+
+    // Writes all of data to fd, retrying short writes
+    bool writeAll(int fd, const char *data, size_t size) {
+        while (size > 0) {
+            ssize_t written = write(fd, data, size);
+            if (written < 0) {
+                return false;
+            }
+            data += written;
+            size -= (size_t) written;
+        }
+        return true;
+    }
+
+    // Cuts path to length, then appends data and syncs it
+    bool appendAt(const string &path, uint64_t length, const string &data) {
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        bool written = ftruncate(fd, (off_t) length) == 0 && lseek(fd, (off_t) length, SEEK_SET) >= 0
+                       && writeAll(fd, data.data(), data.size()) && fsync(fd) == 0;
+        close(fd);
+        return written;
+    }
+}
+
+Journal::Journal(const string &checkpointPath, const string &logPath, int checkpointInterval, bool syncEachRecord) {
+    this->checkpointPath = checkpointPath;
+    this->logPath = logPath;
+    this->checkpointInterval = checkpointInterval;
+    this->syncEachRecord = syncEachRecord;
+    nextLsn = 1;
+    recordsSinceCheckpoint = 0;
+    completedGeneration = 0;
+    completedLength = 0;
+    completedReset = false;
+    logFd = open(logPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (logFd < 0) {
+        throw runtime_error("Cannot open the order journal " + logPath);
+    }
+}
+
+Journal::~Journal() {
+    close(logFd);
+}
+
+bool Journal::recover(DynamicArrayList &menu, Queue &active, Stack &completed) {
+    /*------------------------------------------------------------*
+     *  recover                                                   *
+     *  Completed orders are collected first and pushed at the    *
+     *  end, so a CompletedSaved record can drop the ones that    *
+     *  already reached completed_orders.txt without touching the *
+     *  revenue loaded from it. Those replayed from the log are   *
+     *  also kept for the next checkpoint, which truncates it.    *
+     *------------------------------------------------------------*/
+    TRACE_SPAN("Journal::recover");
+    string content;
+    if (!readFile(checkpointPath, content)) {
+        return false;
+    }
+
+    RecordReader frame(content.data(), content.size());
+    uint32_t length = frame.get<uint32_t>();
+    uint32_t expected = frame.get<uint32_t>();
+    if (length != content.size() - frame.getPosition()
+        || checksum(content.data() + frame.getPosition(), length) != expected) {
+        throw runtime_error("Corrupt checkpoint " + checkpointPath);
+    }
+
+    RecordReader checkpoint(content.data() + frame.getPosition(), length);
+    if (checkpoint.get<uint32_t>() != checkpointMagic) {
+        throw runtime_error("Not a checkpoint: " + checkpointPath);
+    }
+    uint64_t checkpointLsn = checkpoint.get<uint64_t>();
+    int largestId = 0;
+    for (uint32_t count = checkpoint.get<uint32_t>(); count > 0; count--) {
+        MenuItem item = checkpoint.getMenuItem();
+        largestId = max(largestId, item.getId());
+        menu.add(std::move(item));
+    }
+    for (OrderView order : OrderBatchView(checkpoint.getBytes())) {
+        active.enqueue(order.toOrder());
+    }
+    uint64_t generation = checkpoint.get<uint64_t>();
+    uint64_t completedBytes = checkpoint.get<uint64_t>();
+    vector<Order> completedTail;
+    readCompleted(generation, completedBytes, completedTail);
+
+    // Replay the log records written after the checkpoint
+    uint64_t lastLsn = checkpointLsn;
+    int replayed = 0;
+    string log;
+    readFile(logPath, log);
+    size_t good = 0;
+    while (good < log.size()) {
+        try {
+            RecordReader header(log.data() + good, log.size() - good);
+            uint32_t size = header.get<uint32_t>();
+            uint32_t sum = header.get<uint32_t>();
+            if (size > log.size() - good - header.getPosition()
+                || checksum(log.data() + good + header.getPosition(), size) != sum) {
+                break;
+            }
+            RecordReader record(log.data() + good + header.getPosition(), size);
+            uint64_t lsn = record.get<uint64_t>();
+            RecordType type = (RecordType) record.get<uint8_t>();
+            if (lsn > checkpointLsn) {
+                switch (type) {
+                    case MenuItemAdded: {
+                        MenuItem item = record.getMenuItem();
+                        largestId = max(largestId, item.getId());
+                        menu.add(std::move(item));
+                        break;
+                    }
+                    case MenuItemDeleted:
+                        menu.deleteMenuItem(record.get<int32_t>());
+                        break;
+                    case MenuReset:
+                        menu.clear();
+                        break;
+                    case OrderEnqueued:
+                        active.enqueue(firstOrder(record.getBytes()));
+                        break;
+                    case OrderCompleted: {
+                        Order order = firstOrder(record.getBytes());
+                        active.removeOrder(order.getOrderId());
+                        newCompleted.add(order);
+                        completedTail.push_back(std::move(order));
+                        break;
+                    }
+                    case CompletedSaved:
+                        completedTail.clear();
+                        newCompleted.finish();
+                        completedReset = true;
+                        break;
+                }
+                lastLsn = lsn;
+                replayed++;
+            }
+            good += header.getPosition() + size;
+        } catch (const runtime_error &) {
+            break; // torn or unreadable record
+        }
+    }
+    if (good < log.size()) {
+        cerr << "Discarding " << log.size() - good << " bytes of incomplete journal records.\n";
+        if (ftruncate(logFd, (off_t) good) != 0) {
+            cerr << "Could not truncate the order journal " << logPath << ".\n";
+        }
+    }
+
+    MenuItem::reserveIdsThrough(largestId); // new items must not reuse restored IDs
+    for (Order &order : completedTail) {
+        completed.push(std::move(order));
+    }
+
+    if (generation > 0) {
+        remove(completedPath(generation - 1).c_str()); // left behind by a crash right after a checkpoint
+    }
+
+    lock_guard<mutex> guard(lock);
+    nextLsn = lastLsn + 1;
+    recordsSinceCheckpoint = replayed;
+    completedGeneration = generation;
+    completedLength = completedBytes;
+    return true;
+}
+
+void Journal::readCompleted(uint64_t generation, uint64_t length, vector<Order> &orders) const {
+    if (length == 0) {
+        return;
+    }
+    string path = completedPath(generation);
+    string content;
+    if (!readFile(path, content) || content.size() < length) {
+        throw runtime_error("Missing completed orders " + path);
+    }
+    // The checkpoint was only written after these bytes were synced, so any damage is corruption
+    size_t position = 0;
+    while (position < length) {
+        RecordReader frame(content.data() + position, length - position);
+        uint32_t size = frame.get<uint32_t>();
+        uint32_t expected = frame.get<uint32_t>();
+        position += frame.getPosition();
+        if (size > length - position || checksum(content.data() + position, size) != expected) {
+            throw runtime_error("Corrupt completed orders " + path);
+        }
+        for (OrderView order : OrderBatchView(content.data() + position, size)) {
+            orders.push_back(order.toOrder());
+        }
+        position += size;
+    }
+}
+
+string Journal::completedPath(uint64_t generation) const {
+    return checkpointPath + "." + to_string(generation) + ".completed";
+}
+
+void Journal::checkpoint(const DynamicArrayList &menu, const vector<const Order *> &active) {
+    TRACE_SPAN("Journal::checkpoint");
+    lock_guard<mutex> guard(lock);
+
+    // Only the orders completed since the last checkpoint are written; the file already holds the rest
+    if (newCompleted.getCount() > 0) {
+        string batch = newCompleted.finish();
+        RecordWriter frame;
+        frame.put<uint32_t>((uint32_t) batch.size());
+        frame.put<uint32_t>(checksum(batch.data(), batch.size()));
+        unwrittenFrames += frame.data() + batch;
+    }
+    uint64_t generation = completedReset ? completedGeneration + 1 : completedGeneration;
+    uint64_t length = completedReset ? 0 : completedLength;
+    if (!unwrittenFrames.empty() && !appendAt(completedPath(generation), length, unwrittenFrames)) {
+        cerr << "Could not write the completed orders " << completedPath(generation) << "; the journal is kept.\n";
+        return;
+    }
+    length += unwrittenFrames.size();
+
+    RecordWriter body;
+    body.put<uint32_t>(checkpointMagic);
+    body.put<uint64_t>(nextLsn - 1);
+    body.put<uint32_t>((uint32_t) menu.getSize());
+    for (int i = 0; i < menu.getSize(); i++) {
+        body.putMenuItem(menu.getMenuItem(i));
+    }
+    OrderBatchWriter orders;
+    for (const Order *order : active) {
+        orders.add(*order);
+    }
+    body.putString(orders.finish());
+    body.put<uint64_t>(generation);
+    body.put<uint64_t>(length);
+
+    RecordWriter file;
+    file.put<uint32_t>((uint32_t) body.data().size());
+    file.put<uint32_t>(checksum(body.data().data(), body.data().size()));
+
+    // Write a new file and rename it over the old one, so a crash leaves one whole checkpoint
+    string temporary = checkpointPath + ".tmp";
+    int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || !writeAll(fd, file.data().data(), file.data().size())
+        || !writeAll(fd, body.data().data(), body.data().size()) || fsync(fd) != 0) {
+        cerr << "Could not write checkpoint " << temporary << "; the journal is kept.\n";
+        if (fd >= 0) {
+            close(fd);
+        }
+        return;
+    }
+    close(fd);
+    if (rename(temporary.c_str(), checkpointPath.c_str()) != 0) {
+        cerr << "Could not replace checkpoint " << checkpointPath << "; the journal is kept.\n";
+        return;
+    }
+
+    if (generation != completedGeneration) {
+        remove(completedPath(completedGeneration).c_str()); // its orders were saved
+    }
+    completedGeneration = generation;
+    completedLength = length;
+    completedReset = false;
+    unwrittenFrames.clear();
+
+    // Records up to the checkpoint's lsn are now redundant; replay skips them even if this fails
+    if (ftruncate(logFd, 0) != 0) {
+        cerr << "Could not truncate the order journal " << logPath << ".\n";
+    }
+    recordsSinceCheckpoint = 0;
+}
+
+bool Journal::checkpointDue() const {
+    lock_guard<mutex> guard(lock);
+    return recordsSinceCheckpoint >= checkpointInterval;
+}
+
+void Journal::menuItemAdded(const MenuItem &item) {
+    RecordWriter payload;
+    payload.putMenuItem(item);
+    append(MenuItemAdded, payload.data());
+}
+
+void Journal::menuItemDeleted(int id) {
+    RecordWriter payload;
+    payload.put<int32_t>(id);
+    append(MenuItemDeleted, payload.data());
+}
+
+void Journal::menuReset() {
+    append(MenuReset, "");
+}
+
+void Journal::completedSaved() {
+    append(CompletedSaved, "");
+    lock_guard<mutex> guard(lock);
+    newCompleted.finish(); // those orders are in completed_orders.txt now
+    unwrittenFrames.clear();
+    completedReset = true;
+}
+
+void Journal::onEnqueued(const Order &order) {
+    RecordWriter payload;
+    payload.putString(OrderBatchWriter::encode(order));
+    append(OrderEnqueued, payload.data());
+}
+
+void Journal::onCompleted(const Order &order) {
+    RecordWriter payload;
+    payload.putString(OrderBatchWriter::encode(order));
+    append(OrderCompleted, payload.data());
+    lock_guard<mutex> guard(lock);
+    newCompleted.add(order);
+}
+
+bool Journal::sync() {
+    TRACE_SPAN("Journal::sync");
+    lock_guard<mutex> guard(lock);
+    if (fdatasync(logFd) != 0) {
+        cerr << "Could not sync the order journal " << logPath << ".\n";
+        return false;
+    }
+    return true;
+}
+
+void Journal::append(RecordType type, const string &payload) {
+    TRACE_SPAN("Journal::append");
+    lock_guard<mutex> guard(lock);
+    RecordWriter body;
+    body.put<uint64_t>(nextLsn);
+    body.put<uint8_t>(type);
+    string record = body.data() + payload;
+
+    RecordWriter frame;
+    frame.put<uint32_t>((uint32_t) record.size());
+    frame.put<uint32_t>(checksum(record.data(), record.size()));
+    string bytes = frame.data() + record;
+
+    // One write per record keeps a record contiguous in the log
+    if (!writeAll(logFd, bytes.data(), bytes.size()) || (syncEachRecord && fdatasync(logFd) != 0)) {
+        cerr << "Could not append to the order journal " << logPath << ".\n";
+        return;
+    }
+    nextLsn++;
+    recordsSinceCheckpoint++;
+}
+
+uint32_t Journal::checksum(const char *data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= (uint8_t) data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,149 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "DynamicArrayList.h"
+#include "OrderCodec.h"
+#include "OrderListener.h"
+#include "Queue.h"
+#include "Stack.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  Journal                                                               *
+ *  Write-ahead log plus checkpoints of the menu, the active orders and   *
+ *  the unsaved completed orders. Every change is appended to the log     *
+ *  (and synced) before the program moves on; a checkpoint writes the     *
+ *  menu and the active orders to a new file and empties the log.         *
+ *  Completed orders only grow until they are saved, so a checkpoint      *
+ *  appends just the ones completed since the previous checkpoint to a    *
+ *  completed-orders file and records its length; saving starts a new    *
+ *  file. Recovery loads the latest checkpoint and that file and replays  *
+ *  only the records logged after it, so neither a checkpoint nor a      *
+ *  restart rewrites or replays what earlier checkpoints covered.         *
+ *                                                                        *
+ *  Attach the journal to the active Queue and the completed Stack with   *
+ *  setListener; menu edits and saves are reported by the caller.         *
+ *------------------------------------------------------------------------*/
+class Journal : public OrderListener {
+public:
+    /*------------------------------------------------------------------------*
+     *  Journal                                                               *
+     *  Parameterized constructor. Opens (or creates) the log.                *
+     *                                                                        *
+     *  Precondition:  The paths are writable.                                *
+     *  Postcondition: checkpointDue() turns true every checkpointInterval    *
+     *                 records. With syncEachRecord false, records reach the  *
+     *                 disk when the OS flushes them.                         *
+     *------------------------------------------------------------------------*/
+    Journal(const string &checkpointPath = "orders.ckpt", const string &logPath = "orders.wal",
+            int checkpointInterval = 1000, bool syncEachRecord = true);
+
+    ~Journal();
+
+    Journal(const Journal &journal) = delete;
+
+    Journal &operator=(const Journal &journal) = delete;
+
+    /*------------------------------------------------------------------------*
+     *  recover                                                               *
+     *  Rebuilds the state from the latest checkpoint and the log records     *
+     *  after it. A torn record at the end of the log (a crash mid-write) is  *
+     *  cut off.                                                              *
+     *                                                                        *
+     *  Precondition:  menu and active are empty; completed holds only what  *
+     *                 was loaded from completed_orders.txt; no listener is   *
+     *                 attached yet.                                          *
+     *  Postcondition: Returns false, changing nothing, if there is no        *
+     *                 checkpoint. Otherwise the menu, the active orders and  *
+     *                 the unsaved completed orders are restored.             *
+     *------------------------------------------------------------------------*/
+    bool recover(DynamicArrayList &menu, Queue &active, Stack &completed);
+
+    /*------------------------------------------------------------------------*
+     *  checkpoint                                                            *
+     *  Writes the menu and the active orders to a new checkpoint, appends   *
+     *  the orders completed since the last one to the completed-orders      *
+     *  file, then empties the log. The completed orders come from the       *
+     *  records this journal logged, so the Stack is not read.               *
+     *                                                                        *
+     *  Precondition:  No other thread is changing the state.                 *
+     *  Postcondition: Recovery starts from this state.                       *
+     *------------------------------------------------------------------------*/
+    void checkpoint(const DynamicArrayList &menu, const vector<const Order *> &active);
+
+    // True once checkpointInterval records were logged since the last checkpoint
+    bool checkpointDue() const;
+
+    /*------------------------------------------------------------------------*
+     *  sync                                                                  *
+     *  Forces every record logged so far to the disk. Lets a journal        *
+     *  opened without syncEachRecord make a group of records durable with   *
+     *  one fdatasync.                                                        *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: Returns false if the log could not be synced.          *
+     *------------------------------------------------------------------------*/
+    bool sync();
+
+    // Menu edits, reported after they were applied
+    void menuItemAdded(const MenuItem &item);
+
+    void menuItemDeleted(int id);
+
+    void menuReset();
+
+    // The completed orders were written to completed_orders.txt
+    void completedSaved();
+
+    // OrderListener
+    void onEnqueued(const Order &order) override;
+
+    void onCompleted(const Order &order) override;
+
+private:
+    // Kinds of log record
+    enum RecordType : uint8_t {
+        MenuItemAdded = 1,
+        MenuItemDeleted = 2,
+        MenuReset = 3,
+        OrderEnqueued = 4,
+        OrderCompleted = 5,
+        CompletedSaved = 6
+    };
+
+    string checkpointPath; // latest checkpoint
+    string logPath; // records since that checkpoint
+
+    int checkpointInterval; // records between checkpoints
+    bool syncEachRecord; // fdatasync after every record
+
+    mutable mutex lock; // guards the members below
+    int logFd; // log file, opened for appending
+    uint64_t nextLsn; // sequence number of the next record
+    int recordsSinceCheckpoint; // records logged since the last checkpoint
+    uint64_t completedGeneration; // numbers the completed-orders file of the latest checkpoint
+    uint64_t completedLength; // bytes of that file the latest checkpoint covers
+    bool completedReset; // the orders were saved since then: the next checkpoint starts a new file
+    OrderBatchWriter newCompleted; // orders completed since the last checkpoint
+    string unwrittenFrames; // framed batches of completed orders no checkpoint covers yet
+
+    // Frames and appends one record: length, checksum, lsn, type, payload
+    void append(RecordType type, const string &payload);
+
+    // Completed-orders file of one generation
+    string completedPath(uint64_t generation) const;
+
+    // Reads the first length bytes of a completed-orders file: framed OrderCodec batches
+    void readCompleted(uint64_t generation, uint64_t length, vector<Order> &orders) const;
+
+    // FNV-1a hash used to detect torn or corrupt records
+    static uint32_t checksum(const char *data, size_t size);
+};
+
+#endif //JOURNAL_H
@@ -0,0 +1,161 @@
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "Journal.h"
+#include "TestCheck.h"
+#include "TestOrders.h"
+
+using namespace std;
+
+namespace {
+    // Logs a checkpoint and a few records after it, then tears the last record as a crash mid-write would
+    void testTornLastRecord(const string &checkpointPath, const string &logPath) {
+        remove(checkpointPath.c_str());
+        remove(logPath.c_str());
+        uintmax_t intact;
+        {
+            Journal journal(checkpointPath, logPath, 1000, false);
+            DynamicArrayList menu;
+            menu.add(MenuItem(1, "Pizza", "Cheese", 8.99));
+            menu.add(MenuItem(2, "Burger", "Beef", 5.49));
+            Stack completed;
+            journal.checkpoint(menu, {});
+
+            journal.menuItemAdded(MenuItem(3, "Soup", "Tomato", 3.25));
+            journal.onEnqueued(testOrder(101, "Ada"));
+            journal.onEnqueued(testOrder(102, "Grace"));
+            journal.onCompleted(testOrder(101, "Ada"));
+            intact = filesystem::file_size(logPath);
+            journal.onEnqueued(testOrder(103, "Edsger"));
+        }
+        filesystem::resize_file(logPath, filesystem::file_size(logPath) - 3);
+
+        Journal journal(checkpointPath, logPath, 1000, false);
+        DynamicArrayList menu;
+        Queue active;
+        Stack completed;
+        CHECK(journal.recover(menu, active, completed));
+        CHECK(menu.getSize() == 3 && menu.findById(3) != -1);
+        CHECK(orderIds(active) == vector<int64_t>{102});
+        CHECK(orderIds(completed) == vector<int64_t>{101});
+        CHECK(filesystem::file_size(logPath) == intact); // the torn record was cut off
+
+        // Records logged after recovery follow the intact ones
+        journal.onEnqueued(testOrder(104, "Barbara"));
+        DynamicArrayList menuAgain;
+        Queue activeAgain;
+        Stack completedAgain;
+        CHECK(Journal(checkpointPath, logPath).recover(menuAgain, activeAgain, completedAgain));
+        CHECK(orderIds(activeAgain) == (vector<int64_t>{102, 104}));
+    }
+
+    void testCorruptRecord(const string &checkpointPath, const string &logPath) {
+        remove(checkpointPath.c_str());
+        remove(logPath.c_str());
+        uintmax_t intact;
+        {
+            Journal journal(checkpointPath, logPath, 1000, false);
+            DynamicArrayList menu;
+            Stack completed;
+            journal.checkpoint(menu, {});
+            journal.onEnqueued(testOrder(201, "Ada"));
+            intact = filesystem::file_size(logPath);
+            journal.onEnqueued(testOrder(202, "Grace"));
+        }
+        // A record of the right length whose bytes were damaged fails its checksum
+        FILE *log = fopen(logPath.c_str(), "r+b");
+        fseek(log, -2, SEEK_END);
+        fputc('X', log);
+        fclose(log);
+
+        Journal journal(checkpointPath, logPath, 1000, false);
+        DynamicArrayList menu;
+        Queue active;
+        Stack completed;
+        CHECK(journal.recover(menu, active, completed));
+        CHECK(orderIds(active) == vector<int64_t>{201});
+        CHECK(filesystem::file_size(logPath) == intact);
+    }
+
+    // Completed orders reach the completed-orders file a checkpoint's worth at a time
+    void testCompletedAcrossCheckpoints(const string &checkpointPath, const string &logPath) {
+        remove(checkpointPath.c_str());
+        remove(logPath.c_str());
+        uintmax_t firstSize;
+        {
+            Journal journal(checkpointPath, logPath, 1000, false);
+            DynamicArrayList menu;
+            journal.checkpoint(menu, {});
+            for (int i = 0; i < 50; i++) {
+                journal.onCompleted(testOrder(300 + i, "Ada"));
+            }
+            journal.checkpoint(menu, {});
+            firstSize = filesystem::file_size(checkpointPath);
+            for (int i = 50; i < 500; i++) {
+                journal.onCompleted(testOrder(300 + i, "Ada"));
+            }
+            journal.checkpoint(menu, {});
+            CHECK(filesystem::file_size(checkpointPath) == firstSize); // the history is not in the checkpoint
+            journal.onCompleted(testOrder(800, "Grace")); // only in the log
+        }
+
+        {
+            Journal journal(checkpointPath, logPath, 1000, false);
+            DynamicArrayList menu;
+            Queue active;
+            Stack completed;
+            CHECK(journal.recover(menu, active, completed));
+            vector<int64_t> ids = orderIds(completed);
+            CHECK(ids.size() == 501 && ids.front() == 300 && ids[499] == 799 && ids.back() == 800);
+
+            // The order replayed from the log survives the checkpoint that empties the log
+            journal.checkpoint(menu, {});
+            Stack again;
+            Queue activeAgain;
+            DynamicArrayList menuAgain;
+            CHECK(Journal(checkpointPath, logPath).recover(menuAgain, activeAgain, again));
+            CHECK(orderIds(again) == ids);
+
+            // Saving starts a new, empty file and the old one goes
+            journal.completedSaved();
+            journal.onCompleted(testOrder(900, "Edsger"));
+            journal.checkpoint(menu, {});
+            CHECK(!filesystem::exists(checkpointPath + ".0.completed"));
+        }
+
+        Journal journal(checkpointPath, logPath, 1000, false);
+        DynamicArrayList menu;
+        Queue active;
+        Stack completed;
+        CHECK(journal.recover(menu, active, completed));
+        CHECK(orderIds(completed) == vector<int64_t>{900});
+        remove((checkpointPath + ".1.completed").c_str());
+    }
+
+    void testNoCheckpoint(const string &checkpointPath, const string &logPath) {
+        remove(checkpointPath.c_str());
+        remove(logPath.c_str());
+        Journal journal(checkpointPath, logPath);
+        DynamicArrayList menu;
+        Queue active;
+        Stack completed;
+        CHECK(!journal.recover(menu, active, completed));
+        CHECK(menu.getSize() == 0 && active.isEmpty() && completed.isEmpty());
+    }
+}
+
+int main() {
+    string prefix = (filesystem::temp_directory_path() / ("journal-test-" + to_string(getpid()))).string();
+    string checkpointPath = prefix + ".ckpt";
+    string logPath = prefix + ".wal";
+    testTornLastRecord(checkpointPath, logPath);
+    testCorruptRecord(checkpointPath, logPath);
+    testCompletedAcrossCheckpoints(checkpointPath, logPath);
+    testNoCheckpoint(checkpointPath, logPath);
+    remove(checkpointPath.c_str());
+    remove(logPath.c_str());
+    return testResult();
+}
@@ -0,0 +1,192 @@
+#include "KitchenFeed.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+    const uint32_t feedMagic = 0x4446544B; // "KTFD"
+    const uint32_t feedVersion = 1;
+
+    static_assert(atomic<uint64_t>::is_always_lock_free, "the feed needs lock-free 64-bit atomics");
+    static_assert(sizeof(KitchenRecord) % sizeof(uint64_t) == 0, "records are copied a word at a time");
+
+    const size_t recordWords = sizeof(KitchenRecord) / sizeof(uint64_t);
+
+    // Start of the shared memory, one cache line
+    struct alignas(64) FeedHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slotCount;
+        uint32_t recordSize;
+        atomic<uint64_t> head; // sequence of the next record to publish
+    };
+
+    struct alignas(64) FeedSlot {
+        atomic<uint64_t> version; // odd while written, 2 * (sequence + 1) once done
+        uint64_t words[recordWords]; // the record, accessed through atomic_ref
+    };
+
+    FeedSlot *slotsOf(const void *mapping) {
+        return reinterpret_cast<FeedSlot *>(static_cast<char *>(const_cast<void *>(mapping)) + sizeof(FeedHeader));
+    }
+
+    FeedHeader *headerOf(const void *mapping) {
+        return static_cast<FeedHeader *>(const_cast<void *>(mapping));
+    }
+}
+
+KitchenFeed::KitchenFeed(const string &name, uint32_t slotCount) : name(name) {
+    if (slotCount == 0 || (slotCount & (slotCount - 1)) != 0) {
+        throw runtime_error("The kitchen feed needs a power of two slots");
+    }
+    mappedSize = sizeof(FeedHeader) + slotCount * sizeof(FeedSlot);
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0 || ftruncate(fd, (off_t) mappedSize) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        throw runtime_error("Cannot create the kitchen feed " + name);
+    }
+    mapping = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw runtime_error("Cannot map the kitchen feed " + name);
+    }
+
+    // Start an empty ring; the magic goes last so readers never see a half-made header
+    FeedHeader *header = headerOf(mapping);
+    header->magic = 0;
+    header->version = feedVersion;
+    header->slotCount = slotCount;
+    header->recordSize = sizeof(KitchenRecord);
+    header->head.store(0, memory_order_relaxed);
+    FeedSlot *slots = slotsOf(mapping);
+    for (uint32_t i = 0; i < slotCount; i++) {
+        slots[i].version.store(0, memory_order_relaxed);
+    }
+    atomic_ref<uint32_t>(header->magic).store(feedMagic, memory_order_release);
+}
+
+KitchenFeed::~KitchenFeed() {
+    munmap(mapping, mappedSize);
+    shm_unlink(name.c_str());
+}
+
+uint64_t KitchenFeed::getPublishedCount() const {
+    return headerOf(mapping)->head.load(memory_order_acquire);
+}
+
+void KitchenFeed::onEnqueued(const Order &order) {
+    publish(KitchenRecord::Enqueued, order);
+}
+
+void KitchenFeed::onCompleted(const Order &order) {
+    publish(KitchenRecord::Completed, order);
+}
+
+void KitchenFeed::publish(KitchenRecord::Event event, const Order &order) {
+    KitchenRecord record;
+    memset(&record, 0, sizeof(record));
+    record.orderId = order.getOrderId();
+    record.timestampMicros = chrono::duration_cast<chrono::microseconds>(
+        chrono::system_clock::now().time_since_epoch()).count();
+    record.totalCents = llround(order.getTotalAmount() * 100);
+    record.event = event;
+    const OrderLines &lines = order.getLines();
+    record.lineCount = (uint8_t) min(lines.size(), (size_t) KitchenRecord::maxLines);
+    record.truncated = lines.size() > (size_t) KitchenRecord::maxLines ? 1 : 0;
+    for (int i = 0; i < record.lineCount; i++) {
+        record.lines[i].menuItemId = lines[i].menuItemId;
+        record.lines[i].quantity = lines[i].quantity;
+    }
+    string customerName = order.getCustomerName();
+    memcpy(record.customerName, customerName.data(),
+           min(customerName.size(), (size_t) KitchenRecord::nameSize - 1));
+
+    lock_guard<mutex> guard(writer);
+    FeedHeader *header = headerOf(mapping);
+    uint64_t sequence = header->head.load(memory_order_relaxed);
+    record.sequence = sequence;
+    FeedSlot &slot = slotsOf(mapping)[sequence & (header->slotCount - 1)];
+
+    // Mark the slot as being written before any word of the record changes
+    slot.version.store(2 * sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    uint64_t words[recordWords];
+    memcpy(words, &record, sizeof(record));
+    for (size_t i = 0; i < recordWords; i++) {
+        atomic_ref<uint64_t>(slot.words[i]).store(words[i], memory_order_relaxed);
+    }
+    slot.version.store(2 * sequence + 2, memory_order_release);
+    header->head.store(sequence + 1, memory_order_release);
+}
+
+KitchenFeedReader::KitchenFeedReader(const string &name) : missed(0) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw runtime_error("No kitchen feed named " + name);
+    }
+    FeedHeader probe;
+    if (pread(fd, &probe, sizeof(uint32_t) * 4, 0) != (ssize_t) (sizeof(uint32_t) * 4)
+        || probe.magic != feedMagic || probe.version != feedVersion || probe.recordSize != sizeof(KitchenRecord)) {
+        close(fd);
+        throw runtime_error("Not a kitchen feed this program can read: " + name);
+    }
+    mappedSize = sizeof(FeedHeader) + probe.slotCount * sizeof(FeedSlot);
+    void *mapped = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        throw runtime_error("Cannot map the kitchen feed " + name);
+    }
+    mapping = mapped;
+    nextSequence = headerOf(mapping)->head.load(memory_order_acquire);
+}
+
+KitchenFeedReader::~KitchenFeedReader() {
+    munmap(const_cast<void *>(mapping), mappedSize);
+}
+
+bool KitchenFeedReader::next(KitchenRecord &record) {
+    FeedHeader *header = headerOf(mapping);
+    FeedSlot *slots = slotsOf(mapping);
+    uint64_t slotCount = header->slotCount;
+    while (true) {
+        uint64_t head = header->head.load(memory_order_acquire);
+        if (nextSequence >= head) {
+            return false;
+        }
+        if (head - nextSequence > slotCount) {
+            // Lapped by the writer: the oldest records are gone
+            missed += head - slotCount - nextSequence;
+            nextSequence = head - slotCount;
+        }
+
+        FeedSlot &slot = slots[nextSequence & (slotCount - 1)];
+        uint64_t expected = 2 * nextSequence + 2;
+        uint64_t before = slot.version.load(memory_order_acquire);
+        if (before != expected) {
+            missed++; // already overwritten by a later record
+            nextSequence++;
+            continue;
+        }
+        uint64_t words[recordWords];
+        for (size_t i = 0; i < recordWords; i++) {
+            words[i] = atomic_ref<uint64_t>(slot.words[i]).load(memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (slot.version.load(memory_order_relaxed) != expected) {
+            missed++; // overwritten while it was copied
+            nextSequence++;
+            continue;
+        }
+        memcpy(&record, words, sizeof(record));
+        nextSequence++;
+        return true;
+    }
+}
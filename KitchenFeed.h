@@ -0,0 +1,142 @@
+#ifndef KITCHENFEED_H
+#define KITCHENFEED_H
+
+#include "OrderListener.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  KitchenRecord                                                         *
+ *  One order event as published to kitchen displays. Fixed size and     *
+ *  free of pointers, so it can be copied straight out of shared memory.  *
+ *  Items are given by menu item ID; a display names them from the menu.  *
+ *------------------------------------------------------------------------*/
+struct KitchenRecord {
+    enum Event : uint8_t {
+        Enqueued = 1,
+        Completed = 2
+    };
+
+    static const int maxLines = 16;
+    static const int nameSize = 32;
+
+    uint64_t sequence; // position in the feed, one per event
+    int64_t orderId; // order the event is about
+    int64_t timestampMicros; // when it was published, since the Unix epoch
+    int64_t totalCents; // order total
+    uint8_t event; // an Event
+    uint8_t lineCount; // lines filled in below
+    uint8_t truncated; // 1 if the order had more than maxLines lines
+    uint8_t reserved[5];
+    char customerName[nameSize]; // NUL-padded, cut to nameSize - 1 characters
+    struct {
+        int32_t menuItemId;
+        int32_t quantity;
+    } lines[maxLines];
+};
+
+/*------------------------------------------------------------------------*
+ *  KitchenFeed                                                           *
+ *  Publishes every enqueued and completed order into a ring of           *
+ *  KitchenRecords in POSIX shared memory, for KitchenFeedReaders in      *
+ *  other processes. Publishing never waits for readers: a reader that   *
+ *  falls more than a ring behind loses the oldest records, and notices  *
+ *  it from the sequence numbers.                                         *
+ *                                                                        *
+ *  Each slot carries a version that is odd while the slot is written     *
+ *  and 2 * (sequence + 1) once record sequence is in it, so a reader     *
+ *  can tell a finished record from one being overwritten under it        *
+ *  without taking a lock. One feed per name: a second producer on the   *
+ *  same name would corrupt the first one's ring.                         *
+ *------------------------------------------------------------------------*/
+class KitchenFeed : public OrderListener {
+public:
+    /*------------------------------------------------------------------------*
+     *  KitchenFeed                                                           *
+     *  Parameterized constructor. Creates (or takes over) the shared memory *
+     *  object name and starts an empty ring of slotCount records.           *
+     *                                                                        *
+     *  Precondition:  name starts with '/'; slotCount is a power of two.     *
+     *  Postcondition: Throws runtime_error if the memory cannot be set up.   *
+     *------------------------------------------------------------------------*/
+    explicit KitchenFeed(const string &name = "/orders-kitchen", uint32_t slotCount = 1024);
+
+    /*------------------------------------------------------------------------*
+     *  ~KitchenFeed                                                          *
+     *  Destructor. Unmaps and removes the shared memory object; readers     *
+     *  still attached keep their mapping until they detach.                  *
+     *------------------------------------------------------------------------*/
+    ~KitchenFeed();
+
+    KitchenFeed(const KitchenFeed &feed) = delete;
+
+    KitchenFeed &operator=(const KitchenFeed &feed) = delete;
+
+    // Sequence number the next record will get
+    uint64_t getPublishedCount() const;
+
+    // OrderListener
+    void onEnqueued(const Order &order) override;
+
+    void onCompleted(const Order &order) override;
+
+private:
+    string name; // shared memory object name
+    size_t mappedSize; // bytes mapped
+    void *mapping; // the shared memory
+    mutex writer; // one publisher at a time; readers never take it
+
+    // Fills in a record for order and writes it to the next slot
+    void publish(KitchenRecord::Event event, const Order &order);
+};
+
+/*------------------------------------------------------------------------*
+ *  KitchenFeedReader                                                     *
+ *  Follows a KitchenFeed from another process, read-only.                *
+ *------------------------------------------------------------------------*/
+class KitchenFeedReader {
+public:
+    /*------------------------------------------------------------------------*
+     *  KitchenFeedReader                                                     *
+     *  Parameterized constructor. Attaches to the feed name and starts at   *
+     *  its newest record, so only events published from now on are read.    *
+     *                                                                        *
+     *  Precondition:  A KitchenFeed with that name exists.                   *
+     *  Postcondition: Throws runtime_error if it cannot be attached.         *
+     *------------------------------------------------------------------------*/
+    explicit KitchenFeedReader(const string &name = "/orders-kitchen");
+
+    ~KitchenFeedReader();
+
+    KitchenFeedReader(const KitchenFeedReader &reader) = delete;
+
+    KitchenFeedReader &operator=(const KitchenFeedReader &reader) = delete;
+
+    /*------------------------------------------------------------------------*
+     *  next                                                                  *
+     *  Copies the next record into record.                                   *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: Returns false if nothing new was published. Records   *
+     *                 overwritten before they were read are skipped and     *
+     *                 counted in getMissedCount().                           *
+     *------------------------------------------------------------------------*/
+    bool next(KitchenRecord &record);
+
+    // Records lost to overruns so far
+    uint64_t getMissedCount() const { return missed; }
+
+private:
+    size_t mappedSize; // bytes mapped
+    const void *mapping; // the shared memory
+    uint64_t nextSequence; // sequence of the next record to read
+    uint64_t missed; // records lost to overruns
+};
+
+#endif //KITCHENFEED_H
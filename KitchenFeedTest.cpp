@@ -0,0 +1,77 @@
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+#include "KitchenFeed.h"
+#include "TestCheck.h"
+#include "TestOrders.h"
+
+using namespace std;
+
+namespace {
+    void testRecords(const string &name) {
+        KitchenFeed feed(name, 8);
+        KitchenFeedReader reader(name);
+        KitchenRecord record;
+        CHECK(!reader.next(record));
+
+        feed.onEnqueued(testOrder(11, "Ada", 3));
+        feed.onCompleted(testOrder(11, "Ada", 3));
+        feed.onEnqueued(testOrder(12, string(40, 'G'), KitchenRecord::maxLines + 4));
+        CHECK(feed.getPublishedCount() == 3);
+
+        CHECK(reader.next(record));
+        CHECK(record.sequence == 0 && record.orderId == 11 && record.event == KitchenRecord::Enqueued);
+        CHECK(strcmp(record.customerName, "Ada") == 0 && record.lineCount == 3 && !record.truncated);
+        CHECK(record.totalCents == 1500 && record.lines[2].menuItemId == 3 && record.lines[2].quantity == 3);
+
+        CHECK(reader.next(record));
+        CHECK(record.sequence == 1 && record.event == KitchenRecord::Completed);
+
+        CHECK(reader.next(record));
+        CHECK(record.sequence == 2 && record.orderId == 12);
+        CHECK(strlen(record.customerName) == KitchenRecord::nameSize - 1); // cut, still NUL-terminated
+        CHECK(record.lineCount == KitchenRecord::maxLines && record.truncated);
+
+        CHECK(!reader.next(record));
+        CHECK(reader.getMissedCount() == 0);
+    }
+
+    // A reader that falls more than a ring behind skips to the oldest record still there
+    void testOverrun(const string &name) {
+        KitchenFeed feed(name, 8);
+        KitchenFeedReader reader(name);
+        for (int i = 0; i < 20; i++) {
+            feed.onEnqueued(testOrder(100 + i, "Grace", 1));
+        }
+
+        KitchenRecord record;
+        uint64_t expected = 12;
+        while (reader.next(record)) {
+            CHECK(record.sequence == expected && record.orderId == 100 + (int64_t) expected);
+            expected++;
+        }
+        CHECK(expected == 20);
+        CHECK(reader.getMissedCount() == 12);
+
+        // Later records are read normally again
+        feed.onEnqueued(testOrder(200, "Grace", 1));
+        CHECK(reader.next(record) && record.sequence == 20 && record.orderId == 200);
+        CHECK(reader.getMissedCount() == 12);
+    }
+
+    void testErrors(const string &name) {
+        CHECK_THROWS(KitchenFeed(name, 12), runtime_error);
+        CHECK_THROWS(KitchenFeedReader(name + "-missing"), runtime_error);
+    }
+}
+
+int main() {
+    string name = "/kitchen-feed-test-" + to_string(getpid());
+    testRecords(name);
+    testOverrun(name);
+    testErrors(name);
+    return testResult();
+}
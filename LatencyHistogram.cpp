@@ -0,0 +1,150 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+    // Every live histogram; a function-local static, so histograms at namespace scope can register
+    struct Registry {
+        mutex lock;
+        vector<LatencyHistogram *> histograms;
+    };
+
+    Registry &registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    atomic<int> nextSlot{0}; // slots are never reused, so a thread's cached shard never dangles
+
+    thread_local vector<void *> shardCache; // this thread's shard of each histogram, by slot
+
+    // Formats nanoseconds with a unit that keeps it short
+    string formatDuration(uint64_t nanoseconds) {
+        char text[32];
+        if (nanoseconds < 1000) {
+            snprintf(text, sizeof(text), "%llu ns", (unsigned long long) nanoseconds);
+        } else if (nanoseconds < 1000000) {
+            snprintf(text, sizeof(text), "%.1f us", nanoseconds / 1e3);
+        } else if (nanoseconds < 1000000000) {
+            snprintf(text, sizeof(text), "%.1f ms", nanoseconds / 1e6);
+        } else {
+            snprintf(text, sizeof(text), "%.2f s", nanoseconds / 1e9);
+        }
+        return text;
+    }
+}
+
+uint64_t LatencyHistogram::Snapshot::percentile(double q) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(1, (uint64_t) ceil(q * count));
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < (int) buckets.size(); bucket++) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            return min(bucketLimit(bucket), max);
+        }
+    }
+    return max;
+}
+
+LatencyHistogram::LatencyHistogram(const string &name) : name(name), slot(nextSlot.fetch_add(1)) {
+    Registry &histograms = registry();
+    lock_guard<mutex> guard(histograms.lock);
+    histograms.histograms.push_back(this);
+}
+
+LatencyHistogram::~LatencyHistogram() {
+    Registry &histograms = registry();
+    lock_guard<mutex> guard(histograms.lock);
+    histograms.histograms.erase(find(histograms.histograms.begin(), histograms.histograms.end(), this));
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    Shard &shard = localShard();
+    // Only this thread writes the shard: load and store instead of read-modify-write
+    atomic<uint64_t> &bucket = shard.buckets[bucketOf(nanoseconds)];
+    bucket.store(bucket.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    shard.count.store(shard.count.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    shard.total.store(shard.total.load(memory_order_relaxed) + nanoseconds, memory_order_relaxed);
+    if (nanoseconds > shard.max.load(memory_order_relaxed)) {
+        shard.max.store(nanoseconds, memory_order_relaxed);
+    }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    Snapshot merged;
+    merged.buckets.assign(bucketCount, 0);
+    lock_guard<mutex> guard(lock);
+    for (const unique_ptr<Shard> &shard : shards) {
+        merged.count += shard->count.load(memory_order_relaxed);
+        merged.total += shard->total.load(memory_order_relaxed);
+        merged.max = max(merged.max, shard->max.load(memory_order_relaxed));
+        for (int bucket = 0; bucket < bucketCount; bucket++) {
+            merged.buckets[bucket] += shard->buckets[bucket].load(memory_order_relaxed);
+        }
+    }
+    return merged;
+}
+
+vector<LatencyHistogram *> LatencyHistogram::all() {
+    Registry &histograms = registry();
+    lock_guard<mutex> guard(histograms.lock);
+    return histograms.histograms;
+}
+
+void LatencyHistogram::printAll(ostream &out) {
+    char line[160];
+    snprintf(line, sizeof(line), "%-32s %10s %10s %10s %10s %10s\n", "Operation", "Count", "p50", "p99", "p99.9",
+             "max");
+    out << line;
+    vector<LatencyHistogram *> histograms = all();
+    sort(histograms.begin(), histograms.end(),
+         [](LatencyHistogram *a, LatencyHistogram *b) { return a->getName() < b->getName(); });
+    for (LatencyHistogram *histogram : histograms) {
+        Snapshot snapshot = histogram->snapshot();
+        if (snapshot.count == 0) {
+            continue;
+        }
+        snprintf(line, sizeof(line), "%-32s %10llu %10s %10s %10s %10s\n", histogram->getName().c_str(),
+                 (unsigned long long) snapshot.count, formatDuration(snapshot.percentile(0.5)).c_str(),
+                 formatDuration(snapshot.percentile(0.99)).c_str(),
+                 formatDuration(snapshot.percentile(0.999)).c_str(), formatDuration(snapshot.max).c_str());
+        out << line;
+    }
+}
+
+int LatencyHistogram::bucketOf(uint64_t value) {
+    if (value < subBuckets) {
+        return (int) value;
+    }
+    int exponent = 63 - countl_zero(value); // at least 4
+    int sub = (int) ((value >> (exponent - 4)) & (subBuckets - 1));
+    return subBuckets + (exponent - 4) * subBuckets + sub;
+}
+
+uint64_t LatencyHistogram::bucketLimit(int bucket) {
+    if (bucket < subBuckets) {
+        return (uint64_t) bucket;
+    }
+    int exponent = (bucket - subBuckets) / subBuckets + 4;
+    uint64_t sub = (uint64_t) ((bucket - subBuckets) % subBuckets);
+    uint64_t width = (uint64_t) 1 << (exponent - 4);
+    return ((subBuckets + sub) << (exponent - 4)) + (width - 1);
+}
+
+LatencyHistogram::Shard &LatencyHistogram::localShard() {
+    if (shardCache.size() <= (size_t) slot) {
+        shardCache.resize(slot + 1, nullptr);
+    }
+    if (shardCache[slot] == nullptr) {
+        lock_guard<mutex> guard(lock);
+        shards.push_back(make_unique<Shard>());
+        shardCache[slot] = shards.back().get();
+    }
+    return *static_cast<Shard *>(shardCache[slot]);
+}
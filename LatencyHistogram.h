@@ -0,0 +1,129 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  LatencyHistogram                                                      *
+ *  Records how long an operation takes, in nanoseconds, with bounded    *
+ *  relative error: values below 16 ns get a bucket each, and every      *
+ *  power of two above is split into 16 buckets, so a percentile is off  *
+ *  by at most 1/16 of its value whatever the range, like an HDR         *
+ *  histogram with one significant hex digit.                            *
+ *                                                                        *
+ *  Each thread records into a shard of its own with plain relaxed       *
+ *  stores, so recording never contends; a snapshot merges the shards.   *
+ *  Shards stay with the histogram after their thread ends, keeping its  *
+ *  counts.                                                               *
+ *                                                                        *
+ *  Histograms are meant to be long-lived objects at namespace scope,    *
+ *  one per instrumented operation; every live histogram is listed by    *
+ *  all().                                                                *
+ *------------------------------------------------------------------------*/
+class LatencyHistogram {
+public:
+    static const int subBuckets = 16; // buckets per power of two
+    static const int bucketCount = subBuckets + (64 - 4) * subBuckets;
+
+    // Merged counts of every shard at one point in time
+    struct Snapshot {
+        uint64_t count = 0;
+        uint64_t total = 0; // sum of the recorded values
+        uint64_t max = 0;
+        vector<uint64_t> buckets;
+
+        // Smallest recorded value v, within the bucket error, such that a share q of all values is <= v
+        uint64_t percentile(double q) const;
+    };
+
+    // Records the time from its construction to its destruction
+    class Timer {
+    public:
+        explicit Timer(LatencyHistogram &histogram)
+            : histogram(histogram), start(chrono::steady_clock::now()) {
+        }
+
+        ~Timer() {
+            histogram.record((uint64_t) chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now() - start).count());
+        }
+
+        Timer(const Timer &timer) = delete;
+
+        Timer &operator=(const Timer &timer) = delete;
+
+    private:
+        LatencyHistogram &histogram;
+        chrono::steady_clock::time_point start;
+    };
+
+    /*------------------------------------------------------------------------*
+     *  LatencyHistogram                                                      *
+     *  Parameterized constructor. Lists the histogram under name.            *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: all() includes the histogram until it is destroyed.    *
+     *------------------------------------------------------------------------*/
+    explicit LatencyHistogram(const string &name);
+
+    ~LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram &histogram) = delete;
+
+    LatencyHistogram &operator=(const LatencyHistogram &histogram) = delete;
+
+    /*------------------------------------------------------------------------*
+     *  record                                                                *
+     *  Counts one operation that took nanoseconds.                           *
+     *                                                                        *
+     *  Precondition:  None; any thread may record.                           *
+     *  Postcondition: Later snapshots include the value.                     *
+     *------------------------------------------------------------------------*/
+    void record(uint64_t nanoseconds);
+
+    // Merges the shards; values being recorded meanwhile may or may not be included
+    Snapshot snapshot() const;
+
+    const string &getName() const { return name; }
+
+    // Every live histogram
+    static vector<LatencyHistogram *> all();
+
+    // Writes count, p50, p99, p99.9 and max of every histogram that recorded something, by name
+    static void printAll(ostream &out);
+
+    // Bucket of a value, and the highest value that falls into a bucket
+    static int bucketOf(uint64_t value);
+
+    static uint64_t bucketLimit(int bucket);
+
+private:
+    // One thread's counts; only that thread writes them
+    struct alignas(64) Shard {
+        atomic<uint64_t> count{0};
+        atomic<uint64_t> total{0};
+        atomic<uint64_t> max{0};
+        array<atomic<uint64_t>, bucketCount> buckets{};
+    };
+
+    string name;
+    int slot; // index of this histogram in every thread's shard cache
+
+    mutable mutex lock; // guards shards
+    vector<unique_ptr<Shard>> shards;
+
+    // The calling thread's shard, made on its first record
+    Shard &localShard();
+};
+
+#endif //LATENCYHISTOGRAM_H
@@ -0,0 +1,140 @@
+#include "LineItemColumns.h"
+#include "LocalTime.h"
+#include "Logger.h"
+
+LineItemColumns::LineItemColumns() {
+    maxItemId = -1;
+    maxCustomer = 0;
+}
+
+void LineItemColumns::append(const Order &order, int64_t completedAt, uint32_t customer) {
+    for (const OrderLine &line : order.getLines()) {
+        if (line.menuItemId <= 0) {
+            // Item IDs index the per-item buckets; no menu item has one this small
+            LOG_WARNING("Order " << order.getOrderId() << " line with menu item ID " << line.menuItemId
+                        << " left out of the line item columns");
+            continue;
+        }
+        orderIds.push_back(order.getOrderId());
+        timestamps.push_back(completedAt);
+        itemIds.push_back(line.menuItemId);
+        quantities.push_back(line.quantity);
+        priceCents.push_back(line.unitPriceCents);
+        customers.push_back(customer);
+        if (line.menuItemId > maxItemId) {
+            maxItemId = line.menuItemId;
+        }
+    }
+    if (customer > maxCustomer) {
+        maxCustomer = customer;
+    }
+}
+
+LineItemColumns::Selection LineItemColumns::selectTimeRange(int64_t from, int64_t to) const {
+    /*------------------------------------------------------------*
+     *  selectTimeRange                                           *
+     *  Branch-free: every row is written, and the output cursor  *
+     *  only advances past the rows that match.                   *
+     *------------------------------------------------------------*/
+    size_t rows = timestamps.size();
+    Selection selection(rows);
+    const int64_t *time = timestamps.data();
+    size_t count = 0;
+    for (size_t i = 0; i < rows; i++) {
+        selection[count] = (uint32_t) i;
+        count += (size_t) ((time[i] >= from) & (time[i] < to));
+    }
+    selection.resize(count);
+    return selection;
+}
+
+LineItemColumns::Selection LineItemColumns::selectCustomer(uint32_t customer) const {
+    size_t rows = customers.size();
+    Selection selection(rows);
+    const uint32_t *handle = customers.data();
+    size_t count = 0;
+    for (size_t i = 0; i < rows; i++) {
+        selection[count] = (uint32_t) i;
+        count += (size_t) (handle[i] == customer);
+    }
+    selection.resize(count);
+    return selection;
+}
+
+vector<int64_t> LineItemColumns::amounts(const Selection *rows) const {
+    const int32_t *quantity = quantities.data();
+    const int64_t *price = priceCents.data();
+    if (rows == nullptr) {
+        size_t count = quantities.size();
+        vector<int64_t> result(count);
+        int64_t *out = result.data();
+        for (size_t i = 0; i < count; i++) {
+            out[i] = quantity[i] * price[i]; // contiguous multiply, vectorizes
+        }
+        return result;
+    }
+    size_t count = rows->size();
+    vector<int64_t> result(count);
+    const uint32_t *row = rows->data();
+    for (size_t i = 0; i < count; i++) {
+        result[i] = quantity[row[i]] * price[row[i]];
+    }
+    return result;
+}
+
+template <typename Key>
+void LineItemColumns::scatterAdd(const vector<Key> &keys, const Selection *rows, vector<int64_t> &buckets) const {
+    vector<int64_t> amount = amounts(rows);
+    const Key *key = keys.data();
+    int64_t *bucket = buckets.data();
+    if (rows == nullptr) {
+        for (size_t i = 0; i < amount.size(); i++) {
+            bucket[key[i]] += amount[i];
+        }
+    } else {
+        const uint32_t *row = rows->data();
+        for (size_t i = 0; i < amount.size(); i++) {
+            bucket[key[row[i]]] += amount[i];
+        }
+    }
+}
+
+int64_t LineItemColumns::totalCents(const Selection *rows) const {
+    vector<int64_t> amount = amounts(rows);
+    int64_t sum = 0;
+    for (size_t i = 0; i < amount.size(); i++) {
+        sum += amount[i];
+    }
+    return sum;
+}
+
+vector<int64_t> LineItemColumns::revenueByItem(const Selection *rows) const {
+    vector<int64_t> buckets((size_t) (maxItemId + 1), 0);
+    scatterAdd(itemIds, rows, buckets);
+    return buckets;
+}
+
+vector<int64_t> LineItemColumns::revenueByHour(const Selection *rows) const {
+    // Derive the hour-of-day key column first; rows arrive in completion order,
+    // so the clock looks the UTC offset up about once per hour of rows
+    size_t count = timestamps.size();
+    vector<uint8_t> hours(count);
+    const int64_t *time = timestamps.data();
+    LocalClock clock;
+    for (size_t i = 0; i < count; i++) {
+        hours[i] = (uint8_t) ((clock.localSeconds((time_t) time[i]) % 86400) / 3600);
+    }
+    vector<int64_t> buckets(24, 0);
+    scatterAdd(hours, rows, buckets);
+    return buckets;
+}
+
+vector<int64_t> LineItemColumns::revenueByCustomer(const Selection *rows) const {
+    vector<int64_t> buckets(customers.empty() ? 0 : (size_t) maxCustomer + 1, 0);
+    scatterAdd(customers, rows, buckets);
+    return buckets;
+}
+
+size_t LineItemColumns::getRowCount() const {
+    return orderIds.size();
+}
@@ -0,0 +1,98 @@
+#ifndef LINEITEMCOLUMNS_H
+#define LINEITEMCOLUMNS_H
+
+#include "Order.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  LineItemColumns                                                       *
+ *  Column store of completed order lines: one tightly packed array per   *
+ *  field instead of one fat Order per row. Analytic queries filter into  *
+ *  a selection vector of row numbers and aggregate with simple loops     *
+ *  over these arrays, which the compiler can vectorize and which stream  *
+ *  through memory at full bandwidth.                                     *
+ *------------------------------------------------------------------------*/
+class LineItemColumns {
+public:
+    typedef vector<uint32_t> Selection; // row numbers chosen by a filter
+
+    /*------------------------------------------------------------------------*
+     *  LineItemColumns                                                       *
+     *  Default constructor. Creates an empty store.                          *
+     *------------------------------------------------------------------------*/
+    LineItemColumns();
+
+    /*------------------------------------------------------------------------*
+     *  append                                                                *
+     *  Adds one row per line of a completed order.                           *
+     *                                                                        *
+     *  Precondition:  customer is the interned handle of the order's         *
+     *                 customer name.                                         *
+     *  Postcondition: Every line of order with a menu item ID above 0 is a   *
+     *                 row of the store; other lines are logged and skipped.  *
+     *------------------------------------------------------------------------*/
+    void append(const Order &order, int64_t completedAt, uint32_t customer);
+
+    /*------------------------------------------------------------------------*
+     *  selectTimeRange / selectCustomer                                      *
+     *  Filters returning the rows completed in [from, to), or belonging to   *
+     *  one customer.                                                         *
+     *------------------------------------------------------------------------*/
+    Selection selectTimeRange(int64_t from, int64_t to) const;
+
+    Selection selectCustomer(uint32_t customer) const;
+
+    /*------------------------------------------------------------------------*
+     *  Aggregates                                                            *
+     *  Sums of quantity * price in cents over all rows, or only over rows    *
+     *  when given. The group-by results are dense arrays indexed by the key: *
+     *  menu item id, local hour of day (0-23), or customer handle.           *
+     *------------------------------------------------------------------------*/
+    int64_t totalCents(const Selection *rows = nullptr) const;
+
+    vector<int64_t> revenueByItem(const Selection *rows = nullptr) const;
+
+    vector<int64_t> revenueByHour(const Selection *rows = nullptr) const;
+
+    vector<int64_t> revenueByCustomer(const Selection *rows = nullptr) const;
+
+    // Number of rows stored
+    size_t getRowCount() const;
+
+    // Read-only access to the columns
+    const vector<int64_t> &getOrderIds() const { return orderIds; }
+
+    const vector<int64_t> &getTimestamps() const { return timestamps; }
+
+    const vector<int32_t> &getItemIds() const { return itemIds; }
+
+    const vector<int32_t> &getQuantities() const { return quantities; }
+
+    const vector<int64_t> &getPriceCents() const { return priceCents; }
+
+    const vector<uint32_t> &getCustomers() const { return customers; }
+
+private:
+    vector<int64_t> orderIds; // order of each line
+    vector<int64_t> timestamps; // completion time, seconds since the epoch
+    vector<int32_t> itemIds; // menu item id
+    vector<int32_t> quantities; // units sold
+    vector<int64_t> priceCents; // unit price in cents
+    vector<uint32_t> customers; // interned customer handle
+
+    int32_t maxItemId; // largest item id, sizes revenueByItem
+    uint32_t maxCustomer; // largest customer handle, sizes revenueByCustomer
+
+    // quantity * price of every row (or of the selected rows), in row order
+    vector<int64_t> amounts(const Selection *rows) const;
+
+    // Adds amounts into buckets[keys[row]] for every (selected) row
+    template <typename Key>
+    void scatterAdd(const vector<Key> &keys, const Selection *rows, vector<int64_t> &buckets) const;
+};
+
+#endif //LINEITEMCOLUMNS_H
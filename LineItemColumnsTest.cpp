@@ -0,0 +1,60 @@
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+#include "LineItemColumns.h"
+#include "TestCheck.h"
+#include "TestOrders.h"
+
+using namespace std;
+
+namespace {
+    // A local wall-clock time in the test's time zone
+    time_t localAt(int year, int month, int day, int hour, int minute) {
+        tm fields{};
+        fields.tm_year = year - 1900;
+        fields.tm_mon = month - 1;
+        fields.tm_mday = day;
+        fields.tm_hour = hour;
+        fields.tm_min = minute;
+        fields.tm_isdst = -1;
+        return mktime(&fields);
+    }
+
+    void testAggregates() {
+        LineItemColumns columns;
+        columns.append(testOrder(1, "Ada", 2, 100), 1000, 1); // items 1 and 2, one and two units
+        columns.append(testOrder(2, "Grace", 1, 300), 2000, 2);
+        CHECK(columns.getRowCount() == 3);
+        CHECK(columns.totalCents() == 100 + 200 + 300);
+
+        vector<int64_t> byItem = columns.revenueByItem();
+        CHECK(byItem.size() == 3 && byItem[1] == 400 && byItem[2] == 200);
+
+        LineItemColumns::Selection late = columns.selectTimeRange(1500, 3000);
+        CHECK(late.size() == 1 && columns.totalCents(&late) == 300);
+        LineItemColumns::Selection ada = columns.selectCustomer(1);
+        CHECK(ada.size() == 2 && columns.revenueByCustomer(&ada)[1] == 300);
+    }
+
+    // Hours follow the offset in effect at each row, across the change of 2024-03-10
+    void testHoursFollowTheOffsetOfTheirRow() {
+        LineItemColumns columns;
+        columns.append(testOrder(1, "Ada", 1, 100), localAt(2024, 1, 15, 23, 30), 1);
+        columns.append(testOrder(2, "Ada", 1, 200), localAt(2024, 3, 10, 1, 59), 1);
+        columns.append(testOrder(3, "Ada", 1, 400), localAt(2024, 3, 10, 3, 0), 1);
+        columns.append(testOrder(4, "Ada", 1, 800), localAt(2024, 7, 15, 0, 30), 1);
+
+        vector<int64_t> byHour = columns.revenueByHour();
+        CHECK(byHour.size() == 24);
+        CHECK(byHour[23] == 100 && byHour[1] == 200 && byHour[2] == 0 && byHour[3] == 400 && byHour[0] == 800);
+    }
+}
+
+int main() {
+    setenv("TZ", "EST5EDT,M3.2.0,M11.1.0", 1);
+    tzset();
+    testAggregates();
+    testHoursFollowTheOffsetOfTheirRow();
+    return testResult();
+}
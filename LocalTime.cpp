@@ -0,0 +1,36 @@
+#include "LocalTime.h"
+
+namespace {
+    // Seconds added to UTC to get local time, at when
+    long long offsetAt(time_t when) {
+        tm local;
+        localtime_r(&when, &local);
+        return local.tm_gmtoff;
+    }
+}
+
+long long localSeconds(time_t when) {
+    return (long long) when + offsetAt(when);
+}
+
+time_t fromLocalSeconds(long long localTime) {
+    time_t wallClock = (time_t) localTime;
+    tm fields;
+    gmtime_r(&wallClock, &fields);
+    fields.tm_isdst = -1; // let mktime decide which offset applies
+    return mktime(&fields);
+}
+
+long long localDay(time_t when) {
+    return localSeconds(when) / 86400;
+}
+
+long long LocalClock::localSeconds(time_t when) {
+    long long whenHour = (long long) when / 3600;
+    if (whenHour != hour) {
+        hour = whenHour;
+        offset = offsetAt((time_t) (whenHour * 3600));
+        uniform = offsetAt((time_t) (whenHour * 3600 + 3599)) == offset;
+    }
+    return (long long) when + (uniform ? offset : offsetAt(when));
+}
@@ -0,0 +1,53 @@
+#ifndef LOCALTIME_H
+#define LOCALTIME_H
+
+#include <climits>
+#include <ctime>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  LocalTime                                                             *
+ *  Local wall-clock time for day and hour buckets. Every conversion      *
+ *  looks up the UTC offset in effect at the time converted, not the one  *
+ *  in effect at startup, so a bucket keeps starting at local midnight or *
+ *  on the local hour after a daylight saving change.                     *
+ *------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------*
+ *  localSeconds                                                          *
+ *  Returns when as seconds since the epoch on the local wall clock.      *
+ *  Dividing by 86400 gives the local day number, the remainder divided   *
+ *  by 3600 the local hour of day.                                        *
+ *------------------------------------------------------------------------*/
+long long localSeconds(time_t when);
+
+/*------------------------------------------------------------------------*
+ *  fromLocalSeconds                                                      *
+ *  Returns the point in time at which the local wall clock shows         *
+ *  localTime. A wall-clock time skipped by a daylight saving change      *
+ *  maps to the moment after the gap; a repeated one to one of its two    *
+ *  occurrences.                                                          *
+ *------------------------------------------------------------------------*/
+time_t fromLocalSeconds(long long localTime);
+
+// Local day number of a point in time
+long long localDay(time_t when);
+
+/*------------------------------------------------------------------------*
+ *  LocalClock                                                            *
+ *  localSeconds for long runs of timestamps. The offset is looked up     *
+ *  once per UTC hour and reused for the timestamps of that hour, unless  *
+ *  the offset changes within it.                                         *
+ *------------------------------------------------------------------------*/
+class LocalClock {
+public:
+    long long localSeconds(time_t when);
+
+private:
+    long long hour = LLONG_MIN; // UTC hour number the cached offset belongs to
+    long long offset = 0; // offset in effect throughout that hour
+    bool uniform = false; // false if the offset changes within that hour
+};
+
+#endif //LOCALTIME_H
@@ -0,0 +1,222 @@
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Slot {
+        uint64_t time; // steady clock ticks, to merge the rings in order
+        LogLevel level;
+        uint16_t length;
+        char text[Logger::slotSize - 16];
+    };
+
+    // One thread's messages: the thread moves head, the drain moves tail
+    struct Ring {
+        alignas(64) atomic<uint64_t> head{0};
+        alignas(64) atomic<uint64_t> tail{0};
+        atomic<uint64_t> dropped{0};
+        Slot slots[Logger::slotsPerThread];
+    };
+
+    // Owns the rings and the thread that drains them
+    class Sink {
+    public:
+        Sink() : worker([this] { run(); }) {
+        }
+
+        ~Sink() {
+            {
+                lock_guard<mutex> guard(wakeLock);
+                stopping = true;
+            }
+            wake.notify_one();
+            worker.join();
+            drain();
+        }
+
+        Ring &localRing() {
+            // The thread's reference keeps an exited thread's ring from being pruned before it is drained
+            thread_local shared_ptr<Ring> ring;
+            if (!ring) {
+                ring = make_shared<Ring>();
+                lock_guard<mutex> guard(ringsLock);
+                rings.push_back(ring);
+            }
+            return *ring;
+        }
+
+        void drain() {
+            lock_guard<mutex> guard(drainLock); // one consumer at a time
+            vector<shared_ptr<Ring>> current;
+            {
+                lock_guard<mutex> ringsGuard(ringsLock);
+                current = rings;
+            }
+
+            vector<const Slot *> ready;
+            vector<pair<Ring *, uint64_t>> consumed;
+            for (const shared_ptr<Ring> &ring : current) {
+                uint64_t tail = ring->tail.load(memory_order_relaxed);
+                uint64_t head = ring->head.load(memory_order_acquire);
+                for (uint64_t i = tail; i < head; i++) {
+                    ready.push_back(&ring->slots[i % Logger::slotsPerThread]);
+                }
+                consumed.emplace_back(ring.get(), head);
+            }
+            stable_sort(ready.begin(), ready.end(), [](const Slot *a, const Slot *b) { return a->time < b->time; });
+
+            ostream *out = target.load();
+            if (out != nullptr && !ready.empty()) {
+                string text;
+                for (const Slot *slot : ready) {
+                    if (slot->level == LogLevel::Warning) {
+                        text += "Warning: ";
+                    } else if (slot->level == LogLevel::Error) {
+                        text += "Error: ";
+                    }
+                    text.append(slot->text, slot->length);
+                    text += '\n';
+                }
+                *out << text << flush;
+            }
+            for (const pair<Ring *, uint64_t> &done : consumed) {
+                done.first->tail.store(done.second, memory_order_release); // the slots may be reused now
+            }
+
+            // Forget the rings of exited threads once they are empty
+            lock_guard<mutex> ringsGuard(ringsLock);
+            for (size_t i = 0; i < rings.size();) {
+                if (rings[i].use_count() == 1 && rings[i]->tail.load() == rings[i]->head.load()) {
+                    prunedDrops += rings[i]->dropped.load();
+                    rings.erase(rings.begin() + (long) i);
+                } else {
+                    i++;
+                }
+            }
+        }
+
+        uint64_t dropped() {
+            lock_guard<mutex> guard(ringsLock);
+            uint64_t count = prunedDrops;
+            for (const shared_ptr<Ring> &ring : rings) {
+                count += ring->dropped.load(memory_order_relaxed);
+            }
+            return count;
+        }
+
+        atomic<ostream *> target{&cout};
+        atomic<int> level{ORDERS_LOG_LEVEL};
+
+    private:
+        mutex ringsLock; // guards rings
+        vector<shared_ptr<Ring>> rings;
+        uint64_t prunedDrops = 0; // dropped by the rings already forgotten
+
+        mutex drainLock;
+
+        mutex wakeLock;
+        condition_variable wake;
+        bool stopping = false;
+        thread worker;
+
+        void run() {
+            unique_lock<mutex> guard(wakeLock);
+            while (!stopping) {
+                wake.wait_for(guard, chrono::milliseconds(5));
+                guard.unlock();
+                drain();
+                guard.lock();
+            }
+        }
+    };
+
+    Sink &sink() {
+        static Sink instance; // started on first use, drained and stopped at exit
+        return instance;
+    }
+
+    // A streambuf over a fixed array: formatting a message never allocates
+    class LineBuffer : public streambuf {
+    public:
+        void reset() {
+            setp(text, text + sizeof(text));
+        }
+
+        const char *data() const { return pbase(); }
+
+        size_t size() const { return (size_t) (pptr() - pbase()); }
+
+    private:
+        char text[sizeof(Slot::text)];
+    };
+
+    struct LineStream {
+        LineBuffer buffer;
+        ostream out{&buffer};
+    };
+
+    LineStream &lineStream() {
+        thread_local LineStream stream;
+        return stream;
+    }
+}
+
+void Logger::setSink(ostream *out) {
+    sink().target.store(out);
+}
+
+void Logger::setLevel(LogLevel level) {
+    sink().level.store(max((int) level, ORDERS_LOG_LEVEL));
+}
+
+bool Logger::isEnabled(LogLevel level) {
+    return (int) level >= sink().level.load(memory_order_relaxed);
+}
+
+void Logger::write(LogLevel level, const char *text, size_t length) {
+    Ring &ring = sink().localRing();
+    uint64_t head = ring.head.load(memory_order_relaxed);
+    if (head - ring.tail.load(memory_order_acquire) == slotsPerThread) {
+        ring.dropped.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+    Slot &slot = ring.slots[head % slotsPerThread];
+    slot.time = (uint64_t) chrono::steady_clock::now().time_since_epoch().count();
+    slot.level = level;
+    slot.length = (uint16_t) min(length, sizeof(slot.text));
+    memcpy(slot.text, text, slot.length);
+    ring.head.store(head + 1, memory_order_release);
+}
+
+void Logger::flush() {
+    sink().drain();
+}
+
+uint64_t Logger::getDroppedCount() {
+    return sink().dropped();
+}
+
+LogLine::LogLine(LogLevel level) : level(level) {
+    LineStream &line = lineStream();
+    line.buffer.reset();
+    line.out.clear(); // a cut message leaves badbit set
+}
+
+LogLine::~LogLine() {
+    LineStream &line = lineStream();
+    Logger::write(level, line.buffer.data(), line.buffer.size());
+}
+
+ostream &LogLine::stream() {
+    return lineStream().out;
+}
@@ -0,0 +1,119 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+using namespace std;
+
+// Lowest level compiled in: 0 debug, 1 info, 2 warning, 3 error (the CMake cache entry of the same name)
+#ifndef ORDERS_LOG_LEVEL
+#define ORDERS_LOG_LEVEL 1
+#endif
+
+enum class LogLevel : uint8_t {
+    Debug = 0,
+    Info = 1,
+    Warning = 2,
+    Error = 3
+};
+
+/*------------------------------------------------------------------------*
+ *  Logger                                                                *
+ *  Takes status messages off the hot path. A message is formatted into  *
+ *  a fixed buffer and copied into the calling thread's ring of slots,   *
+ *  a single-producer single-consumer queue that needs no lock; a        *
+ *  background thread drains every ring, in time order, to the sink.     *
+ *  When a ring is full the message is dropped and counted, so logging   *
+ *  never blocks.                                                         *
+ *                                                                        *
+ *  Log through the LOG_ macros below. Levels under ORDERS_LOG_LEVEL     *
+ *  compile to nothing, message formatting included; setLevel raises    *
+ *  the threshold further at run time.                                    *
+ *------------------------------------------------------------------------*/
+class Logger {
+public:
+    static const size_t slotSize = 256; // longer messages are cut
+    static const size_t slotsPerThread = 1024;
+
+    // Where drained messages go, cout unless changed; nullptr discards them
+    static void setSink(ostream *out);
+
+    static void setLevel(LogLevel level);
+
+    static bool isEnabled(LogLevel level);
+
+    /*------------------------------------------------------------------------*
+     *  write                                                                 *
+     *  Queues one message of the calling thread.                             *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: The sink gets the message within a few milliseconds,  *
+     *                 unless the thread's ring was full.                     *
+     *------------------------------------------------------------------------*/
+    static void write(LogLevel level, const char *text, size_t length);
+
+    /*------------------------------------------------------------------------*
+     *  flush                                                                 *
+     *  Writes every message queued so far, by any thread, to the sink.       *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: Nothing logged before the call is still queued.        *
+     *------------------------------------------------------------------------*/
+    static void flush();
+
+    // Messages dropped because a ring was full
+    static uint64_t getDroppedCount();
+};
+
+/*------------------------------------------------------------------------*
+ *  LogLine                                                               *
+ *  Formats one message with <<, into a per-thread buffer that never     *
+ *  allocates, and queues it when destroyed.                              *
+ *------------------------------------------------------------------------*/
+class LogLine {
+public:
+    explicit LogLine(LogLevel level);
+
+    ~LogLine();
+
+    LogLine(const LogLine &line) = delete;
+
+    LogLine &operator=(const LogLine &line) = delete;
+
+    ostream &stream();
+
+private:
+    LogLevel level;
+};
+
+#define ORDERS_LOG(level, message)                   \
+    do {                                             \
+        if (Logger::isEnabled(level)) {              \
+            LogLine logLine(level);                  \
+            logLine.stream() << message;             \
+        }                                            \
+    } while (false)
+
+#if ORDERS_LOG_LEVEL <= 0
+#define LOG_DEBUG(message) ORDERS_LOG(LogLevel::Debug, message)
+#else
+#define LOG_DEBUG(message) do { } while (false)
+#endif
+
+#if ORDERS_LOG_LEVEL <= 1
+#define LOG_INFO(message) ORDERS_LOG(LogLevel::Info, message)
+#else
+#define LOG_INFO(message) do { } while (false)
+#endif
+
+#if ORDERS_LOG_LEVEL <= 2
+#define LOG_WARNING(message) ORDERS_LOG(LogLevel::Warning, message)
+#else
+#define LOG_WARNING(message) do { } while (false)
+#endif
+
+#define LOG_ERROR(message) ORDERS_LOG(LogLevel::Error, message)
+
+#endif //LOGGER_H
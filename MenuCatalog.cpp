@@ -0,0 +1,113 @@
+#include "MenuCatalog.h"
+
+#include <functional>
+#include <thread>
+
+/*------------------------------------------------------------------------*
+ *  The read side relies on the single total order of seq_cst operations: *
+ *  a reader stores its epoch before loading the published pointer, and a *
+ *  writer swaps the pointer before scanning the reader slots. Either the *
+ *  writer sees the reader's epoch, or the reader loads the new version.  *
+ *------------------------------------------------------------------------*/
+
+MenuCatalog::Snapshot::Snapshot(const MenuCatalog *catalog, int slot, const DynamicArrayList *menu)
+    : catalog(catalog), slot(slot), menu(menu) {
+}
+
+MenuCatalog::Snapshot::Snapshot(Snapshot &&snapshot) noexcept
+    : catalog(snapshot.catalog), slot(snapshot.slot), menu(snapshot.menu) {
+    snapshot.slot = -1;
+}
+
+MenuCatalog::Snapshot::~Snapshot() {
+    if (slot >= 0) {
+        catalog->slots[slot].epoch.store(0);
+    }
+}
+
+MenuCatalog::MenuCatalog() : MenuCatalog(DynamicArrayList(1)) {
+}
+
+MenuCatalog::MenuCatalog(const DynamicArrayList &menu) {
+    current.store(new DynamicArrayList(menu));
+    globalEpoch.store(1); // 0 is reserved for idle reader slots
+}
+
+MenuCatalog::~MenuCatalog() {
+    delete current.load();
+    for (const RetiredVersion &version : retired) {
+        delete version.menu;
+    }
+}
+
+MenuCatalog::Snapshot MenuCatalog::read() const {
+    /*------------------------------------------------------------*
+     *  read                                                      *
+     *  Claims a free reader slot with the current epoch, then    *
+     *  loads the published version. Threads start their search   *
+     *  at different slots so they rarely touch the same line.    *
+     *------------------------------------------------------------*/
+    static thread_local int hint = (int) (hash<thread::id>()(this_thread::get_id()) % MAX_READERS);
+
+    while (true) {
+        uint64_t epoch = globalEpoch.load();
+        for (int i = 0; i < MAX_READERS; i++) {
+            int slot = (hint + i) % MAX_READERS;
+            uint64_t idle = 0;
+            if (slots[slot].epoch.compare_exchange_strong(idle, epoch)) {
+                hint = slot;
+                return Snapshot(this, slot, current.load());
+            }
+        }
+        this_thread::yield(); // every slot is pinned; wait for a reader to leave
+    }
+}
+
+void MenuCatalog::publish(const DynamicArrayList &menu) {
+    DynamicArrayList *next = new DynamicArrayList(menu); // copy outside the lock
+    lock_guard<mutex> lock(writerMutex);
+    publishLocked(next);
+}
+
+void MenuCatalog::publish(DynamicArrayList &&menu) {
+    DynamicArrayList *next = new DynamicArrayList(std::move(menu));
+    lock_guard<mutex> lock(writerMutex);
+    publishLocked(next);
+}
+
+int MenuCatalog::getRetiredCount() const {
+    lock_guard<mutex> lock(writerMutex);
+    return (int) retired.size();
+}
+
+void MenuCatalog::publishLocked(const DynamicArrayList *next) {
+    /*------------------------------------------------------------*
+     *  publishLocked                                             *
+     *  Readers that pin the epoch after the increment can only   *
+     *  load next, so the old version is tagged with that epoch.  *
+     *------------------------------------------------------------*/
+    const DynamicArrayList *old = current.exchange(next);
+    uint64_t retiredAt = globalEpoch.fetch_add(1) + 1;
+    retired.push_back(RetiredVersion{old, retiredAt});
+    reclaimLocked();
+}
+
+void MenuCatalog::reclaimLocked() {
+    uint64_t oldestReader = UINT64_MAX;
+    for (int i = 0; i < MAX_READERS; i++) {
+        uint64_t epoch = slots[i].epoch.load();
+        if (epoch != 0 && epoch < oldestReader) {
+            oldestReader = epoch;
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < retired.size(); i++) {
+        if (retired[i].retiredAt <= oldestReader) {
+            delete retired[i].menu; // grace period over: no reader can hold it
+        } else {
+            retired[kept++] = retired[i];
+        }
+    }
+    retired.resize(kept);
+}
@@ -0,0 +1,150 @@
+#ifndef MENUCATALOG_H
+#define MENUCATALOG_H
+
+#include "DynamicArrayList.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  MenuCatalog                                                           *
+ *  Publishes immutable versions of the menu for concurrent readers.      *
+ *  A reader claims a free reader slot with a compare-and-swap, pinning   *
+ *  the current epoch, then loads the published version. Readers take no  *
+ *  lock and never wait for a writer; they only yield while all           *
+ *  MAX_READERS slots are held by other readers. A writer builds a new    *
+ *  version off to the side, swaps it in, and frees the old one once      *
+ *  every reader that could still see it has left (the grace period).     *
+ *------------------------------------------------------------------------*/
+class MenuCatalog {
+public:
+    /*------------------------------------------------------------------------*
+     *  Snapshot                                                              *
+     *  Read guard holding one published version of the menu. The version    *
+     *  stays valid and unchanged until the Snapshot is destroyed.            *
+     *------------------------------------------------------------------------*/
+    class Snapshot {
+    public:
+        Snapshot(Snapshot &&snapshot) noexcept;
+
+        Snapshot(const Snapshot &snapshot) = delete;
+
+        Snapshot &operator=(const Snapshot &snapshot) = delete;
+
+        // Leaves the read-side critical section
+        ~Snapshot();
+
+        const DynamicArrayList &operator*() const { return *menu; }
+
+        const DynamicArrayList *operator->() const { return menu; }
+
+    private:
+        friend class MenuCatalog;
+
+        const MenuCatalog *catalog; // Catalog the slot belongs to
+        int slot; // Reader slot pinned by this snapshot, -1 once moved from
+        const DynamicArrayList *menu; // Pinned version of the menu
+
+        Snapshot(const MenuCatalog *catalog, int slot, const DynamicArrayList *menu);
+    };
+
+    /*------------------------------------------------------------------------*
+     *  MenuCatalog                                                           *
+     *  Constructors. Publish an empty menu, or a copy of menu.               *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: read() returns the initial version.                    *
+     *------------------------------------------------------------------------*/
+    MenuCatalog();
+
+    explicit MenuCatalog(const DynamicArrayList &menu);
+
+    /*------------------------------------------------------------------------*
+     *  ~MenuCatalog                                                          *
+     *  Destructor. Frees the published and every retired version.           *
+     *                                                                        *
+     *  Precondition:  No Snapshot of this catalog is alive.                  *
+     *------------------------------------------------------------------------*/
+    ~MenuCatalog();
+
+    MenuCatalog(const MenuCatalog &catalog) = delete;
+
+    MenuCatalog &operator=(const MenuCatalog &catalog) = delete;
+
+    /*------------------------------------------------------------------------*
+     *  read                                                                  *
+     *  Returns a guard over the currently published menu. Safe to call from  *
+     *  any thread while writers publish; it scans for a free reader slot     *
+     *  and yields while every slot is held.                                  *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: The returned version cannot change or be freed until   *
+     *                 the guard is destroyed.                                *
+     *------------------------------------------------------------------------*/
+    Snapshot read() const;
+
+    /*------------------------------------------------------------------------*
+     *  publish                                                               *
+     *  Replaces the published menu with a copy of (or, for an rvalue, the    *
+     *  contents of) menu.                                                    *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: New readers see menu; old versions are freed once     *
+     *                 their readers have left.                               *
+     *------------------------------------------------------------------------*/
+    void publish(const DynamicArrayList &menu);
+
+    void publish(DynamicArrayList &&menu);
+
+    /*------------------------------------------------------------------------*
+     *  getRetiredCount                                                       *
+     *  Returns the number of old versions still waiting for their readers.   *
+     *------------------------------------------------------------------------*/
+    int getRetiredCount() const;
+
+private:
+    static const int MAX_READERS = 64; // Readers that can hold a snapshot at once
+
+    // One reader's pinned epoch on its own cache line; 0 means not reading
+    struct alignas(64) ReaderSlot {
+        atomic<uint64_t> epoch{0};
+    };
+
+    // An unpublished version and the epoch from which no new reader sees it
+    struct RetiredVersion {
+        const DynamicArrayList *menu;
+        uint64_t retiredAt;
+    };
+
+    atomic<const DynamicArrayList *> current; // Published version
+    atomic<uint64_t> globalEpoch; // Advanced by every publish
+    mutable ReaderSlot slots[MAX_READERS]; // Epochs pinned by active readers
+
+    mutable mutex writerMutex; // Serializes publishers and guards retired
+    vector<RetiredVersion> retired; // Versions waiting for their grace period
+
+    /*------------------------------------------------------------------------*
+     *  publishLocked                                                         *
+     *  Swaps next in, retires the previous version and reclaims whatever     *
+     *  has passed its grace period.                                          *
+     *                                                                        *
+     *  Precondition:  writerMutex is held and next is heap allocated.        *
+     *  Postcondition: next is published and owned by the catalog.            *
+     *------------------------------------------------------------------------*/
+    void publishLocked(const DynamicArrayList *next);
+
+    /*------------------------------------------------------------------------*
+     *  reclaimLocked                                                         *
+     *  Frees retired versions that no active reader can still hold.          *
+     *                                                                        *
+     *  Precondition:  writerMutex is held.                                   *
+     *  Postcondition: Only versions some reader may hold remain retired.     *
+     *------------------------------------------------------------------------*/
+    void reclaimLocked();
+};
+
+#endif //MENUCATALOG_H
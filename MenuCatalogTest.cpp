@@ -0,0 +1,77 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "MenuCatalog.h"
+#include "TestCheck.h"
+
+using namespace std;
+
+namespace {
+    // Version number of the menu: version items, each priced at the version
+    DynamicArrayList versionOf(int version) {
+        DynamicArrayList menu;
+        for (int id = 1; id <= version; id++) {
+            menu.add(MenuItem(id, "Item " + to_string(id), "Version " + to_string(version), version));
+        }
+        return menu;
+    }
+
+    // A version is freed only after the last snapshot that can see it is gone
+    void testReclaim() {
+        MenuCatalog catalog(versionOf(1));
+        {
+            MenuCatalog::Snapshot pinned = catalog.read();
+            catalog.publish(versionOf(2));
+            catalog.publish(versionOf(3));
+            CHECK(catalog.getRetiredCount() == 2);
+            CHECK(pinned->getSize() == 1 && pinned->getMenuItem(0).getPrice() == 1);
+            CHECK(catalog.read()->getSize() == 3);
+
+            MenuCatalog::Snapshot moved = std::move(pinned); // the pin goes along
+            catalog.publish(versionOf(4));
+            CHECK(catalog.getRetiredCount() == 3 && moved->getSize() == 1);
+        }
+        catalog.publish(versionOf(5));
+        CHECK(catalog.getRetiredCount() == 0);
+        CHECK(catalog.read()->getSize() == 5);
+    }
+
+    // Readers racing a publisher always see one whole version
+    void testReadersSeeWholeVersions() {
+        MenuCatalog catalog(versionOf(1));
+        atomic<bool> publishing(true);
+        atomic<int> torn(0);
+        vector<thread> readers;
+        for (int r = 0; r < 4; r++) {
+            readers.emplace_back([&catalog, &publishing, &torn] {
+                while (publishing.load()) {
+                    MenuCatalog::Snapshot menu = catalog.read();
+                    int version = menu->getSize();
+                    for (int i = 0; i < version; i++) {
+                        if (menu->getMenuItem(i).getPrice() != version) {
+                            torn++;
+                        }
+                    }
+                }
+            });
+        }
+        for (int version = 2; version <= 300; version++) {
+            catalog.publish(versionOf(version % 20 + 1));
+        }
+        publishing = false;
+        for (thread &reader : readers) {
+            reader.join();
+        }
+        CHECK(torn == 0);
+
+        catalog.publish(versionOf(1)); // no reader left, so every old version goes
+        CHECK(catalog.getRetiredCount() == 0);
+    }
+}
+
+int main() {
+    testReclaim();
+    testReadersSeeWholeVersions();
+    return testResult();
+}
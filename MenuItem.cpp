@@ -1,10 +1,11 @@
 #include "MenuItem.h"
+#include "Logger.h"
 #include <iostream>
 #include <ostream>
 using namespace std;
 
 // Static variable for generating unique IDs for each menu item
-int MenuItem::nextId = 1;
+atomic<int> MenuItem::nextId(1);
 
 /*------------------------------------------------------------------------*
  *  MenuItem                                                              *
@@ -14,16 +15,24 @@ int MenuItem::nextId = 1;
 
  // Default constructor
  // Initializes a MenuItem object with default values for name, description,
- // and price, calling the `setMenuItem` method to set those values.
-MenuItem::MenuItem() {
-    setMenuItem("", "", 0.0);  // Default values
+ // and price. Its ID stays 0 (no item): arrays of empty slots must not use up
+ // the IDs of items the user creates.
+MenuItem::MenuItem() : id(0), name(""), description(""), price(0.0), category("") {
 }
 
 // Parameterized constructor
 // Initializes a MenuItem object with the provided name, description,
-// and price by calling the `setMenuItem` method.
+// and price by calling the `setMenuItem` method. As in menu.txt, the
+// name doubles as the category.
 MenuItem::MenuItem(string& name, string& description, double price) {
     setMenuItem(name, description, price);
+    category = name;
+}
+
+// Restoring constructor
+// Rebuilds an item read back from storage, keeping its original ID.
+MenuItem::MenuItem(int id, const string& name, const string& description, double price, const string& category)
+    : id(id), name(name), description(description), price(price), category(category.empty() ? name : category) {
 }
 
 // Copy constructor
@@ -34,6 +43,43 @@ MenuItem::MenuItem(const MenuItem& menuitem) {
     name = menuitem.name;        // Copy the name
     description = menuitem.description; // Copy the description
     price = menuitem.price;      // Copy the price
+    category = menuitem.category; // Copy the category
+}
+
+// Move constructor
+// Takes over the name and description strings of the given MenuItem.
+MenuItem::MenuItem(MenuItem&& menuitem) noexcept
+    : id(menuitem.id),
+      name(std::move(menuitem.name)),
+      description(std::move(menuitem.description)),
+      price(menuitem.price),
+      category(std::move(menuitem.category)) {
+}
+
+// Copy assignment
+// Replaces this item's attributes with copies of the given item's.
+MenuItem& MenuItem::operator=(const MenuItem& menuitem) {
+    if (this != &menuitem) {
+        id = menuitem.id;
+        name = menuitem.name;
+        description = menuitem.description;
+        price = menuitem.price;
+        category = menuitem.category;
+    }
+    return *this;
+}
+
+// Move assignment
+// Replaces this item's attributes, taking over the given item's strings.
+MenuItem& MenuItem::operator=(MenuItem&& menuitem) noexcept {
+    if (this != &menuitem) {
+        id = menuitem.id;
+        name = std::move(menuitem.name);
+        description = std::move(menuitem.description);
+        price = menuitem.price;
+        category = std::move(menuitem.category);
+    }
+    return *this;
 }
 
 string MenuItem::display() {
@@ -76,18 +122,26 @@ double MenuItem::getPrice() const {
     return price;
 }
 
+// Getter for the category
+// Returns the menu category of the item.
+string MenuItem::getCategory() const {
+    return category;
+}
+
 // Setter method to set menu item properties
-// Sets the menu item's ID (using a static nextId counter), name, description, 
-// and price. After setting, it outputs a success message in red.
+// Sets the menu item's ID (using a static nextId counter), name, description,
+// and price. After setting, it logs the new item at debug level.
 void MenuItem::setMenuItem(const string& newName, const string& newDescription, double newPrice) {
-    id = nextId;         // Assign the current ID and increment nextId for the next item
-    nextId++;            // Increment the static nextId for uniqueness
+    id = nextId.fetch_add(1, memory_order_relaxed); // Take the next ID without a lock
     name = newName;      // Set the name
     description = newDescription; // Set the description
     price = newPrice;    // Set the price
+    LOG_DEBUG("Menu item " << id << " created: " << name);
+}
 
-    // Print a success message in red
-    cout << "\033[1;31m";   // Set the text to red
-    cout << "Menu item created successfully!" << endl; // Success message
-    cout << "\033[0m";       // Reset the text color to default
+// Moves the ID counter past restored IDs
+void MenuItem::reserveIdsThrough(int id) {
+    int next = nextId.load(memory_order_relaxed);
+    while (next <= id && !nextId.compare_exchange_weak(next, id + 1, memory_order_relaxed)) {
+    }
 }
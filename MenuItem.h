@@ -3,6 +3,7 @@
 #ifndef MENUITEM_H
 #define MENUITEM_H
 
+#include <atomic>
 #include <iostream>
 #include <string>
 using namespace std;
@@ -15,7 +16,8 @@ class MenuItem {
 public:
     /*------------------------------------------------------------------------*
      *  MenuItem                                                              *
-     *  Default constructor. Initializes an empty MenuItem object.            *
+     *  Default constructor. Initializes an empty MenuItem object with ID 0;  *
+     *  it does not use up an ID.                                             *
      *------------------------------------------------------------------------*/
     MenuItem();
 
@@ -29,6 +31,17 @@ public:
      *------------------------------------------------------------------------*/
     MenuItem(string &name, string &description, double price);
 
+    /*------------------------------------------------------------------------*
+     *  MenuItem                                                              *
+     *  Restoring constructor. Rebuilds a previously created item with its    *
+     *  original ID, without drawing a new one or printing a message. An     *
+     *  empty category means the item's name is its category.                *
+     *                                                                        *
+     *  Precondition:  id was assigned to this item when it was created.      *
+     *  Postcondition: The MenuItem object holds exactly the given data.      *
+     *------------------------------------------------------------------------*/
+    MenuItem(int id, const string &name, const string &description, double price, const string &category = "");
+
     /*------------------------------------------------------------------------*
      *  MenuItem                                                              *
      *  Copy constructor. Creates a new MenuItem object as a copy of          *
@@ -40,6 +53,28 @@ public:
      *------------------------------------------------------------------------*/
     MenuItem(const MenuItem &menuitem);
 
+    /*------------------------------------------------------------------------*
+     *  MenuItem                                                              *
+     *  Move constructor. Takes over the strings of another MenuItem instead  *
+     *  of copying them.                                                      *
+     *                                                                        *
+     *  Precondition:  menuitem is a valid MenuItem object.                   *
+     *  Postcondition: This object holds the data of menuitem, which is left  *
+     *                 valid but unspecified.                                 *
+     *------------------------------------------------------------------------*/
+    MenuItem(MenuItem &&menuitem) noexcept;
+
+    /*------------------------------------------------------------------------*
+     *  operator=                                                             *
+     *  Copy and move assignment.                                             *
+     *                                                                        *
+     *  Precondition:  menuitem is a valid MenuItem object.                   *
+     *  Postcondition: This object holds the same data as menuitem.           *
+     *------------------------------------------------------------------------*/
+    MenuItem &operator=(const MenuItem &menuitem);
+
+    MenuItem &operator=(MenuItem &&menuitem) noexcept;
+
     /*------------------------------------------------------------------------*
      *  display                                                               *
      *  Displays the details of the MenuItem.                                 *
@@ -59,12 +94,26 @@ public:
 
     double getPrice() const;
 
+    // Menu category, such as Soft Drink or Salad; the kitchen station that prepares the item
+    string getCategory() const;
+
+    /*------------------------------------------------------------------------*
+     *  reserveIdsThrough                                                     *
+     *  Makes sure IDs up to id are never handed out again, after items      *
+     *  with those IDs were restored.                                         *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: The next new item gets an ID greater than id.          *
+     *------------------------------------------------------------------------*/
+    static void reserveIdsThrough(int id);
+
 private:
-    static int nextId;
+    static atomic<int> nextId; // next ID for a new item
     int id;
     string name;
     string description;
     double price;
+    string category;
 
     void setMenuItem(const string &name, const string &description, double price);
 };
@@ -1,28 +1,72 @@
 #include "Order.h"
 
 #include "Stack.h"
+#include "OrderIdGenerator.h"
+#include "Logger.h"
+
+#include <cmath>
 
 
 Order::Order() {
-    setOrder("", nullptr);
+    setOrder("", nullptr, 0);
+}
+
+Order::Order(const string &customerName, const MenuItem menuitems[], int count) {
+    setOrder(customerName, menuitems, count);
+}
+
+Order::Order(const string &customerName, const OrderLines &lines)
+    : orderId(OrderIdGenerator::next()), customerName(customerName), lines(lines), totalAmount(0), status(false) {
+    updateTotalAmount();
+}
+
+Order::Order(int64_t orderId, const string &customerName, const OrderLines &lines, double totalAmount, bool status)
+    : orderId(orderId), customerName(customerName), lines(lines), totalAmount(totalAmount), status(status) {
 }
 
-Order::Order(const string &customerName, const MenuItem menuitems[]) {
-    setOrder(customerName, menuitems);
+Order::Order(const Order &order)
+    : orderId(order.orderId), customerName(order.customerName), lines(order.lines),
+      totalAmount(order.totalAmount), status(order.status) {
 }
 
-Order::Order(const Order &order) {
-    customerName = order.customerName;
-    menuitems = order.menuitems;
+Order::Order(Order &&order) noexcept
+    : orderId(order.orderId), customerName(std::move(order.customerName)),
+      lines(std::move(order.lines)), totalAmount(order.totalAmount), status(order.status) {
 }
 
-string Order::toString() {
+Order &Order::operator=(const Order &order) {
+    if (this != &order) {
+        orderId = order.orderId;
+        customerName = order.customerName;
+        lines = order.lines;
+        totalAmount = order.totalAmount;
+        status = order.status;
+    }
+    return *this;
+}
+
+Order &Order::operator=(Order &&order) noexcept {
+    if (this != &order) {
+        orderId = order.orderId;
+        customerName = std::move(order.customerName);
+        lines = std::move(order.lines);
+        totalAmount = order.totalAmount;
+        status = order.status;
+    }
+    return *this;
+}
+
+template <typename Namer>
+string Order::format(Namer name) const {
     string orderDetails = "Order ID: " + to_string(orderId) + ", ";
     orderDetails += "Customer Name: " + customerName + "\n";
     orderDetails += "Items:\n";
-    for (int i = 0; i < menuitems.getSize(); i++) {
-        orderDetails += "-" + menuitems.getMenuItem(i).getName() +
-            " ($" + to_string(menuitems.getMenuItem(i).getPrice()) + ")\n";
+    for (const OrderLine &line : lines) {
+        orderDetails += "-" + name(line);
+        if (line.quantity != 1) {
+            orderDetails += " x" + to_string(line.quantity);
+        }
+        orderDetails += " ($" + to_string(line.unitPriceCents / 100.0) + ")\n";
     }
     orderDetails += "Total Amount: $" + to_string(totalAmount) + "\n";
     orderDetails += "Status: ";
@@ -31,50 +75,88 @@ string Order::toString() {
     return orderDetails;
 }
 
+string Order::toString() const {
+    return format([](const OrderLine &line) { return "Item " + to_string(line.menuItemId); });
+}
+
+string Order::toString(const DynamicArrayList &menu) const {
+    return format([&menu](const OrderLine &line) {
+        int index = menu.findById(line.menuItemId);
+        return index == -1 ? "Item " + to_string(line.menuItemId) : menu.getMenuItem(index).getName();
+    });
+}
+
 double Order::calculateTotalRevenue(const Stack& completedOrders) {
-    Stack newcompletedOrders = completedOrders;
-    double totalRevenue = 0;
-    int size = newcompletedOrders.getSize();
-    for (int i = 0; i < size; i++) {
-        Order order = newcompletedOrders.pop();
-        totalRevenue += order.getTotalAmount();
-    }
-    return totalRevenue;
+    // Summed on every core, a job per spilled segment and per chunk of nodes; nothing is copied or popped
+    return completedOrders.parallelReduce(0.0, [](const Order &order) { return order.getTotalAmount(); },
+                                          [](double left, double right) { return left + right; });
+}
+
+int64_t Order::getOrderId() const {
+    return orderId;
 }
 
 string Order::getCustomerName() const {
     return customerName;
 }
 
-DynamicArrayList Order::getMenuItems() const{
-    return menuitems;
+const OrderLines &Order::getLines() const {
+    return lines;
+}
+
+void Order::addItem(const MenuItem &item, int quantity) {
+    int64_t priceCents = llround(item.getPrice() * 100);
+    for (OrderLine &line : lines) {
+        if (line.menuItemId == item.getId() && line.unitPriceCents == priceCents) {
+            line.quantity += quantity;
+            updateTotalAmount();
+            return;
+        }
+    }
+    lines.push_back(OrderLine{item.getId(), quantity, priceCents});
+    updateTotalAmount();
 }
 
 double Order::getTotalAmount() const {
     return totalAmount;
 }
 
+void Order::updateTotalAmount() {
+    int64_t totalCents = 0;
+    for (const OrderLine &line : lines) {
+        totalCents += line.quantity * line.unitPriceCents;
+    }
+    totalAmount = totalCents / 100.0;
+}
+
+void Order::updateTotalAmount(const DynamicArrayList &menu) {
+    for (OrderLine &line : lines) {
+        int index = menu.findById(line.menuItemId);
+        if (index != -1) {
+            line.unitPriceCents = llround(menu.getMenuItem(index).getPrice() * 100);
+        }
+    }
+    updateTotalAmount();
+}
+
 bool Order::isCompleted() const {
     return status;
 }
 
 void Order::setCompleted() {
     status = true;
-    cout << "\033[1;31m"; // Set the text to the color red
-    cout << "Order is set as completed!" << endl;
-    cout << "\033[0m"; // Reset the text color
+    LOG_DEBUG("Order " << orderId << " completed");
 }
 
-void Order::setOrder(const string &newCustomerName, const MenuItem menuitems[]) {
-    orderId = time(0);
+void Order::setOrder(const string &newCustomerName, const MenuItem menuitems[], int count) {
+    orderId = OrderIdGenerator::next();
     customerName = newCustomerName;
-    for (int i = 0; i < 10; i++) {
-        this-> menuitems.add(menuitems[i]);
-        totalAmount += menuitems[i].getPrice();
+    lines.clear();
+    totalAmount = 0;
+    for (int i = 0; menuitems != nullptr && i < count; i++) {
+        addItem(menuitems[i]);
     }
     status = false;
-    cout << "\033[1;31m"; // Set the text to the color red
-    cout << "Order created successfully!" << endl;
-    cout << "\033[0m"; // Reset the text color
+    LOG_DEBUG("Order " << orderId << " created");
 }
 
@@ -3,7 +3,9 @@
 
 #include "MenuItem.h"
 #include "DynamicArrayList.h"
+#include "SmallVector.h"
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <ctime>
@@ -12,9 +14,23 @@
 using namespace std;
 
 class Stack; // Forward declaration
+
+/*------------------------------------------------------------------------*
+ *  OrderLine                                                             *
+ *  One line of an order: which menu item, how many, and the unit price   *
+ *  it was sold at. Names and descriptions stay in the menu.              *
+ *------------------------------------------------------------------------*/
+struct OrderLine {
+    int32_t menuItemId; // ID of the ordered menu item
+    int32_t quantity; // units ordered
+    int64_t unitPriceCents; // price of one unit, in cents
+};
+
+typedef SmallVector<OrderLine, 8> OrderLines; // typical orders never touch the heap
+
 /*------------------------------------------------------------------------*
  *  Order                                                                 *
- *  Represents a customer's order with a list of menu items.              *
+ *  Represents a customer's order with a list of order lines.             *
  *------------------------------------------------------------------------*/
 class Order {
 public:
@@ -26,13 +42,34 @@ public:
 
     /*------------------------------------------------------------------------*
      *  Order                                                                 *
-     *  Parameterized constructor. Initializes an Order object with the       *
-     *  provided data.                                                        *
+     *  Parameterized constructor. Initializes an Order object with one line *
+     *  per given menu item.                                                  *
      *                                                                        *
-     *  Precondition:  id, customerName, and items are valid values.          *
+     *  Precondition:  menuitems points to count valid MenuItems.             *
      *  Postcondition: The Order object is created with the given data.       *
      *------------------------------------------------------------------------*/
-    Order(const string &customerName, const MenuItem menuitems[]);
+    Order(const string &customerName, const MenuItem menuitems[], int count);
+
+    /*------------------------------------------------------------------------*
+     *  Order                                                                 *
+     *  Parameterized constructor. Builds the order around already filled     *
+     *  order lines.                                                          *
+     *                                                                        *
+     *  Precondition:  lines holds the lines of the order.                    *
+     *  Postcondition: The Order object holds lines and its total is the     *
+     *                 sum of quantity times unit price.                      *
+     *------------------------------------------------------------------------*/
+    Order(const string &customerName, const OrderLines &lines);
+
+    /*------------------------------------------------------------------------*
+     *  Order                                                                 *
+     *  Restoring constructor. Rebuilds an order read back from storage with  *
+     *  its original ID, total and status.                                    *
+     *                                                                        *
+     *  Precondition:  The values were taken from an existing order.          *
+     *  Postcondition: The Order object holds exactly the given data.         *
+     *------------------------------------------------------------------------*/
+    Order(int64_t orderId, const string &customerName, const OrderLines &lines, double totalAmount, bool status);
 
     /*------------------------------------------------------------------------*
      *  Order                                                                 *
@@ -45,6 +82,30 @@ public:
      * -----------------------------------------------------------------------*/
     Order(const Order &order);
 
+    /*------------------------------------------------------------------------*
+     *  Order                                                                 *
+     *  Move constructor. Takes over the customer name of another Order. Its *
+     *  lines are copied with a single memcpy while they fit inline, and     *
+     *  their heap buffer is taken over once they have spilled.              *
+     *                                                                        *
+     *  Precondition:  order is a valid Order object.                         *
+     *  Postcondition: This object holds order's data; order is left valid   *
+     *                 but empty.                                             *
+     *------------------------------------------------------------------------*/
+    Order(Order &&order) noexcept;
+
+    /*------------------------------------------------------------------------*
+     *  operator=                                                             *
+     *  Copy and move assignment, with the same semantics as the copy and     *
+     *  move constructors.                                                    *
+     *                                                                        *
+     *  Precondition:  order is a valid Order object.                         *
+     *  Postcondition: This object holds the data of order.                   *
+     *------------------------------------------------------------------------*/
+    Order &operator=(const Order &order);
+
+    Order &operator=(Order &&order) noexcept;
+
     /*------------------------------------------------------------------------*
      *  display                                                               *
      *  Displays the details of the order.                                    *
@@ -52,7 +113,17 @@ public:
      *  Precondition:  The Order object is initialized.                       *
      *  Postcondition: The details of the order are printed to the console.   *
      *------------------------------------------------------------------------*/
-    string toString();
+    string toString() const;
+
+    /*------------------------------------------------------------------------*
+     *  toString                                                              *
+     *  Same as toString(), with each line's item name looked up in menu.     *
+     *  Items no longer on the menu are shown by their ID.                    *
+     *                                                                        *
+     *  Precondition:  menu is a valid DynamicArrayList object.               *
+     *  Postcondition: The details of the order are returned.                 *
+     *------------------------------------------------------------------------*/
+    string toString(const DynamicArrayList &menu) const;
 
     /*------------------------------------------------------------------------*
      *  calculateTotalRevenue                                                 *
@@ -64,6 +135,15 @@ public:
      *------------------------------------------------------------------------*/
     static double calculateTotalRevenue(const Stack &completedOrders);
 
+    /*------------------------------------------------------------------------*
+     *  getOrderId                                                            *
+     *  Returns the unique identifier of the order (see OrderIdGenerator).    *
+     *                                                                        *
+     *  Precondition:  The Order object is initialized.                       *
+     *  Postcondition: The id of the order is returned.                       *
+     *------------------------------------------------------------------------*/
+    int64_t getOrderId() const;
+
     /*------------------------------------------------------------------------*
      *  getCustomerName                                                       *
      *  Returns the name of the customer who placed the order.                *
@@ -75,13 +155,23 @@ public:
     string getCustomerName() const;
 
     /*------------------------------------------------------------------------*
-     *  getMenuItems                                                          *
-     *  Returns the list of menu items in the order.                          *
+     *  getLines                                                              *
+     *  Returns the lines of the order.                                       *
      *                                                                        *
      *  Precondition:  The Order object is initialized.                       *
-     *  Postcondition: The list of menu items in the order is returned.       *
+     *  Postcondition: The lines of the order are returned.                   *
+     *------------------------------------------------------------------------*/
+    const OrderLines &getLines() const;
+
+    /*------------------------------------------------------------------------*
+     *  addItem                                                               *
+     *  Adds quantity units of a menu item at its current price, on the line *
+     *  of that item if the order already has one.                            *
+     *                                                                        *
+     *  Precondition:  quantity > 0.                                          *
+     *  Postcondition: The item is on the order and the total includes it.    *
      *------------------------------------------------------------------------*/
-    DynamicArrayList getMenuItems() const;
+    void addItem(const MenuItem &item, int quantity = 1);
 
     /*------------------------------------------------------------------------*
      *  getTotalAmount                                                        *
@@ -92,6 +182,27 @@ public:
      *------------------------------------------------------------------------*/
     double getTotalAmount() const;
 
+    /*------------------------------------------------------------------------*
+     *  updateTotalAmount                                                     *
+     *  Recomputes the total amount from the order's lines.                   *
+     *                                                                        *
+     *  Precondition:  The Order object is initialized.                       *
+     *  Postcondition: The total amount is the sum of quantity times unit     *
+     *                 price over the lines.                                  *
+     *------------------------------------------------------------------------*/
+    void updateTotalAmount();
+
+    /*------------------------------------------------------------------------*
+     *  updateTotalAmount                                                     *
+     *  Reprices the lines with the current prices in menu, then recomputes   *
+     *  the total. Items no longer on the menu keep the price they were       *
+     *  ordered at.                                                           *
+     *                                                                        *
+     *  Precondition:  menu is a valid DynamicArrayList object.               *
+     *  Postcondition: The lines and total reflect the prices in menu.        *
+     *------------------------------------------------------------------------*/
+    void updateTotalAmount(const DynamicArrayList &menu);
+
     /*------------------------------------------------------------------------*
      *  isCompleted                                                           *
      *  Returns whether the order is completed or not.                        *
@@ -112,11 +223,11 @@ public:
     void setCompleted();
 
 private:
-    int orderId; // Unique identifier for the order
+    int64_t orderId; // Unique identifier for the order, from OrderIdGenerator
 
     string customerName; // Name of the customer who placed the order
 
-    DynamicArrayList menuitems; // List of menu items in the order
+    OrderLines lines; // Items of the order, by menu item ID
 
     double totalAmount; // Total amount of the order
 
@@ -126,10 +237,14 @@ private:
      *  setOrder                                                              *
      *  Initializes the order with the provided data.                         *
      *                                                                        *
-     *  Precondition:  customerName and menuitems are valid values.           *
+     *  Precondition:  menuitems points to count valid MenuItems.             *
      *  Postcondition: The Order object is created with the given data.       *
      *------------------------------------------------------------------------*/
-    void setOrder(const string &customerName, const MenuItem menuitems[]);
+    void setOrder(const string &customerName, const MenuItem menuitems[], int count);
+
+    // Formats the order, naming each line's item with name(line)
+    template <typename Namer>
+    string format(Namer name) const;
 };
 
 #endif
@@ -0,0 +1,212 @@
+#include "OrderCodec.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    void putFixed(string &out, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; i++) {
+            out += (char) (uint8_t) (value >> (8 * i));
+        }
+    }
+
+    void putVarint(string &out, uint64_t value) {
+        while (value >= 0x80) {
+            out += (char) (uint8_t) (value | 0x80);
+            value >>= 7;
+        }
+        out += (char) (uint8_t) value;
+    }
+
+    void putSigned(string &out, int64_t value) {
+        putVarint(out, ((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
+    }
+
+    uint64_t getFixed(const char *data, int bytes) {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++) {
+            value |= (uint64_t) (uint8_t) data[i] << (8 * i);
+        }
+        return value;
+    }
+
+    // Decodes a varint at position, which is moved past it
+    uint64_t getVarint(const char *&position, const char *end) {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (position == end) {
+                throw runtime_error("Truncated order batch");
+            }
+            uint8_t byte = (uint8_t) *position++;
+            value |= (uint64_t) (byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw runtime_error("Corrupt order batch");
+    }
+
+    int64_t getSigned(const char *&position, const char *end) {
+        uint64_t value = getVarint(position, end);
+        return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+    }
+}
+
+void OrderBatchWriter::add(const Order &order) {
+    const OrderLines &lines = order.getLines();
+    const string &customerName = order.getCustomerName();
+    record.clear();
+    record += (char) (order.isCompleted() ? 1 : 0);
+    putVarint(record, (uint64_t) order.getOrderId());
+    putVarint(record, intern(customerName));
+    putVarint(record, customerName.size());
+    putSigned(record, llround(order.getTotalAmount() * 100));
+    putVarint(record, lines.size());
+    for (const OrderLine &line : lines) {
+        putVarint(record, (uint32_t) line.menuItemId);
+        putVarint(record, (uint32_t) line.quantity);
+        putSigned(record, line.unitPriceCents);
+    }
+    putVarint(records, record.size());
+    records += record;
+    count++;
+}
+
+string OrderBatchWriter::finish() {
+    string batch;
+    batch.reserve(headerSize + records.size() + strings.size());
+    putFixed(batch, magic, 4);
+    putFixed(batch, version, 1);
+    putFixed(batch, 0, 3);
+    putFixed(batch, count, 4);
+    putFixed(batch, headerSize + records.size(), 4);
+    batch += records;
+    batch += strings;
+
+    records.clear();
+    strings.clear();
+    offsets.clear();
+    count = 0;
+    return batch;
+}
+
+string OrderBatchWriter::encode(const Order &order) {
+    OrderBatchWriter writer;
+    writer.add(order);
+    return writer.finish();
+}
+
+uint32_t OrderBatchWriter::intern(const string &value) {
+    auto found = offsets.find(value);
+    if (found != offsets.end()) {
+        return found->second;
+    }
+    uint32_t offset = (uint32_t) strings.size();
+    strings += value;
+    offsets.emplace(value, offset);
+    return offset;
+}
+
+OrderView::LineIterator::LineIterator(const char *position, const char *end, uint32_t remaining)
+    : position(position), end(end), remaining(remaining), line() {
+    if (remaining > 0) {
+        decode();
+    }
+}
+
+OrderView::LineIterator &OrderView::LineIterator::operator++() {
+    if (--remaining > 0) {
+        decode();
+    }
+    return *this;
+}
+
+void OrderView::LineIterator::decode() {
+    line.menuItemId = (int32_t) getVarint(position, end);
+    line.quantity = (int32_t) getVarint(position, end);
+    line.unitPriceCents = getSigned(position, end);
+}
+
+OrderView::OrderView(const char *record, const char *end, string_view strings) : recordEnd(end) {
+    if (record == end) {
+        throw runtime_error("Truncated order batch");
+    }
+    completed = (*record++ & 1) != 0;
+    orderId = (int64_t) getVarint(record, end);
+    uint64_t nameOffset = getVarint(record, end);
+    uint64_t nameLength = getVarint(record, end);
+    if (nameOffset > strings.size() || nameLength > strings.size() - nameOffset) {
+        throw runtime_error("Corrupt order batch");
+    }
+    customerName = strings.substr(nameOffset, nameLength);
+    totalCents = getSigned(record, end);
+    uint64_t count = getVarint(record, end);
+    if (count > (uint64_t) (end - record)) { // a line takes at least a byte
+        throw runtime_error("Corrupt order batch");
+    }
+    lineCount = (uint32_t) count;
+    lines = record;
+}
+
+Order OrderView::toOrder() const {
+    OrderLines decoded;
+    decoded.reserve(lineCount);
+    for (const OrderLine &line : *this) {
+        decoded.push_back(line);
+    }
+    return Order(orderId, string(customerName), decoded, totalCents / 100.0, completed);
+}
+
+OrderBatchView::Iterator::Iterator(const char *position, const char *end, string_view strings, uint32_t remaining)
+    : position(position), end(end), strings(strings), remaining(remaining) {
+}
+
+OrderView OrderBatchView::Iterator::operator*() const {
+    const char *record = position;
+    uint64_t size = getVarint(record, end);
+    if (size > (uint64_t) (end - record)) {
+        throw runtime_error("Truncated order batch");
+    }
+    return OrderView(record, record + size, strings);
+}
+
+OrderBatchView::Iterator &OrderBatchView::Iterator::operator++() {
+    uint64_t size = getVarint(position, end);
+    if (size > (uint64_t) (end - position)) {
+        throw runtime_error("Truncated order batch");
+    }
+    position += size;
+    remaining--;
+    return *this;
+}
+
+OrderBatchView::OrderBatchView(const char *data, size_t size) {
+    if (size < OrderBatchWriter::headerSize) {
+        throw runtime_error("Truncated order batch");
+    }
+    if (getFixed(data, 4) != OrderBatchWriter::magic) {
+        throw runtime_error("Not an order batch");
+    }
+    if (getFixed(data + 4, 1) != OrderBatchWriter::version) {
+        throw runtime_error("Unsupported order batch version " + to_string(getFixed(data + 4, 1)));
+    }
+    count = (uint32_t) getFixed(data + 8, 4);
+    uint64_t stringsOffset = getFixed(data + 12, 4);
+    if (stringsOffset < OrderBatchWriter::headerSize || stringsOffset > size) {
+        throw runtime_error("Corrupt order batch");
+    }
+    records = data + OrderBatchWriter::headerSize;
+    recordsEnd = data + stringsOffset;
+    if (count > (uint64_t) (recordsEnd - records)) { // an order takes at least a byte
+        throw runtime_error("Corrupt order batch");
+    }
+    strings = string_view(recordsEnd, size - stringsOffset);
+}
+
+OrderBatchView::Iterator OrderBatchView::begin() const {
+    return Iterator(records, recordsEnd, strings, count);
+}
+
+OrderBatchView::Iterator OrderBatchView::end() const {
+    return Iterator(recordsEnd, recordsEnd, strings, 0);
+}
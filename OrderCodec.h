@@ -0,0 +1,206 @@
+#ifndef ORDERCODEC_H
+#define ORDERCODEC_H
+
+#include "Order.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  Order batch format, version 1                                         *
+ *                                                                        *
+ *  A batch holds any number of orders. All fields are little-endian;    *
+ *  "varint" is LEB128 and signed values are zigzag-encoded first.        *
+ *                                                                        *
+ *    header   u32 magic "ORDB", u8 version, u8 reserved, u16 reserved,   *
+ *             u32 order count, u32 byte offset of the string table       *
+ *    orders   per order: varint size of the rest of the record,          *
+ *             u8 flags (bit 0: completed), varint order ID,              *
+ *             varint customer name offset and length in the string      *
+ *             table, signed varint total in cents, varint line count,   *
+ *             then per line varint menu item ID, varint quantity and    *
+ *             signed varint unit price in cents                          *
+ *    strings  the customer names, each stored once per batch             *
+ *------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------*
+ *  OrderBatchWriter                                                      *
+ *  Encodes orders into a batch.                                          *
+ *------------------------------------------------------------------------*/
+class OrderBatchWriter {
+public:
+    static const uint32_t magic = 0x4244524F; // "ORDB"
+    static const uint8_t version = 1;
+    static const size_t headerSize = 16;
+
+    // Appends order to the batch
+    void add(const Order &order);
+
+    // Orders added since the last finish
+    uint32_t getCount() const { return count; }
+
+    /*------------------------------------------------------------------------*
+     *  finish                                                                *
+     *  Returns the encoded batch and starts a new, empty one.                *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: getCount() is 0.                                       *
+     *------------------------------------------------------------------------*/
+    string finish();
+
+    // Encodes a batch holding just order
+    static string encode(const Order &order);
+
+private:
+    string records; // encoded orders
+    string strings; // string table
+    unordered_map<string, uint32_t> offsets; // string -> offset in the table
+    string record; // scratch space for the order being added
+    uint32_t count = 0; // orders in records
+
+    // Offset of value in the string table, adding it the first time
+    uint32_t intern(const string &value);
+};
+
+/*------------------------------------------------------------------------*
+ *  OrderView                                                             *
+ *  Read-only view of one encoded order. Nothing is copied: the customer *
+ *  name points into the batch and lines are decoded as they are         *
+ *  iterated, so the batch must outlive the view.                         *
+ *------------------------------------------------------------------------*/
+class OrderView {
+public:
+    /*------------------------------------------------------------------------*
+     *  LineIterator                                                          *
+     *  Input iterator decoding the lines of an order one at a time.          *
+     *------------------------------------------------------------------------*/
+    class LineIterator {
+    public:
+        typedef input_iterator_tag iterator_category;
+        typedef OrderLine value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const OrderLine *pointer;
+        typedef const OrderLine &reference;
+
+        LineIterator(const char *position, const char *end, uint32_t remaining);
+
+        const OrderLine &operator*() const { return line; }
+
+        const OrderLine *operator->() const { return &line; }
+
+        LineIterator &operator++();
+
+        bool operator==(const LineIterator &other) const { return remaining == other.remaining; }
+
+        bool operator!=(const LineIterator &other) const { return remaining != other.remaining; }
+
+    private:
+        const char *position; // next line to decode
+        const char *end; // end of the order's record
+        uint32_t remaining; // lines not yet passed, including the current one
+        OrderLine line; // the current line
+
+        void decode();
+    };
+
+    OrderView(const char *record, const char *end, string_view strings);
+
+    int64_t getOrderId() const { return orderId; }
+
+    string_view getCustomerName() const { return customerName; }
+
+    int64_t getTotalCents() const { return totalCents; }
+
+    bool isCompleted() const { return completed; }
+
+    uint32_t getLineCount() const { return lineCount; }
+
+    LineIterator begin() const { return LineIterator(lines, recordEnd, lineCount); }
+
+    LineIterator end() const { return LineIterator(recordEnd, recordEnd, 0); }
+
+    // Builds an Order holding the same data
+    Order toOrder() const;
+
+private:
+    int64_t orderId; // order ID
+    string_view customerName; // name inside the string table
+    int64_t totalCents; // order total
+    bool completed; // status
+    uint32_t lineCount; // number of lines
+    const char *lines; // first encoded line
+    const char *recordEnd; // end of the record
+};
+
+/*------------------------------------------------------------------------*
+ *  OrderBatchView                                                        *
+ *  Read-only view of an encoded batch. The header is checked up front   *
+ *  and every field is bounds-checked as it is decoded, so a batch that  *
+ *  is truncated, corrupt or of another version throws runtime_error     *
+ *  instead of being misread.                                             *
+ *------------------------------------------------------------------------*/
+class OrderBatchView {
+public:
+    /*------------------------------------------------------------------------*
+     *  Iterator                                                              *
+     *  Forward iterator over the orders of a batch. Skipping an order costs *
+     *  one varint read, whatever its number of lines.                        *
+     *------------------------------------------------------------------------*/
+    class Iterator {
+    public:
+        typedef input_iterator_tag iterator_category;
+        typedef OrderView value_type;
+        typedef ptrdiff_t difference_type;
+        typedef void pointer;
+        typedef OrderView reference; // views are made on the fly
+
+        Iterator(const char *position, const char *end, string_view strings, uint32_t remaining);
+
+        OrderView operator*() const;
+
+        Iterator &operator++();
+
+        bool operator==(const Iterator &other) const { return remaining == other.remaining; }
+
+        bool operator!=(const Iterator &other) const { return remaining != other.remaining; }
+
+    private:
+        const char *position; // size prefix of the current order
+        const char *end; // end of the order records
+        string_view strings; // string table
+        uint32_t remaining; // orders not yet passed, including the current one
+    };
+
+    /*------------------------------------------------------------------------*
+     *  OrderBatchView                                                        *
+     *  Parameterized constructor. Reads the header of the batch in data.     *
+     *                                                                        *
+     *  Precondition:  data stays valid while the view and its orders are    *
+     *                 used.                                                  *
+     *  Postcondition: Throws runtime_error if data is not a version 1 batch.*
+     *------------------------------------------------------------------------*/
+    OrderBatchView(const char *data, size_t size);
+
+    explicit OrderBatchView(string_view bytes) : OrderBatchView(bytes.data(), bytes.size()) {
+    }
+
+    uint32_t size() const { return count; }
+
+    Iterator begin() const;
+
+    Iterator end() const;
+
+private:
+    const char *records; // first order record
+    const char *recordsEnd; // start of the string table
+    string_view strings; // string table
+    uint32_t count; // orders in the batch
+};
+
+#endif //ORDERCODEC_H
@@ -0,0 +1,153 @@
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "OrderCodec.h"
+#include "TestCheck.h"
+#include "TestOrders.h"
+
+using namespace std;
+
+namespace {
+    // Every field of the orders must survive the trip
+    bool sameOrder(const Order &expected, const Order &actual) {
+        if (expected.getOrderId() != actual.getOrderId() || expected.getCustomerName() != actual.getCustomerName()
+            || expected.getTotalAmount() != actual.getTotalAmount()
+            || expected.isCompleted() != actual.isCompleted()
+            || expected.getLines().size() != actual.getLines().size()) {
+            return false;
+        }
+        for (size_t i = 0; i < expected.getLines().size(); i++) {
+            const OrderLine &a = expected.getLines()[i];
+            const OrderLine &b = actual.getLines()[i];
+            if (a.menuItemId != b.menuItemId || a.quantity != b.quantity || a.unitPriceCents != b.unitPriceCents) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    vector<Order> sampleOrders() {
+        vector<Order> orders;
+        orders.push_back(testOrder(42, "Ada", 2, 899));
+        orders.push_back(testOrder(INT64_MAX, "Grace", 20, 125, true)); // more lines than fit inline
+        orders.push_back(testOrder(7, "Ada", 0)); // shares its name with the first order
+        orders.push_back(testOrder(-3, "", 2, -549, true)); // negative values are zigzag-encoded
+        return orders;
+    }
+
+    void testRoundTrip() {
+        vector<Order> orders = sampleOrders();
+        OrderBatchWriter writer;
+        for (const Order &order : orders) {
+            writer.add(order);
+        }
+        CHECK(writer.getCount() == orders.size());
+        string batch = writer.finish();
+        CHECK(writer.getCount() == 0);
+
+        OrderBatchView view(batch);
+        CHECK(view.size() == orders.size());
+        size_t index = 0;
+        for (OrderView order : view) {
+            CHECK(index < orders.size() && sameOrder(orders[index], order.toOrder()));
+            index++;
+        }
+        CHECK(index == orders.size());
+
+        string encoded = OrderBatchWriter::encode(orders[1]); // views point into their bytes
+        OrderBatchView single(encoded);
+        CHECK(single.size() == 1 && sameOrder(orders[1], (*single.begin()).toOrder()));
+
+        string nothing = OrderBatchWriter().finish();
+        OrderBatchView empty(nothing);
+        CHECK(empty.size() == 0 && empty.begin() == empty.end());
+    }
+
+    // Decodes every order of a batch completely
+    void decodeAll(const string &batch) {
+        for (OrderView order : OrderBatchView(batch)) {
+            order.toOrder();
+        }
+    }
+
+    void testTruncated() {
+        OrderBatchWriter writer;
+        for (const Order &order : sampleOrders()) {
+            writer.add(order);
+        }
+        string batch = writer.finish();
+        decodeAll(batch);
+        for (size_t size = 0; size < batch.size(); size++) {
+            CHECK_THROWS(decodeAll(batch.substr(0, size)), runtime_error);
+        }
+    }
+
+    // Overwrites a little-endian u32 of the header
+    void putFixed(string &batch, size_t offset, uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            batch[offset + i] = (char) (value >> (8 * i));
+        }
+    }
+
+    void testCorrupt() {
+        OrderBatchWriter writer;
+        for (const Order &order : sampleOrders()) {
+            writer.add(order);
+        }
+        const string batch = writer.finish();
+
+        string wrongMagic = batch;
+        wrongMagic[0] ^= 1;
+        CHECK_THROWS(decodeAll(wrongMagic), runtime_error);
+
+        string wrongVersion = batch;
+        wrongVersion[4] = 2;
+        CHECK_THROWS(decodeAll(wrongVersion), runtime_error);
+
+        string hugeCount = batch; // must be rejected before anything is sized by it
+        putFixed(hugeCount, 8, UINT32_MAX);
+        CHECK_THROWS(decodeAll(hugeCount), runtime_error);
+
+        string stringsOutside = batch;
+        putFixed(stringsOutside, 12, (uint32_t) batch.size() + 1);
+        CHECK_THROWS(decodeAll(stringsOutside), runtime_error);
+
+        string stringsInHeader = batch;
+        putFixed(stringsInHeader, 12, 4);
+        CHECK_THROWS(decodeAll(stringsInHeader), runtime_error);
+
+        // A single order claiming billions of lines. Its record is: size, flags, ID 1, name offset 0,
+        // name length 3, total 100 cents (zigzag 0xc8 0x01), line count 1, then the line
+        string hugeLines = OrderBatchWriter::encode(testOrder(1, "Ada", 1, 100));
+        size_t lineCount = OrderBatchWriter::headerSize + 7;
+        CHECK(hugeLines[lineCount] == 1);
+        hugeLines.replace(lineCount, 1, "\xff\xff\xff\xff\x0f");
+        hugeLines[OrderBatchWriter::headerSize] += 4; // keep the record size and the string table in step
+        putFixed(hugeLines, 12, (uint32_t) (hugeLines.size() - 3));
+        CHECK_THROWS(decodeAll(hugeLines), runtime_error);
+
+        // Random damage must fail cleanly or decode to something, never crash
+        uint32_t state = 12345;
+        for (int round = 0; round < 2000; round++) {
+            string damaged = batch;
+            for (int flips = 0; flips < 4; flips++) {
+                state = state * 1664525 + 1013904223;
+                damaged[OrderBatchWriter::headerSize + state % (damaged.size() - OrderBatchWriter::headerSize)] ^=
+                    (char) (1 + (state >> 24) % 255);
+            }
+            try {
+                decodeAll(damaged);
+            } catch (const runtime_error &) {
+            }
+        }
+    }
+}
+
+int main() {
+    testRoundTrip();
+    testTruncated();
+    testCorrupt();
+    return testResult();
+}
@@ -0,0 +1,111 @@
+#include "OrderIdGenerator.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+    const int64_t epochMilliseconds = 1704067200000; // 2024-01-01T00:00:00Z
+    const uint32_t sequencesPerTick = 1u << OrderIdGenerator::sequenceBits;
+    const int slotCount = 1 << OrderIdGenerator::slotBits;
+
+    // Clock of one thread slot; only the thread owning the slot touches it
+    struct alignas(64) SlotClock {
+        int64_t tick = 0; // millisecond of the last ID handed out
+        uint32_t sequence = sequencesPerTick; // sequences of tick used so far
+    };
+
+    SlotClock clocks[slotCount];
+    atomic<uint64_t> freeSlots(~0ull); // bit i set while slot i has no owner
+    atomic<int> terminalNumber(0);
+
+    // Owns a slot for the lifetime of a thread. The slot's clock outlives the
+    // owner, so the next thread to claim it cannot hand out the same IDs again.
+    struct SlotClaim {
+        int slot;
+
+        SlotClaim() {
+            uint64_t free = freeSlots.load(memory_order_relaxed);
+            do {
+                if (free == 0) {
+                    throw runtime_error("More than 64 threads are generating order IDs.");
+                }
+                slot = __builtin_ctzll(free);
+            } while (!freeSlots.compare_exchange_weak(free, free & ~(1ull << slot), memory_order_acquire));
+        }
+
+        ~SlotClaim() {
+            freeSlots.fetch_or(1ull << slot, memory_order_release);
+        }
+    };
+
+    int64_t now() {
+        using namespace chrono;
+        return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count() - epochMilliseconds;
+    }
+
+    // Moves a slot's clock to the current millisecond if the wall clock is ahead
+    // of it; a clock that was set back or ran ahead keeps counting from its tick
+    void catchUp(SlotClock &clock) {
+        int64_t current = now();
+        if (current > clock.tick) {
+            clock.tick = current;
+            clock.sequence = 0;
+        }
+    }
+}
+
+int64_t OrderIdRange::operator[](size_t index) const {
+    assert(index < count);
+    uint64_t position = firstSequence + index;
+    return OrderIdGenerator::compose(prefix, firstTick + (int64_t) (position / sequencesPerTick),
+                                     (uint32_t) (position % sequencesPerTick));
+}
+
+int64_t OrderIdGenerator::next() {
+    int owned = slot();
+    SlotClock &clock = clocks[owned];
+    catchUp(clock);
+    if (clock.sequence == sequencesPerTick) {
+        clock.tick++; // this millisecond is used up: borrow the next one
+        clock.sequence = 0;
+    }
+    int64_t prefix = ((int64_t) terminalNumber.load(memory_order_relaxed) << slotBits) | owned;
+    return compose(prefix, clock.tick, clock.sequence++);
+}
+
+OrderIdRange OrderIdGenerator::reserve(size_t count) {
+    int owned = slot();
+    SlotClock &clock = clocks[owned];
+    catchUp(clock);
+    int64_t prefix = ((int64_t) terminalNumber.load(memory_order_relaxed) << slotBits) | owned;
+    OrderIdRange range(prefix, clock.tick, clock.sequence, count);
+    if (count == 0) {
+        return range;
+    }
+
+    // Skip the clock past the range; the last millisecond may still have sequences left
+    uint64_t end = clock.sequence + count;
+    clock.tick += (int64_t) ((end - 1) / sequencesPerTick);
+    clock.sequence = (uint32_t) ((end - 1) % sequencesPerTick) + 1;
+    return range;
+}
+
+void OrderIdGenerator::setTerminal(int terminal) {
+    assert(terminal >= 0 && terminal < (1 << terminalBits));
+    terminalNumber.store(terminal, memory_order_relaxed);
+}
+
+int64_t OrderIdGenerator::timeOf(int64_t id) {
+    return (id >> (sequenceBits + slotBits + terminalBits)) + epochMilliseconds;
+}
+
+int OrderIdGenerator::slot() {
+    thread_local SlotClaim claim;
+    return claim.slot;
+}
+
+int64_t OrderIdGenerator::compose(int64_t prefix, int64_t tick, uint32_t sequence) {
+    return (tick << (sequenceBits + slotBits + terminalBits)) | (prefix << sequenceBits) | sequence;
+}
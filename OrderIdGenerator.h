@@ -0,0 +1,95 @@
+#ifndef ORDERIDGENERATOR_H
+#define ORDERIDGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  OrderIdRange                                                          *
+ *  A block of order IDs reserved in one call, for bulk imports. The IDs  *
+ *  belong to the reserving terminal and thread slot and are increasing,  *
+ *  but not necessarily consecutive integers.                             *
+ *------------------------------------------------------------------------*/
+class OrderIdRange {
+public:
+    OrderIdRange(int64_t prefix, int64_t firstTick, uint32_t firstSequence, size_t count)
+        : prefix(prefix), firstTick(firstTick), firstSequence(firstSequence), count(count) {
+    }
+
+    // The index-th ID of the range
+    int64_t operator[](size_t index) const;
+
+    size_t size() const { return count; }
+
+private:
+    int64_t prefix; // terminal and thread slot bits shared by every ID
+    int64_t firstTick; // millisecond of the first ID
+    uint32_t firstSequence; // sequence of the first ID within that millisecond
+    size_t count; // IDs in the range
+};
+
+/*------------------------------------------------------------------------*
+ *  OrderIdGenerator                                                      *
+ *  Hands out 64-bit order IDs laid out, from the top bit down, as        *
+ *                                                                        *
+ *      0 | 41 bits milliseconds since 2024 | 6 bits terminal |           *
+ *          6 bits thread slot | 10 bits sequence                         *
+ *                                                                        *
+ *  so IDs sort roughly by creation time. Each thread claims one of 64    *
+ *  slots the first time it asks for an ID and keeps it until it exits;   *
+ *  a slot's clock and sequence are touched only by its owner, so         *
+ *  generating an ID takes no lock and shares no cache line with other    *
+ *  threads. When a thread uses up the 1024 sequences of a millisecond it *
+ *  moves on to the next millisecond instead of waiting for the clock.    *
+ *------------------------------------------------------------------------*/
+class OrderIdGenerator {
+public:
+    static const int sequenceBits = 10;
+    static const int slotBits = 6;
+    static const int terminalBits = 6;
+
+    /*------------------------------------------------------------------------*
+     *  next                                                                  *
+     *  Returns a new order ID.                                               *
+     *                                                                        *
+     *  Precondition:  At most 64 threads generate IDs at the same time.      *
+     *  Postcondition: The ID is larger than every ID this thread got before  *
+     *                 and differs from every ID any terminal generates.      *
+     *------------------------------------------------------------------------*/
+    static int64_t next();
+
+    /*------------------------------------------------------------------------*
+     *  reserve                                                               *
+     *  Reserves count IDs at once.                                           *
+     *                                                                        *
+     *  Precondition:  Same as next().                                        *
+     *  Postcondition: No other call returns an ID of the range.              *
+     *------------------------------------------------------------------------*/
+    static OrderIdRange reserve(size_t count);
+
+    /*------------------------------------------------------------------------*
+     *  setTerminal                                                           *
+     *  Sets the terminal number stored in every ID generated afterwards.     *
+     *  Terminals sharing the order files need different numbers.             *
+     *                                                                        *
+     *  Precondition:  0 <= terminal < 64.                                    *
+     *  Postcondition: New IDs carry terminal.                                *
+     *------------------------------------------------------------------------*/
+    static void setTerminal(int terminal);
+
+    // Milliseconds since the Unix epoch at which id was generated
+    static int64_t timeOf(int64_t id);
+
+private:
+    friend class OrderIdRange;
+
+    // The calling thread's slot, claimed on first use
+    static int slot();
+
+    // Builds an ID from its fields
+    static int64_t compose(int64_t prefix, int64_t tick, uint32_t sequence);
+};
+
+#endif //ORDERIDGENERATOR_H
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MenuItem.h"
+#include "OrderIdGenerator.h"
+#include "TestCheck.h"
+
+using namespace std;
+
+namespace {
+    int64_t nowMilliseconds() {
+        return chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // Sorts ids and reports whether any two are equal
+    bool allDistinct(vector<int64_t> &ids) {
+        sort(ids.begin(), ids.end());
+        return adjacent_find(ids.begin(), ids.end()) == ids.end();
+    }
+
+    // Threads drawing single IDs and whole ranges at once never meet, and each sees its own IDs rise
+    void testUniqueAcrossThreads() {
+        const int threadCount = 8;
+        const int perThread = 20000;
+        vector<vector<int64_t>> drawn(threadCount);
+        vector<bool> rising(threadCount, true);
+        int64_t before = nowMilliseconds();
+        vector<thread> threads;
+        for (int t = 0; t < threadCount; t++) {
+            threads.emplace_back([&drawn, &rising, t] {
+                for (int i = 0; i < perThread; i++) {
+                    int64_t id = OrderIdGenerator::next();
+                    rising[t] = rising[t] && (drawn[t].empty() || id > drawn[t].back());
+                    drawn[t].push_back(id);
+                }
+                OrderIdRange range = OrderIdGenerator::reserve(3000); // spans several milliseconds
+                for (size_t i = 0; i < range.size(); i++) {
+                    drawn[t].push_back(range[i]);
+                }
+                drawn[t].push_back(OrderIdGenerator::next());
+            });
+        }
+        for (thread &worker : threads) {
+            worker.join();
+        }
+        int64_t after = nowMilliseconds();
+
+        vector<int64_t> ids;
+        for (int t = 0; t < threadCount; t++) {
+            CHECK(rising[t]);
+            CHECK(drawn[t].back() > drawn[t][perThread + 2999]); // next() continues past the range
+            ids.insert(ids.end(), drawn[t].begin(), drawn[t].end());
+        }
+        CHECK(ids.size() == (size_t) threadCount * (perThread + 3001));
+        CHECK(allDistinct(ids));
+        CHECK(ids.front() > 0);
+        CHECK(OrderIdGenerator::timeOf(ids.front()) >= before - 1);
+        CHECK(OrderIdGenerator::timeOf(ids.back()) <= after + 1000); // runs ahead only when sequences run out
+    }
+
+    // The terminal number separates the IDs of terminals sharing the order files
+    void testTerminal() {
+        OrderIdGenerator::setTerminal(5);
+        int64_t id = OrderIdGenerator::next();
+        int shift = OrderIdGenerator::sequenceBits + OrderIdGenerator::slotBits;
+        CHECK(((id >> shift) & ((1 << OrderIdGenerator::terminalBits) - 1)) == 5);
+        OrderIdGenerator::setTerminal(0);
+    }
+
+    // New menu items get distinct IDs from any thread, above every restored ID
+    void testMenuItemIds() {
+        MenuItem::reserveIdsThrough(500);
+        vector<vector<int>> drawn(4);
+        vector<thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&drawn, t] {
+                string name = "Item";
+                string description = "Made on thread " + to_string(t);
+                for (int i = 0; i < 1000; i++) {
+                    drawn[t].push_back(MenuItem(name, description, 1.0).getId());
+                }
+            });
+        }
+        for (thread &worker : threads) {
+            worker.join();
+        }
+        vector<int64_t> ids;
+        for (const vector<int> &some : drawn) {
+            ids.insert(ids.end(), some.begin(), some.end());
+        }
+        CHECK(allDistinct(ids) && ids.front() > 500);
+    }
+}
+
+int main() {
+    testUniqueAcrossThreads();
+    testTerminal();
+    testMenuItemIds();
+    return testResult();
+}
@@ -0,0 +1,56 @@
+#ifndef ORDERLISTENER_H
+#define ORDERLISTENER_H
+
+#include "Order.h"
+
+#include <vector>
+
+/*------------------------------------------------------------------------*
+ *  OrderListener                                                         *
+ *  Observer of the order lifecycle. A Queue reports each order linked    *
+ *  into it, a Stack each order completed onto it. Callbacks run on the   *
+ *  thread that modified the container, while it is being modified, so    *
+ *  they must not touch that container.                                   *
+ *------------------------------------------------------------------------*/
+class OrderListener {
+public:
+    virtual ~OrderListener() = default;
+
+    // An order was added to a queue of active orders
+    virtual void onEnqueued(const Order &) {
+    }
+
+    // An order was moved onto the completed orders
+    virtual void onCompleted(const Order &) {
+    }
+};
+
+/*------------------------------------------------------------------------*
+ *  OrderListenerGroup                                                    *
+ *  Passes every event on to several listeners, in the order they were   *
+ *  added, so one container can feed e.g. the journal and the kitchen.    *
+ *------------------------------------------------------------------------*/
+class OrderListenerGroup : public OrderListener {
+public:
+    // listener must outlive the group or the containers it is attached to
+    void add(OrderListener *listener) {
+        listeners.push_back(listener);
+    }
+
+    void onEnqueued(const Order &order) override {
+        for (OrderListener *listener : listeners) {
+            listener->onEnqueued(order);
+        }
+    }
+
+    void onCompleted(const Order &order) override {
+        for (OrderListener *listener : listeners) {
+            listener->onCompleted(order);
+        }
+    }
+
+private:
+    vector<OrderListener *> listeners; // told in this order
+};
+
+#endif //ORDERLISTENER_H
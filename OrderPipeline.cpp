@@ -0,0 +1,123 @@
+#include "OrderPipeline.h"
+#include "Trace.h"
+
+#include <stdexcept>
+
+OrderPipeline::OrderPipeline(Stack &completedOrders, const MenuCatalog *catalog, int threadCount)
+    : executor(threadCount), completedOrders(completedOrders), catalog(catalog),
+      inFlight(0), completed(0), rejected(0) {
+}
+
+OrderPipeline::~OrderPipeline() {
+    /*------------------------------------------------------------*
+     *  ~OrderPipeline                                            *
+     *  Frames still in flight reference this object, so wait for *
+     *  them before the executor and counters are destroyed.      *
+     *------------------------------------------------------------*/
+    waitIdle();
+}
+
+void OrderPipeline::submit(Order &&order) {
+    /*------------------------------------------------------------*
+     *  submit                                                    *
+     *  Counts the order as in flight and starts its coroutine.   *
+     *  run() suspends at the first stage hop, so this returns    *
+     *  without doing any stage work on the caller's thread.      *
+     *------------------------------------------------------------*/
+    {
+        lock_guard<mutex> lock(idleMutex);
+        inFlight++;
+    }
+    run(std::move(order));
+}
+
+void OrderPipeline::waitIdle() {
+    unique_lock<mutex> lock(idleMutex);
+    idleCondition.wait(lock, [this] { return inFlight == 0; });
+}
+
+int OrderPipeline::getCompletedCount() const {
+    return completed.load();
+}
+
+int OrderPipeline::getRejectedCount() const {
+    return rejected.load();
+}
+
+OrderPipeline::DetachedTask OrderPipeline::run(Order order) {
+    /*------------------------------------------------------------*
+     *  run                                                       *
+     *  Builds the stage chain and awaits its last stage. Each    *
+     *  stage only starts when the next one awaits it.            *
+     *------------------------------------------------------------*/
+    try {
+        co_await persist(complete(fire(price(accept(std::move(order))))));
+        completed++;
+    } catch (const runtime_error &e) {
+        cerr << "Error: " << e.what() << endl;
+        rejected++;
+    }
+    finishOne();
+}
+
+Task<Order> OrderPipeline::accept(Order order) {
+    co_await executor.schedule();
+    TRACE_SPAN("OrderPipeline::accept");
+    TRACE_ORDER_STEP("accepted", order.getOrderId());
+    if (order.getLines().empty()) {
+        throw runtime_error("Order " + to_string(order.getOrderId()) + " has no items.");
+    }
+    co_return order;
+}
+
+Task<Order> OrderPipeline::price(Task<Order> input) {
+    Order order = co_await std::move(input);
+    co_await executor.schedule();
+    TRACE_SPAN("OrderPipeline::price");
+    TRACE_ORDER_STEP("priced", order.getOrderId());
+    if (catalog != nullptr) {
+        MenuCatalog::Snapshot menu = catalog->read(); // lock-free, even while the menu is edited
+        order.updateTotalAmount(*menu);
+    } else {
+        order.updateTotalAmount();
+    }
+    co_return order;
+}
+
+Task<Order> OrderPipeline::fire(Task<Order> input) {
+    Order order = co_await std::move(input);
+    co_await executor.schedule();
+    TRACE_SPAN("OrderPipeline::fire");
+    TRACE_ORDER_STEP("fired", order.getOrderId());
+    // Kitchen displays hear of the order from the KitchenFeed once persist puts it on the completed stack
+    co_return order;
+}
+
+Task<Order> OrderPipeline::complete(Task<Order> input) {
+    Order order = co_await std::move(input);
+    co_await executor.schedule();
+    TRACE_SPAN("OrderPipeline::complete");
+    TRACE_ORDER_STEP("ready", order.getOrderId());
+    order.setCompleted();
+    co_return order;
+}
+
+Task<int64_t> OrderPipeline::persist(Task<Order> input) {
+    Order order = co_await std::move(input);
+    co_await executor.schedule();
+    TRACE_SPAN("OrderPipeline::persist");
+    int64_t orderId = order.getOrderId();
+    {
+        lock_guard<mutex> lock(completedOrders.getAppendLock()); // station consumers may splice meanwhile
+        completedOrders.push(std::move(order));
+    }
+    co_return orderId;
+}
+
+void OrderPipeline::finishOne() {
+    lock_guard<mutex> lock(idleMutex);
+    inFlight--;
+    if (inFlight == 0) {
+        idleCondition.notify_all();
+    }
+}
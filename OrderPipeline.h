@@ -0,0 +1,194 @@
+#ifndef ORDERPIPELINE_H
+#define ORDERPIPELINE_H
+
+#include "Executor.h"
+#include "MenuCatalog.h"
+#include "Order.h"
+#include "Stack.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  Task                                                                  *
+ *  A lazily started coroutine producing one value of type T. The body    *
+ *  only runs once another coroutine co_awaits the task, and on finishing *
+ *  it resumes that awaiting coroutine directly (symmetric transfer).     *
+ *------------------------------------------------------------------------*/
+template <typename T>
+class Task {
+public:
+    struct promise_type {
+        optional<T> value; // Result set by co_return
+        exception_ptr error; // Exception that escaped the body, if any
+        coroutine_handle<> continuation; // Coroutine awaiting this task
+
+        Task get_return_object() {
+            return Task(coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+
+            coroutine_handle<> await_suspend(coroutine_handle<promise_type> handle) noexcept {
+                coroutine_handle<> next = handle.promise().continuation;
+                return next ? next : noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void return_value(T result) { value.emplace(std::move(result)); }
+
+        void unhandled_exception() { error = current_exception(); }
+    };
+
+    Task(Task &&task) noexcept : handle(exchange(task.handle, nullptr)) {
+    }
+
+    Task(const Task &task) = delete;
+
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    coroutine_handle<> await_suspend(coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle; // start the task's body now
+    }
+
+    T await_resume() {
+        if (handle.promise().error) {
+            rethrow_exception(handle.promise().error);
+        }
+        return std::move(*handle.promise().value);
+    }
+
+private:
+    coroutine_handle<promise_type> handle; // Frame of the task's body
+
+    explicit Task(coroutine_handle<promise_type> handle) : handle(handle) {
+    }
+};
+
+/*------------------------------------------------------------------------*
+ *  OrderPipeline                                                         *
+ *  Drives orders through accept -> price -> fire -> complete -> persist. *
+ *  Every submitted order is a single coroutine frame; each stage         *
+ *  co_awaits the previous one and then hops onto the executor, so a few  *
+ *  worker threads carry any number of in-flight orders.                  *
+ *------------------------------------------------------------------------*/
+class OrderPipeline {
+public:
+    /*------------------------------------------------------------------------*
+     *  OrderPipeline                                                         *
+     *  Parameterized constructor. Completed orders are archived onto         *
+     *  completedOrders by the persist stage. When catalog is given, the      *
+     *  price stage uses the prices of its published menu.                    *
+     *                                                                        *
+     *  Precondition:  completedOrders (and catalog) outlive the pipeline,    *
+     *                 and completedOrders is not modified elsewhere while    *
+     *                 orders are in flight.                                  *
+     *  Postcondition: The pipeline is ready with threadCount workers.        *
+     *------------------------------------------------------------------------*/
+    OrderPipeline(Stack &completedOrders, const MenuCatalog *catalog = nullptr, int threadCount = 2);
+
+    /*------------------------------------------------------------------------*
+     *  ~OrderPipeline                                                        *
+     *  Destructor. Waits for every in-flight order before returning.         *
+     *------------------------------------------------------------------------*/
+    ~OrderPipeline();
+
+    /*------------------------------------------------------------------------*
+     *  submit                                                                *
+     *  Starts an order through the pipeline and returns immediately.         *
+     *                                                                        *
+     *  Precondition:  order is a valid, active Order object.                 *
+     *  Postcondition: The order is in flight; it ends up on the completed    *
+     *                 stack or is counted as rejected.                       *
+     *------------------------------------------------------------------------*/
+    void submit(Order &&order);
+
+    /*------------------------------------------------------------------------*
+     *  waitIdle                                                              *
+     *  Blocks until every submitted order has left the pipeline.             *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: No order is in flight.                                 *
+     *------------------------------------------------------------------------*/
+    void waitIdle();
+
+    // Counters since construction
+    int getCompletedCount() const;
+
+    int getRejectedCount() const;
+
+private:
+    /*------------------------------------------------------------------------*
+     *  DetachedTask                                                          *
+     *  Return type of run(): starts eagerly and frees its own frame when     *
+     *  the body finishes.                                                    *
+     *------------------------------------------------------------------------*/
+    struct DetachedTask {
+        struct promise_type {
+            DetachedTask get_return_object() { return {}; }
+
+            suspend_never initial_suspend() noexcept { return {}; }
+
+            suspend_never final_suspend() noexcept { return {}; }
+
+            void return_void() {}
+
+            void unhandled_exception() { terminate(); }
+        };
+    };
+
+    Executor executor; // Workers that resume the stages
+    Stack &completedOrders; // Archive written by the persist stage
+    const MenuCatalog *catalog; // Published menu used for pricing, may be null
+
+    mutex idleMutex; // Guards inFlight for waitIdle
+    condition_variable idleCondition; // Signalled when inFlight drops to 0
+    int inFlight; // Orders submitted but not yet finished
+
+    atomic<int> completed; // Orders archived by the persist stage
+    atomic<int> rejected; // Orders that failed a stage
+
+    // Top-level coroutine of one order; owns the whole stage chain
+    DetachedTask run(Order order);
+
+    // Checks that the order can be processed
+    Task<Order> accept(Order order);
+
+    // Computes the order total from the published menu prices
+    Task<Order> price(Task<Order> input);
+
+    // Hands the order to the kitchen
+    Task<Order> fire(Task<Order> input);
+
+    // Marks the order as completed
+    Task<Order> complete(Task<Order> input);
+
+    // Archives the order onto the completed stack; returns its id
+    Task<int64_t> persist(Task<Order> input);
+
+    // Marks one order as finished and wakes waitIdle when none are left
+    void finishOne();
+};
+
+#endif //ORDERPIPELINE_H
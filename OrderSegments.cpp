@@ -0,0 +1,206 @@
+#include "OrderSegments.h"
+
+#include "OrderCodec.h"
+#include "Stack.h"
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+
+OrderSegments::OrderSegments() {
+    static atomic<int> instances(0);
+    orderCount = 0;
+    nextFile = 0;
+    stopping = false;
+    prefix = (filesystem::temp_directory_path() / ("orders-" + to_string(getpid()) + "-"
+                                                   + to_string(instances++) + "-")).string();
+}
+
+OrderSegments::~OrderSegments() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    changed.notify_all();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    for (Pending &chain : pending) {
+        deleteChain(chain.first);
+    }
+    for (Segment &segment : segments) {
+        remove(segment.path.c_str());
+    }
+}
+
+void OrderSegments::spill(OrderNode *first, size_t count) {
+    if (first == nullptr) {
+        return;
+    }
+    {
+        lock_guard<mutex> guard(lock);
+        pending.push_back(Pending{first, count});
+        orderCount += count;
+        if (!writer.joinable()) {
+            writer = thread([this] { writeLoop(); });
+        }
+    }
+    changed.notify_all();
+}
+
+void OrderSegments::flush() const {
+    unique_lock<mutex> guard(lock);
+    changed.wait(guard, [this] { return pending.empty(); });
+}
+
+shared_ptr<const vector<Order>> OrderSegments::load(size_t segment, size_t &first) const {
+    string path;
+    {
+        lock_guard<mutex> guard(lock);
+        const Segment &found = segments[segment];
+        first = found.popped;
+        if (found.pinned) {
+            return found.pinned;
+        }
+        if (shared_ptr<const vector<Order>> shared = found.cached.lock()) {
+            return shared;
+        }
+        path = found.path;
+    }
+
+    // Read outside the lock; two readers racing here just both read the file
+    shared_ptr<const vector<Order>> orders = make_shared<const vector<Order>>(readSegment(path));
+    lock_guard<mutex> guard(lock);
+    segments[segment].cached = orders;
+    return orders;
+}
+
+Order OrderSegments::popOldest() {
+    flush(); // the oldest orders may still be on their way to disk
+    size_t first;
+    shared_ptr<const vector<Order>> orders = load(0, first);
+
+    lock_guard<mutex> guard(lock);
+    Segment &oldest = segments.front();
+    oldest.pinned = orders; // keep the segment in memory while it is popped
+    Order order = (*orders)[oldest.popped++];
+    orderCount--;
+    if (oldest.popped == oldest.count) {
+        remove(oldest.path.c_str());
+        segments.erase(segments.begin());
+    }
+    return order;
+}
+
+const Order &OrderSegments::peekOldest() const {
+    {
+        unique_lock<mutex> guard(lock);
+        if (segments.empty()) {
+            guard.unlock();
+            flush(); // the oldest orders are still on their way to disk
+        } else if (segments.front().pinned) {
+            return (*segments.front().pinned)[segments.front().popped];
+        }
+    }
+    size_t first;
+    shared_ptr<const vector<Order>> orders = load(0, first);
+
+    lock_guard<mutex> guard(lock);
+    const Segment &oldest = segments.front();
+    if (!oldest.pinned) {
+        oldest.pinned = orders; // a racing reader may have pinned it first; keep that copy
+    }
+    return (*oldest.pinned)[oldest.popped];
+}
+
+void OrderSegments::clear() {
+    flush();
+    lock_guard<mutex> guard(lock);
+    for (Segment &segment : segments) {
+        remove(segment.path.c_str());
+    }
+    segments.clear();
+    orderCount = 0;
+}
+
+size_t OrderSegments::getSegmentCount() const {
+    lock_guard<mutex> guard(lock);
+    return segments.size();
+}
+
+size_t OrderSegments::getOrderCount() const {
+    lock_guard<mutex> guard(lock);
+    return orderCount;
+}
+
+void OrderSegments::writeLoop() {
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        changed.wait(guard, [this] { return stopping || !pending.empty(); });
+        if (stopping) {
+            return;
+        }
+        // Leave the chain queued while writing, so flush() keeps waiting for it
+        Pending chain = pending.front();
+        string path = prefix + to_string(nextFile++) + ".seg";
+        guard.unlock();
+
+        Segment segment{path, chain.count, 0, nullptr, {}};
+        if (!writeSegment(path, chain.first)) {
+            // Keep the orders in memory rather than lose them
+            cerr << "Could not write order segment " << path << "; keeping it in memory.\n";
+            auto orders = make_shared<vector<Order>>();
+            for (const OrderNode *node = chain.first; node != nullptr; node = node->next) {
+                orders->push_back(node->data);
+            }
+            segment.pinned = std::move(orders);
+        }
+        deleteChain(chain.first);
+
+        guard.lock();
+        segments.push_back(std::move(segment));
+        pending.pop_front();
+        changed.notify_all();
+    }
+}
+
+bool OrderSegments::writeSegment(const string &path, const OrderNode *first) {
+    OrderBatchWriter out;
+    for (const OrderNode *node = first; node != nullptr; node = node->next) {
+        out.add(node->data);
+    }
+    string batch = out.finish();
+
+    ofstream file(path, ios::binary | ios::trunc);
+    file.write(batch.data(), (streamsize) batch.size());
+    return (bool) file;
+}
+
+vector<Order> OrderSegments::readSegment(const string &path) {
+    ifstream file(path, ios::binary);
+    string in((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    vector<Order> orders;
+    try {
+        OrderBatchView batch(in.data(), in.size());
+        orders.reserve(batch.size());
+        for (OrderView order : batch) {
+            orders.push_back(order.toOrder());
+        }
+    } catch (const runtime_error &) {
+        throw runtime_error("Corrupt order segment " + path);
+    }
+    return orders;
+}
+
+void OrderSegments::deleteChain(OrderNode *first) {
+    while (first != nullptr) {
+        OrderNode *next = first->next;
+        delete first;
+        first = next;
+    }
+}
@@ -0,0 +1,168 @@
+#ifndef ORDERSEGMENTS_H
+#define ORDERSEGMENTS_H
+
+#include "Order.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+struct OrderNode; // defined in Stack.h
+
+/*------------------------------------------------------------------------*
+ *  OrderSegments                                                         *
+ *  Cold tier of the completed orders. The Stack hands over chains of its *
+ *  oldest nodes; a background writer serializes each chain to its own    *
+ *  segment file in the temporary directory and frees the nodes. Segments *
+ *  are read back on demand, oldest first, so the history stays complete  *
+ *  while only the recent orders occupy memory.                           *
+ *                                                                        *
+ *  Segment files belong to this object: they are deleted by clear() and  *
+ *  by the destructor, just as unsaved in-memory orders are.              *
+ *------------------------------------------------------------------------*/
+class OrderSegments {
+public:
+    /*------------------------------------------------------------------------*
+     *  OrderSegments                                                         *
+     *  Default constructor. Creates an empty cold tier; the writer thread    *
+     *  starts with the first spill.                                          *
+     *------------------------------------------------------------------------*/
+    OrderSegments();
+
+    /*------------------------------------------------------------------------*
+     *  ~OrderSegments                                                        *
+     *  Destructor. Stops the writer, frees unwritten chains and deletes the  *
+     *  segment files.                                                        *
+     *------------------------------------------------------------------------*/
+    ~OrderSegments();
+
+    OrderSegments(const OrderSegments &segments) = delete;
+
+    OrderSegments &operator=(const OrderSegments &segments) = delete;
+
+    /*------------------------------------------------------------------------*
+     *  spill                                                                 *
+     *  Queues a chain of nodes to be written as the next segment.            *
+     *                                                                        *
+     *  Precondition:  first is a null-terminated chain of count nodes that   *
+     *                 no container owns any more.                            *
+     *  Postcondition: This object owns the chain; it is written and freed   *
+     *                 in the background.                                     *
+     *------------------------------------------------------------------------*/
+    void spill(OrderNode *first, size_t count);
+
+    /*------------------------------------------------------------------------*
+     *  flush                                                                 *
+     *  Waits until every queued chain has been written.                      *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: getSegmentCount() covers every spilled order.          *
+     *------------------------------------------------------------------------*/
+    void flush() const;
+
+    /*------------------------------------------------------------------------*
+     *  load                                                                  *
+     *  Returns the orders of one segment, oldest first, and sets first to   *
+     *  the index of the oldest one not popped yet. A segment that is        *
+     *  already loaded by someone else is shared instead of read again.       *
+     *                                                                        *
+     *  Precondition:  segment < getSegmentCount().                           *
+     *  Postcondition: The orders stay valid while the pointer is held.       *
+     *------------------------------------------------------------------------*/
+    shared_ptr<const vector<Order>> load(size_t segment, size_t &first) const;
+
+    /*------------------------------------------------------------------------*
+     *  popOldest                                                             *
+     *  Removes and returns the oldest spilled order. Its segment stays in   *
+     *  memory until the last of its orders is popped, then its file is     *
+     *  deleted.                                                              *
+     *                                                                        *
+     *  Precondition:  getOrderCount() > 0 and no iterator over the segments *
+     *                 is in use.                                             *
+     *  Postcondition: The order is no longer in the cold tier.               *
+     *------------------------------------------------------------------------*/
+    Order popOldest();
+
+    /*------------------------------------------------------------------------*
+     *  peekOldest                                                            *
+     *  Returns the order popOldest would return. Its segment is read once   *
+     *  and kept in memory, as popOldest does, so later calls and calls from *
+     *  other threads return the same order.                                  *
+     *                                                                        *
+     *  Precondition:  getOrderCount() > 0.                                   *
+     *  Postcondition: The order stays valid until the next popOldest or     *
+     *                 clear.                                                 *
+     *------------------------------------------------------------------------*/
+    const Order &peekOldest() const;
+
+    /*------------------------------------------------------------------------*
+     *  clear                                                                 *
+     *  Discards every spilled order and deletes the segment files.           *
+     *                                                                        *
+     *  Precondition:  No iterator over the segments is in use.               *
+     *  Postcondition: The cold tier is empty.                                *
+     *------------------------------------------------------------------------*/
+    void clear();
+
+    // Number of segments written so far
+    size_t getSegmentCount() const;
+
+    // Number of orders spilled, written or still queued
+    size_t getOrderCount() const;
+
+private:
+    // One written segment file
+    struct Segment {
+        string path; // file holding the serialized orders
+        size_t count; // orders in the file
+        size_t popped; // orders already popped off the front
+        // The orders, if the file could not be written or once popping or peeking started on them
+        mutable shared_ptr<const vector<Order>> pinned;
+        mutable weak_ptr<const vector<Order>> cached; // last copy handed out by load
+    };
+
+    // One chain waiting for the writer
+    struct Pending {
+        OrderNode *first;
+        size_t count;
+    };
+
+    mutable mutex lock; // guards every member below
+
+    mutable condition_variable changed; // signalled on new work and on each write
+
+    vector<Segment> segments; // written segments, oldest first
+
+    deque<Pending> pending; // chains not written yet, oldest first
+
+    size_t orderCount; // orders in segments and pending
+
+    size_t nextFile; // number of the next segment file
+
+    string prefix; // path prefix unique to this object
+
+    bool stopping; // tells the writer to exit
+
+    thread writer; // background writer, started by the first spill
+
+    // Body of the writer thread
+    void writeLoop();
+
+    // Serializes a chain to path; returns false if the file could not be written
+    static bool writeSegment(const string &path, const OrderNode *first);
+
+    // Parses a segment file back into its orders
+    static vector<Order> readSegment(const string &path);
+
+    // Frees a chain of nodes
+    static void deleteChain(OrderNode *first);
+};
+
+#endif //ORDERSEGMENTS_H
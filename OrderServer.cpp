@@ -0,0 +1,410 @@
+#include "OrderServer.h"
+
+#include "OrderCodec.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    int stopFd = -1; // eventfd the signal handler wakes the loop with
+
+    void requestStop(int) {
+        uint64_t one = 1;
+        ssize_t ignored = write(stopFd, &one, sizeof(one)); // async-signal-safe
+        (void) ignored;
+    }
+
+    void putFixed(string &out, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; i++) {
+            out += (char) (uint8_t) (value >> (8 * i));
+        }
+    }
+
+    uint64_t getFixed(const char *data, int bytes) {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++) {
+            value |= (uint64_t) (uint8_t) data[i] << (8 * i);
+        }
+        return value;
+    }
+
+    // Frames payload for the wire
+    string frame(const string &payload) {
+        string bytes;
+        bytes.reserve(4 + payload.size());
+        putFixed(bytes, payload.size(), 4);
+        bytes += payload;
+        return bytes;
+    }
+
+    sockaddr_un addressOf(const string &socketPath) {
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(address.sun_path)) {
+            throw runtime_error("Socket path too long: " + socketPath);
+        }
+        memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+        return address;
+    }
+
+    string rejection(const string &message) {
+        return string(1, (char) OrderProtocol::Rejected) + message;
+    }
+}
+
+OrderServer::OrderServer(const string &socketPath, const DynamicArrayList &menu, Queue &active,
+                         const function<void()> &commit)
+    : socketPath(socketPath), active(active), commit(commit) {
+    for (int i = 0; i < menu.getSize(); i++) {
+        items[menu.getMenuItem(i).getId()] = &menu.getMenuItem(i);
+    }
+
+    sockaddr_un address = addressOf(socketPath);
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        throw runtime_error("Cannot create the order socket");
+    }
+    unlink(socketPath.c_str()); // left over if an earlier server was killed
+    if (bind(listenFd, (sockaddr *) &address, sizeof(address)) != 0 || listen(listenFd, SOMAXCONN) != 0) {
+        ::close(listenFd);
+        throw runtime_error("Cannot listen on " + socketPath + ": " + strerror(errno));
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    if (epollFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event) != 0) {
+        string reason = strerror(errno);
+        if (epollFd >= 0) {
+            ::close(epollFd);
+        }
+        ::close(listenFd);
+        unlink(socketPath.c_str());
+        throw runtime_error("Cannot watch " + socketPath + ": " + reason);
+    }
+}
+
+OrderServer::~OrderServer() {
+    for (auto &entry : connections) {
+        ::close(entry.first);
+    }
+    ::close(epollFd);
+    ::close(listenFd);
+    unlink(socketPath.c_str());
+}
+
+void OrderServer::run() {
+    stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stopFd < 0) {
+        throw runtime_error(string("Cannot create the stop event: ") + strerror(errno));
+    }
+    epoll_event stopEvent{};
+    stopEvent.events = EPOLLIN;
+    stopEvent.data.fd = stopFd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, stopFd, &stopEvent) != 0) {
+        string reason = strerror(errno);
+        ::close(stopFd);
+        stopFd = -1;
+        throw runtime_error("Cannot watch the stop event: " + reason);
+    }
+    struct sigaction stop{}, oldInterrupt{}, oldTerminate{};
+    stop.sa_handler = requestStop;
+    sigemptyset(&stop.sa_mask);
+    sigaction(SIGINT, &stop, &oldInterrupt);
+    sigaction(SIGTERM, &stop, &oldTerminate);
+    // Replies go out with MSG_NOSIGNAL, so a vanished client shows up as EPIPE without touching SIGPIPE
+
+    const int maxEvents = 256;
+    epoll_event events[maxEvents];
+    bool running = true;
+    while (running) {
+        int count = epoll_wait(epollFd, events, maxEvents, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            cerr << "epoll_wait failed: " << strerror(errno) << endl;
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            int fd = events[i].data.fd;
+            if (fd == stopFd) {
+                running = false;
+            } else if (fd == listenFd) {
+                acceptClients();
+            } else {
+                auto found = connections.find(fd);
+                if (found == connections.end()) {
+                    continue; // closed earlier in this turn
+                }
+                Connection &connection = *found->second;
+                if ((events[i].events & EPOLLOUT) != 0) {
+                    if (!flush(connection)) {
+                        close(connection);
+                        continue;
+                    }
+                }
+                if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0 && !receive(connection)) {
+                    close(connection);
+                }
+            }
+        }
+
+        // Group commit: make this turn's orders durable, then tell their clients
+        if (!replied.empty()) {
+            commit();
+            for (int fd : replied) {
+                auto found = connections.find(fd);
+                if (found != connections.end() && !flush(*found->second)) {
+                    close(*found->second);
+                }
+            }
+            replied.clear();
+        }
+    }
+
+    sigaction(SIGINT, &oldInterrupt, nullptr);
+    sigaction(SIGTERM, &oldTerminate, nullptr);
+    ::close(stopFd);
+    stopFd = -1;
+}
+
+void OrderServer::acceptClients() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return; // EAGAIN: no more pending clients
+        }
+        unique_ptr<Connection> connection(new Connection());
+        connection->fd = fd;
+        connection->events = EPOLLIN | EPOLLRDHUP;
+        epoll_event event{};
+        event.events = connection->events;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            // A client the loop cannot watch would never be served: drop it
+            cerr << "Cannot watch a new client: " << strerror(errno) << endl;
+            ::close(fd);
+            continue;
+        }
+        connections[fd] = std::move(connection);
+        connectionCount++;
+    }
+}
+
+bool OrderServer::receive(Connection &connection) {
+    // A client that does not read its replies is not read from either; its requests wait in the socket
+    char buffer[64 * 1024];
+    size_t queued = connection.out.size();
+    while (connection.out.size() < OrderProtocol::maxQueuedReplyBytes) {
+        ssize_t received = read(connection.fd, buffer, sizeof(buffer));
+        if (received > 0) {
+            connection.in.append(buffer, (size_t) received);
+            if (!handleFrames(connection)) {
+                return false;
+            }
+            continue;
+        }
+        if (received == 0) {
+            return false; // client closed
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return false;
+        }
+        break;
+    }
+    // Flushed after the group commit, which also stops watching for requests while too many replies wait
+    if (connection.out.size() != queued || connection.out.size() >= OrderProtocol::maxQueuedReplyBytes) {
+        replied.push_back(connection.fd);
+    }
+    return true;
+}
+
+bool OrderServer::handleFrames(Connection &connection) {
+    // Handle every complete frame; keep a partial one for the next read
+    size_t position = 0;
+    while (connection.in.size() - position >= 4) {
+        uint32_t size = (uint32_t) getFixed(connection.in.data() + position, 4);
+        if (size > OrderProtocol::maxFrameSize) {
+            return false;
+        }
+        if (connection.in.size() - position - 4 < size) {
+            break;
+        }
+        handle(connection, connection.in.data() + position + 4, size);
+        position += 4 + size;
+    }
+    connection.in.erase(0, position);
+    return true;
+}
+
+void OrderServer::handle(Connection &connection, const char *payload, size_t size) {
+    if (size == 0) {
+        connection.out += frame(rejection("Empty request"));
+        return;
+    }
+    switch ((uint8_t) payload[0]) {
+        case OrderProtocol::Submit:
+            connection.out += frame(submit(payload + 1, size - 1));
+            break;
+        default:
+            connection.out += frame(rejection("Unknown request type " + to_string((uint8_t) payload[0])));
+    }
+}
+
+string OrderServer::submit(const char *batch, size_t size) {
+    // Build every order first, so a bad one rejects the batch before anything is queued
+    vector<Order> orders;
+    try {
+        OrderBatchView view(batch, size); // the client's order count is not trusted for reserving
+        for (OrderView submitted : view) {
+            Order order(string(submitted.getCustomerName()), OrderLines());
+            for (const OrderLine &line : submitted) {
+                auto found = items.find(line.menuItemId);
+                if (found == items.end()) {
+                    rejected += view.size();
+                    return rejection("Menu item with ID " + to_string(line.menuItemId) + " not found");
+                }
+                if (line.quantity <= 0) {
+                    rejected += view.size();
+                    return rejection("Quantities must be positive");
+                }
+                order.addItem(*found->second, line.quantity);
+            }
+            if (order.getLines().empty()) {
+                rejected += view.size();
+                return rejection("Order for " + order.getCustomerName() + " has no items");
+            }
+            orders.push_back(std::move(order));
+        }
+    } catch (const exception &error) {
+        // Corrupt batches, and anything else a client's bytes make fail, reject the request but keep serving
+        rejected++;
+        return rejection(error.what());
+    }
+
+    string reply(1, (char) OrderProtocol::Accepted);
+    putFixed(reply, orders.size(), 4);
+    for (Order &order : orders) {
+        putFixed(reply, (uint64_t) order.getOrderId(), 8);
+        active.enqueue(std::move(order));
+    }
+    accepted += orders.size();
+    return reply;
+}
+
+bool OrderServer::flush(Connection &connection) {
+    size_t written = 0;
+    while (written < connection.out.size()) {
+        ssize_t sent = send(connection.fd, connection.out.data() + written, connection.out.size() - written,
+                            MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                return false;
+            }
+            break;
+        }
+        written += (size_t) sent;
+    }
+    connection.out.erase(0, written);
+
+    // Wait for room only while something is left to write, and for requests only while few replies wait
+    bool blocked = !connection.out.empty();
+    bool reading = connection.out.size() < OrderProtocol::maxQueuedReplyBytes;
+    uint32_t events = (reading ? (uint32_t) (EPOLLIN | EPOLLRDHUP) : 0u) | (blocked ? (uint32_t) EPOLLOUT : 0u);
+    if (events != connection.events) {
+        connection.events = events;
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = connection.fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event) != 0) {
+            return false; // the loop could no longer tell when to serve it
+        }
+    }
+    return true;
+}
+
+void OrderServer::close(Connection &connection) {
+    int fd = connection.fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr) != 0) {
+        // Closing the only descriptor of the socket drops it from the epoll set anyway
+        cerr << "Cannot unwatch a client: " << strerror(errno) << endl;
+    }
+    ::close(fd);
+    connections.erase(fd); // connection is gone from here on
+}
+
+OrderClient::OrderClient(const string &socketPath) {
+    sockaddr_un address = addressOf(socketPath);
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, (sockaddr *) &address, sizeof(address)) != 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        throw runtime_error("Cannot connect to the order server at " + socketPath);
+    }
+}
+
+OrderClient::~OrderClient() {
+    ::close(fd);
+}
+
+vector<int64_t> OrderClient::submit(const string &batch) {
+    string request = frame(string(1, (char) OrderProtocol::Submit) + batch);
+    for (size_t written = 0; written < request.size();) {
+        ssize_t sent = send(fd, request.data() + written, request.size() - written, MSG_NOSIGNAL);
+        if (sent < 0 && errno != EINTR) {
+            throw runtime_error("Lost the connection to the order server");
+        }
+        written += sent > 0 ? (size_t) sent : 0;
+    }
+
+    auto receiveAll = [this](char *data, size_t size) {
+        for (size_t received = 0; received < size;) {
+            ssize_t got = recv(fd, data + received, size - received, 0);
+            if (got == 0 || (got < 0 && errno != EINTR)) {
+                throw runtime_error("Lost the connection to the order server");
+            }
+            received += got > 0 ? (size_t) got : 0;
+        }
+    };
+    char header[4];
+    receiveAll(header, 4);
+    string reply(getFixed(header, 4), '\0');
+    receiveAll(reply.data(), reply.size());
+    if (reply.empty()) {
+        throw runtime_error("Empty reply from the order server");
+    }
+    if ((uint8_t) reply[0] != OrderProtocol::Accepted) {
+        throw runtime_error(reply.substr(1));
+    }
+    if (reply.size() < 5) {
+        throw runtime_error("Truncated reply from the order server");
+    }
+    uint32_t count = (uint32_t) getFixed(reply.data() + 1, 4);
+    if (reply.size() != 5 + (size_t) count * 8) {
+        throw runtime_error("Truncated reply from the order server");
+    }
+    vector<int64_t> ids(count);
+    for (uint32_t i = 0; i < count; i++) {
+        ids[i] = (int64_t) getFixed(reply.data() + 5 + 8 * i, 8);
+    }
+    return ids;
+}
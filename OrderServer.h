@@ -0,0 +1,177 @@
+#ifndef ORDERSERVER_H
+#define ORDERSERVER_H
+
+#include "DynamicArrayList.h"
+#include "Queue.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  Order intake protocol                                                 *
+ *                                                                        *
+ *  Every message is a frame: u32 little-endian payload length, then the *
+ *  payload. Requests start with a type byte:                             *
+ *                                                                        *
+ *    1  submit   an OrderCodec batch. Only the customer names, menu     *
+ *                item IDs and quantities are used: the server assigns    *
+ *                the order IDs and takes the prices from its menu.       *
+ *                                                                        *
+ *  Each request is answered, in order, with a status byte:               *
+ *                                                                        *
+ *    0  accepted u32 count, then count i64 order IDs (little-endian)    *
+ *    1  rejected a message; none of the batch's orders were queued       *
+ *------------------------------------------------------------------------*/
+namespace OrderProtocol {
+    const uint8_t Submit = 1;
+
+    const uint8_t Accepted = 0;
+    const uint8_t Rejected = 1;
+
+    const uint32_t maxFrameSize = 4 * 1024 * 1024; // larger frames close the connection
+
+    const size_t maxQueuedReplyBytes = 1024 * 1024; // a client's requests are not read while more waits
+}
+
+/*------------------------------------------------------------------------*
+ *  OrderServer                                                           *
+ *  Accepts orders from local POS clients over a Unix domain socket and  *
+ *  queues them as active orders. One thread runs an epoll loop over the *
+ *  listening socket and every connection, all non-blocking, so a slow   *
+ *  client never holds up the others.                                     *
+ *                                                                        *
+ *  Replies are held back until the end of each loop turn, after the     *
+ *  commit callback ran, so one journal sync covers every order that     *
+ *  arrived in that turn and no client hears "accepted" for an order     *
+ *  that is not yet durable.                                              *
+ *------------------------------------------------------------------------*/
+class OrderServer {
+public:
+    /*------------------------------------------------------------------------*
+     *  OrderServer                                                           *
+     *  Parameterized constructor. Binds and listens on socketPath,          *
+     *  replacing a stale socket file left by an earlier run.                 *
+     *                                                                        *
+     *  Precondition:  menu and active outlive the server and are used by no *
+     *                 other thread while it runs.                            *
+     *  Postcondition: Throws runtime_error if the socket cannot be set up.   *
+     *------------------------------------------------------------------------*/
+    OrderServer(const string &socketPath, const DynamicArrayList &menu, Queue &active,
+                const function<void()> &commit);
+
+    /*------------------------------------------------------------------------*
+     *  ~OrderServer                                                          *
+     *  Destructor. Closes every connection and removes the socket file.      *
+     *------------------------------------------------------------------------*/
+    ~OrderServer();
+
+    OrderServer(const OrderServer &server) = delete;
+
+    OrderServer &operator=(const OrderServer &server) = delete;
+
+    /*------------------------------------------------------------------------*
+     *  run                                                                   *
+     *  Serves clients until SIGINT or SIGTERM arrives. Throws runtime_error *
+     *  if the stop event cannot be set up. A client that cannot be watched  *
+     *  is closed. SIGPIPE is left alone.                                     *
+     *                                                                        *
+     *  Precondition:  Only one server runs at a time.                        *
+     *  Postcondition: Every reply to a complete request was sent or its     *
+     *                 client was gone.                                       *
+     *------------------------------------------------------------------------*/
+    void run();
+
+    // Totals since construction
+    uint64_t getAcceptedCount() const { return accepted; }
+
+    uint64_t getRejectedCount() const { return rejected; }
+
+    uint64_t getConnectionCount() const { return connectionCount; }
+
+private:
+    // One client connection
+    struct Connection {
+        int fd;
+        string in; // bytes received, not yet a complete frame
+        string out; // replies not yet written
+        uint32_t events = 0; // what epoll watches the connection for
+    };
+
+    string socketPath;
+    Queue &active;
+    function<void()> commit;
+    unordered_map<int, const MenuItem *> items; // menu item ID -> item
+
+    int listenFd;
+    int epollFd;
+    unordered_map<int, unique_ptr<Connection>> connections; // by descriptor
+    vector<int> replied; // connections with replies held back this turn
+
+    uint64_t accepted = 0;
+    uint64_t rejected = 0;
+    uint64_t connectionCount = 0;
+
+    void acceptClients();
+
+    // Reads what the client sent and handles its complete frames, until too many replies wait; false once it is gone
+    bool receive(Connection &connection);
+
+    // Handles the complete frames received; returns false if one is too large
+    bool handleFrames(Connection &connection);
+
+    // Answers one request payload
+    void handle(Connection &connection, const char *payload, size_t size);
+
+    // Queues the orders of a submit request; returns the reply payload
+    string submit(const char *batch, size_t size);
+
+    // Writes as much of the held back replies as the socket takes, then updates what epoll watches; false on error
+    bool flush(Connection &connection);
+
+    void close(Connection &connection);
+};
+
+/*------------------------------------------------------------------------*
+ *  OrderClient                                                           *
+ *  Blocking client for OrderServer, e.g. for a POS terminal or a load   *
+ *  generator.                                                            *
+ *------------------------------------------------------------------------*/
+class OrderClient {
+public:
+    /*------------------------------------------------------------------------*
+     *  OrderClient                                                           *
+     *  Parameterized constructor. Connects to the server at socketPath.      *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: Throws runtime_error if the server is not reachable.   *
+     *------------------------------------------------------------------------*/
+    explicit OrderClient(const string &socketPath);
+
+    ~OrderClient();
+
+    OrderClient(const OrderClient &client) = delete;
+
+    OrderClient &operator=(const OrderClient &client) = delete;
+
+    /*------------------------------------------------------------------------*
+     *  submit                                                                *
+     *  Sends an OrderCodec batch and waits for the answer.                   *
+     *                                                                        *
+     *  Precondition:  batch was made by OrderBatchWriter.                    *
+     *  Postcondition: Returns the IDs the server gave the orders. Throws    *
+     *                 runtime_error with the server's message if the batch  *
+     *                 was rejected, or if the connection failed.             *
+     *------------------------------------------------------------------------*/
+    vector<int64_t> submit(const string &batch);
+
+private:
+    int fd; // connected socket
+};
+
+#endif //ORDERSERVER_H
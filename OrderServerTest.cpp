@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "OrderCodec.h"
+#include "OrderServer.h"
+#include "TestCheck.h"
+#include "TestOrders.h"
+
+using namespace std;
+
+namespace {
+    // A batch of count orders for items 1 and 2
+    string batchOf(int count) {
+        OrderBatchWriter writer;
+        for (int i = 0; i < count; i++) {
+            writer.add(testOrder(0, "Ada", 2));
+        }
+        return writer.finish();
+    }
+
+    int connectTo(const string &socketPath) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, (sockaddr *) &address, sizeof(address)) != 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // Sends raw bytes on a new connection; returns true if the server then closed it
+    bool closedAfter(const string &socketPath, const string &bytes) {
+        int fd = connectTo(socketPath);
+        if (fd < 0) {
+            return false;
+        }
+        bool sent = send(fd, bytes.data(), bytes.size(), MSG_NOSIGNAL) == (ssize_t) bytes.size();
+        char byte;
+        bool closed = sent && recv(fd, &byte, 1, 0) == 0;
+        close(fd);
+        return closed;
+    }
+
+    // Sends a submit request in pieces of at most piece bytes; returns the reply's status byte, or -1
+    int submitInPieces(const string &socketPath, const string &batch, size_t piece) {
+        string request = string(1, (char) OrderProtocol::Submit) + batch;
+        string framed(4, '\0');
+        uint32_t length = (uint32_t) request.size();
+        memcpy(&framed[0], &length, 4);
+        framed += request;
+
+        int fd = connectTo(socketPath);
+        if (fd < 0) {
+            return -1;
+        }
+        for (size_t sent = 0; sent < framed.size(); sent += piece) {
+            send(fd, framed.data() + sent, min(piece, framed.size() - sent), MSG_NOSIGNAL);
+            this_thread::sleep_for(chrono::milliseconds(2)); // give the server a read per piece
+        }
+        char reply[5];
+        size_t received = 0;
+        while (received < sizeof(reply)) {
+            ssize_t got = recv(fd, reply + received, sizeof(reply) - received, 0);
+            if (got <= 0) {
+                close(fd);
+                return -1;
+            }
+            received += (size_t) got;
+        }
+        close(fd);
+        return (uint8_t) reply[4];
+    }
+}
+
+int main() {
+    string socketPath = (filesystem::temp_directory_path() / ("order-server-test-" + to_string(getpid()))).string();
+    DynamicArrayList menu;
+    menu.add(MenuItem(1, "Pizza", "Cheese", 8.99));
+    menu.add(MenuItem(2, "Burger", "Beef", 5.49));
+    Queue active;
+    int commits = 0;
+    OrderServer server(socketPath, menu, active, [&commits] { commits++; });
+    thread loop([&server] { server.run(); });
+
+    {
+        OrderClient client(socketPath);
+        vector<int64_t> ids = client.submit(batchOf(3));
+        CHECK(ids.size() == 3 && ids[0] != ids[1] && ids[1] != ids[2]);
+
+        // Unknown items and corrupt batches are rejected without closing the connection
+        OrderBatchWriter unknown;
+        unknown.add(testOrder(0, "Grace", 5)); // items 3-5 are not on the menu
+        CHECK_THROWS(client.submit(unknown.finish()), runtime_error);
+        CHECK_THROWS(client.submit("not a batch"), runtime_error);
+        CHECK(client.submit(batchOf(1)).size() == 1);
+    }
+
+    // A frame larger than the protocol allows closes the connection
+    string oversized(4, '\0');
+    uint32_t size = OrderProtocol::maxFrameSize + 1;
+    memcpy(&oversized[0], &size, 4);
+    CHECK(closedAfter(socketPath, oversized));
+
+    // A request split over several reads, even inside its length, is put together again
+    CHECK(submitInPieces(socketPath, batchOf(2), 3) == OrderProtocol::Accepted);
+
+    kill(getpid(), SIGINT); // run() handles it by now: the replies above came from its loop
+    loop.join();
+
+    CHECK(active.size() == 6);
+    CHECK(server.getAcceptedCount() == 6 && server.getRejectedCount() == 2);
+    CHECK(commits >= 3);
+
+    struct sigaction pipe{};
+    sigaction(SIGPIPE, nullptr, &pipe);
+    CHECK(pipe.sa_handler == SIG_DFL); // the server relies on MSG_NOSIGNAL instead
+    return testResult();
+}
@@ -0,0 +1,62 @@
+#include <utility>
+
+#include "DynamicArrayList.h"
+#include "Order.h"
+#include "TestCheck.h"
+#include "TestOrders.h"
+
+using namespace std;
+
+namespace {
+    // Lines of one item at one price merge; a new price starts a new line
+    void testAddItem() {
+        MenuItem pizza(1, "Pizza", "Cheese", 8.99);
+        MenuItem cola(2, "Cola", "Chilled", 1.5);
+        Order order("Ada", OrderLines());
+        order.addItem(pizza, 2);
+        order.addItem(cola);
+        order.addItem(pizza);
+        CHECK(order.getLines().size() == 2);
+        CHECK(order.getLines()[0].menuItemId == 1 && order.getLines()[0].quantity == 3);
+        CHECK(order.getLines()[0].unitPriceCents == 899 && order.getLines()[1].unitPriceCents == 150);
+        CHECK(order.getTotalAmount() == (3 * 899 + 150) / 100.0);
+
+        MenuItem dearerPizza(1, "Pizza", "Cheese", 9.49);
+        order.addItem(dearerPizza);
+        CHECK(order.getLines().size() == 3 && order.getLines()[2].unitPriceCents == 949);
+        CHECK(order.getTotalAmount() == (3 * 899 + 150 + 949) / 100.0);
+    }
+
+    // Repricing reads the menu by item ID and leaves items no longer on it alone
+    void testReprice() {
+        DynamicArrayList menu;
+        menu.add(MenuItem(1, "Pizza", "Cheese", 10.0));
+        Order order = testOrder(1, "Ada", 2, 100); // items 1 and 2
+        order.updateTotalAmount(menu);
+        CHECK(order.getLines()[0].unitPriceCents == 1000 && order.getLines()[1].unitPriceCents == 100);
+        CHECK(order.getTotalAmount() == 12.0);
+    }
+
+    // Lines are stored inline up to eight, and copies and moves keep them
+    void testLineStorage() {
+        Order small = testOrder(1, "Ada", 8);
+        CHECK(small.getLines().isInline() && small.getLines().heapBytes() == 0);
+        Order large = testOrder(2, "Ada", 9);
+        CHECK(!large.getLines().isInline() && large.getLines().size() == 9);
+
+        Order copy(large);
+        Order moved(std::move(large));
+        CHECK(copy.getLines().size() == 9 && moved.getLines().size() == 9);
+        CHECK(copy.getTotalAmount() == moved.getTotalAmount() && moved.getLines()[8].menuItemId == 9);
+        CHECK(large.getLines().empty()); // moved from, still valid
+        large = small;
+        CHECK(large.getLines().size() == 8 && large.getOrderId() == 1);
+    }
+}
+
+int main() {
+    testAddItem();
+    testReprice();
+    testLineStorage();
+    return testResult();
+}
@@ -0,0 +1,145 @@
+#include "ParallelOps.h"
+
+#include <algorithm>
+
+ThreadPool &ThreadPool::shared() {
+    static ThreadPool pool(max(1, (int) thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+ThreadPool::ThreadPool(int workerCount) {
+    stopping = false;
+    for (int i = 0; i < workerCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(poolMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::getConcurrency() const {
+    return (int) workers.size() + 1;
+}
+
+void ThreadPool::runAll(vector<function<void()>> &jobs) {
+    /*------------------------------------------------------------*
+     *  runAll                                                    *
+     *  Posts the batch for the workers, works on it from this    *
+     *  thread too, then waits for jobs claimed by workers. The   *
+     *  batch leaves pending before any failure is rethrown, so   *
+     *  no worker can reach it once this frame is gone.           *
+     *------------------------------------------------------------*/
+    if (jobs.empty()) {
+        return;
+    }
+    Batch batch;
+    batch.jobs = &jobs;
+    if (jobs.size() == 1 || workers.empty()) {
+        for (size_t index = 0; index < jobs.size(); index++) {
+            runJob(batch, index);
+        }
+        if (batch.error) {
+            rethrow_exception(batch.error);
+        }
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(poolMutex);
+        pending.push_back(&batch);
+    }
+    workAvailable.notify_all();
+
+    work(batch);
+
+    unique_lock<mutex> lock(poolMutex);
+    pending.erase(remove(pending.begin(), pending.end(), &batch), pending.end());
+    batchDone.wait(lock, [&batch, &jobs] { return batch.finished.load() == jobs.size(); });
+    lock.unlock();
+    if (batch.error) {
+        rethrow_exception(batch.error);
+    }
+}
+
+void ThreadPool::runJob(Batch &batch, size_t index) {
+    try {
+        (*batch.jobs)[index]();
+    } catch (...) {
+        if (!batch.failed.exchange(true)) {
+            batch.error = current_exception();
+        }
+    }
+}
+
+void ThreadPool::work(Batch &batch) {
+    size_t total = batch.jobs->size();
+    while (true) {
+        size_t index = batch.next.fetch_add(1);
+        if (index >= total) {
+            return;
+        }
+        runJob(batch, index);
+        if (batch.finished.fetch_add(1) + 1 == total) {
+            lock_guard<mutex> lock(poolMutex); // the owner may be about to wait
+            batchDone.notify_all();
+        }
+    }
+}
+
+void ThreadPool::workerLoop() {
+    /*------------------------------------------------------------*
+     *  workerLoop                                                *
+     *  Helps the oldest batch that still has unclaimed jobs.     *
+     *  A batch stays in pending until its owner has finished    *
+     *  claiming, and the owner waits for every claimed job, so   *
+     *  the batch outlives every worker touching it.              *
+     *------------------------------------------------------------*/
+    unique_lock<mutex> lock(poolMutex);
+    while (true) {
+        workAvailable.wait(lock, [this] {
+            if (stopping) {
+                return true;
+            }
+            for (Batch *batch : pending) {
+                if (batch->next.load() < batch->jobs->size()) {
+                    return true;
+                }
+            }
+            return false;
+        });
+        if (stopping) {
+            return;
+        }
+
+        Batch *batch = nullptr;
+        for (Batch *candidate : pending) {
+            if (candidate->next.load() < candidate->jobs->size()) {
+                batch = candidate;
+                break;
+            }
+        }
+        if (batch == nullptr) {
+            continue;
+        }
+        // Claim one job under the lock so the batch cannot leave pending first
+        size_t index = batch->next.fetch_add(1);
+        size_t total = batch->jobs->size();
+        if (index >= total) {
+            continue;
+        }
+        lock.unlock();
+        runJob(*batch, index);
+        lock.lock();
+        if (batch->finished.fetch_add(1) + 1 == total) {
+            batchDone.notify_all();
+        }
+    }
+}
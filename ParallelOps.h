@@ -0,0 +1,196 @@
+#ifndef PARALLELOPS_H
+#define PARALLELOPS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  ThreadPool                                                            *
+ *  A process-wide pool of worker threads for data-parallel loops. The    *
+ *  calling thread takes part in the work, so a pool of N workers runs    *
+ *  N + 1 jobs at once and nested calls cannot deadlock.                  *
+ *------------------------------------------------------------------------*/
+class ThreadPool {
+public:
+    /*------------------------------------------------------------------------*
+     *  shared                                                                *
+     *  Returns the pool sized to the machine (one worker per extra core).    *
+     *------------------------------------------------------------------------*/
+    static ThreadPool &shared();
+
+    /*------------------------------------------------------------------------*
+     *  ThreadPool                                                            *
+     *  Parameterized constructor. Starts workerCount worker threads.         *
+     *                                                                        *
+     *  Precondition:  workerCount >= 0.                                      *
+     *  Postcondition: The workers are waiting for jobs.                      *
+     *------------------------------------------------------------------------*/
+    explicit ThreadPool(int workerCount);
+
+    /*------------------------------------------------------------------------*
+     *  ~ThreadPool                                                           *
+     *  Destructor. Stops and joins the workers.                              *
+     *------------------------------------------------------------------------*/
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &pool) = delete;
+
+    ThreadPool &operator=(const ThreadPool &pool) = delete;
+
+    /*------------------------------------------------------------------------*
+     *  runAll                                                                *
+     *  Runs every job, spread over the workers and the calling thread, and   *
+     *  returns when all of them have finished. A job that throws still      *
+     *  counts as finished; once every job is done, the first exception      *
+     *  caught is rethrown on the calling thread.                             *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: Every job has run exactly once.                        *
+     *------------------------------------------------------------------------*/
+    void runAll(vector<function<void()>> &jobs);
+
+    /*------------------------------------------------------------------------*
+     *  getConcurrency                                                        *
+     *  Returns how many jobs can run at once (workers plus the caller).      *
+     *------------------------------------------------------------------------*/
+    int getConcurrency() const;
+
+private:
+    // One call to runAll: its jobs, the next job to claim, the count done and the first failure
+    struct Batch {
+        vector<function<void()>> *jobs;
+        atomic<size_t> next{0};
+        atomic<size_t> finished{0};
+        atomic<bool> failed{false};
+        exception_ptr error; // Written once, by the job that set failed
+    };
+
+    vector<thread> workers; // Worker threads
+    mutex poolMutex; // Guards pending and stopping
+    condition_variable workAvailable; // Signalled when a batch is posted
+    condition_variable batchDone; // Signalled when a batch's last job ends
+    vector<Batch *> pending; // Batches that still have unclaimed jobs
+    bool stopping; // Set by the destructor
+
+    // Claims and runs jobs of batch until none are left
+    void work(Batch &batch);
+
+    // Runs one job of batch, keeping the first exception instead of letting it escape
+    static void runJob(Batch &batch, size_t index);
+
+    // Body of each worker thread
+    void workerLoop();
+};
+
+/*------------------------------------------------------------------------*
+ *  splitRange                                                            *
+ *  Cuts [first, last) into at most pieces contiguous chunks of at least  *
+ *  minChunk elements. Returns the chunk boundaries (chunks + 1 entries). *
+ *  Works on forward iterators: one pass to count, one to cut.            *
+ *------------------------------------------------------------------------*/
+template <typename Iterator>
+vector<Iterator> splitRange(Iterator first, Iterator last, int pieces, size_t minChunk) {
+    size_t count = (size_t) distance(first, last);
+    size_t chunks = minChunk == 0 ? (size_t) pieces : count / minChunk;
+    if (chunks > (size_t) pieces) {
+        chunks = (size_t) pieces;
+    }
+    if (chunks < 1) {
+        chunks = 1;
+    }
+
+    vector<Iterator> bounds;
+    bounds.push_back(first);
+    for (size_t i = 1; i < chunks; i++) {
+        size_t step = count / chunks + (i <= count % chunks ? 1 : 0);
+        advance(first, step);
+        bounds.push_back(first);
+    }
+    bounds.push_back(last);
+    return bounds;
+}
+
+/*------------------------------------------------------------------------*
+ *  reduceChunk                                                           *
+ *  Reduces [first, last) on the calling thread: the chunk job of         *
+ *  parallelReduce. Returns nothing for an empty range.                   *
+ *------------------------------------------------------------------------*/
+template <typename T, typename Iterator, typename Map, typename Combine>
+optional<T> reduceChunk(Iterator first, Iterator last, Map &map, Combine &combine) {
+    if (first == last) {
+        return nullopt;
+    }
+    T value = map(*first);
+    for (++first; first != last; ++first) {
+        value = combine(value, map(*first));
+    }
+    return value;
+}
+
+/*------------------------------------------------------------------------*
+ *  parallelReduce                                                        *
+ *  Computes combine(...combine(init, map(x0))..., map(xn)) over a range  *
+ *  using the shared pool. Chunks are reduced independently and their     *
+ *  results combined in range order, so the result does not depend on     *
+ *  thread timing. Nothing in the range is copied or modified.            *
+ *                                                                        *
+ *  Precondition:  map and combine are safe to call concurrently and      *
+ *                 combine is associative.                                *
+ *  Postcondition: The reduced value is returned.                         *
+ *------------------------------------------------------------------------*/
+template <typename Iterator, typename T, typename Map, typename Combine>
+T parallelReduce(Iterator first, Iterator last, T init, Map map, Combine combine, size_t minChunk = 1024) {
+    ThreadPool &pool = ThreadPool::shared();
+    vector<Iterator> bounds = splitRange(first, last, pool.getConcurrency(), minChunk);
+    size_t chunks = bounds.size() - 1;
+
+    vector<optional<T>> partial(chunks); // one slot per chunk, left empty for an empty chunk
+    vector<function<void()>> jobs;
+    for (size_t c = 0; c < chunks; c++) {
+        jobs.push_back([&, c] { partial[c] = reduceChunk<T>(bounds[c], bounds[c + 1], map, combine); });
+    }
+    pool.runAll(jobs);
+
+    T result = init;
+    for (size_t c = 0; c < chunks; c++) {
+        if (partial[c].has_value()) {
+            result = combine(result, *partial[c]);
+        }
+    }
+    return result;
+}
+
+/*------------------------------------------------------------------------*
+ *  parallelForEach                                                       *
+ *  Calls fn on every element of a range using the shared pool.           *
+ *                                                                        *
+ *  Precondition:  fn is safe to call concurrently on different elements. *
+ *  Postcondition: fn has been called once per element.                   *
+ *------------------------------------------------------------------------*/
+template <typename Iterator, typename Fn>
+void parallelForEach(Iterator first, Iterator last, Fn fn, size_t minChunk = 1024) {
+    ThreadPool &pool = ThreadPool::shared();
+    vector<Iterator> bounds = splitRange(first, last, pool.getConcurrency(), minChunk);
+
+    vector<function<void()>> jobs;
+    for (size_t c = 0; c + 1 < bounds.size(); c++) {
+        jobs.push_back([&, c] {
+            for (auto it = bounds[c]; it != bounds[c + 1]; ++it) {
+                fn(*it);
+            }
+        });
+    }
+    pool.runAll(jobs);
+}
+
+#endif //PARALLELOPS_H
@@ -0,0 +1,89 @@
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "ParallelOps.h"
+#include "Stack.h"
+#include "TestCheck.h"
+#include "TestOrders.h"
+
+using namespace std;
+
+namespace {
+    void testReduce() {
+        vector<int> values(100000);
+        iota(values.begin(), values.end(), 1);
+        long long sum = parallelReduce(values.begin(), values.end(), 0LL, [](int value) { return (long long) value; },
+                                       [](long long a, long long b) { return a + b; }, 100);
+        CHECK(sum == 100000LL * 100001 / 2);
+
+        // Chunks are combined in range order, so a non-commutative combine keeps the order
+        vector<string> words = {"a", "b", "c", "d", "e", "f", "g"};
+        string joined = parallelReduce(words.begin(), words.end(), string(">"), [](const string &word) { return word; },
+                                       [](const string &a, const string &b) { return a + b; }, 1);
+        CHECK(joined == ">abcdefg");
+    }
+
+    // Jobs that throw, on the workers or on the calling thread, still let every other job finish
+    void testThrowingJobs(ThreadPool &pool) {
+        for (int round = 0; round < 50; round++) {
+            atomic<int> ran(0);
+            vector<function<void()>> jobs;
+            for (int i = 0; i < 64; i++) {
+                jobs.push_back([&ran, i] {
+                    ran++;
+                    if (i % 7 == 3) {
+                        throw runtime_error("job " + to_string(i));
+                    }
+                });
+            }
+            CHECK_THROWS(pool.runAll(jobs), runtime_error);
+            CHECK(ran == 64);
+        }
+
+        // The pool keeps working after a failed batch
+        atomic<int> ran(0);
+        vector<function<void()>> jobs(16, [&ran] { ran++; });
+        pool.runAll(jobs);
+        CHECK(ran == 16);
+    }
+
+    // A damaged segment file fails the reduce over the history instead of the process
+    void testCorruptSegment() {
+        Stack completed;
+        completed.setMemoryBudget(16 * 1024);
+        for (int i = 0; i < 2000; i++) {
+            completed.push(testOrder(i + 1, "Ada", 3));
+        }
+        auto countOrders = [&completed] {
+            return completed.parallelReduce(0, [](const Order &) { return 1; }, [](int a, int b) { return a + b; }, 64);
+        };
+        CHECK(countOrders() == 2000);
+
+        string prefix = "orders-" + to_string(getpid()) + "-";
+        int damaged = 0;
+        for (const filesystem::directory_entry &entry : filesystem::directory_iterator(filesystem::temp_directory_path())) {
+            if (entry.path().filename().string().rfind(prefix, 0) == 0) {
+                filesystem::resize_file(entry.path(), 5);
+                damaged++;
+            }
+        }
+        CHECK(damaged > 1);
+        CHECK_THROWS(countOrders(), runtime_error);
+    }
+}
+
+int main() {
+    testReduce();
+    ThreadPool workers(3);
+    testThrowingJobs(workers);
+    ThreadPool callerOnly(0);
+    testThrowingJobs(callerOnly);
+    testCorruptSegment();
+    return testResult();
+}
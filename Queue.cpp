@@ -1,4 +1,12 @@
 #include "Queue.h"
+#include "LatencyHistogram.h"
+#include "Trace.h"
+
+namespace {
+    LatencyHistogram processLatency("Queue::processNextOrders");
+}
+
+CountingResource Queue::nodeMemory("Queue");
 
 
 
@@ -10,6 +18,35 @@ Queue::Queue() {
      *------------------------------------------------------------*/
     front = nullptr;
     back = nullptr;
+    listener = nullptr;
+}
+
+Queue::Queue(Queue &&queue) noexcept {
+    /*------------------------------------------------------------*
+     *  Queue                                                     *
+     *  Move constructor. Steals the node chain of queue.         *
+     *------------------------------------------------------------*/
+    front = queue.front;
+    back = queue.back;
+    listener = queue.listener;
+    queue.front = nullptr;
+    queue.back = nullptr;
+}
+
+Queue &Queue::operator=(Queue &&queue) noexcept {
+    /*------------------------------------------------------------*
+     *  operator=                                                 *
+     *  Move assignment. Frees our nodes, then steals queue's.    *
+     *------------------------------------------------------------*/
+    if (this != &queue) {
+        clear();
+        front = queue.front;
+        back = queue.back;
+        listener = queue.listener;
+        queue.front = nullptr;
+        queue.back = nullptr;
+    }
+    return *this;
 }
 
 Queue::~Queue() {
@@ -20,15 +57,35 @@ Queue::~Queue() {
     clear();
 }
 
-void Queue::enqueue(ElementType value) {
+void Queue::enqueue(const ElementType &value) {
+    /*------------------------------------------------------------*
+     *  enqueue                                                   *
+     *  Adds a copy of an order to the back of the queue.         *
+     *                                                            *
+     *  Precondition:  value is a valid Order object.             *
+     *  Postcondition: value is added to the back of the queue.   *
+     *------------------------------------------------------------*/
+    linkBack(new (nodeMemory) Node(value));
+}
+
+void Queue::enqueue(ElementType &&value) {
     /*------------------------------------------------------------*
      *  enqueue                                                   *
-     *  Adds an order to the back of the queue.                   *
+     *  Moves an order to the back of the queue.                  *
      *                                                            *
      *  Precondition:  value is a valid Order object.             *
      *  Postcondition: value is added to the back of the queue.   *
      *------------------------------------------------------------*/
-    NodePtr newNode = new Node(value);
+    linkBack(new (nodeMemory) Node(std::move(value)));
+}
+
+void Queue::linkBack(NodePtr newNode) {
+    /*------------------------------------------------------------*
+     *  linkBack                                                  *
+     *  Links a node at the back of the queue.                    *
+     *------------------------------------------------------------*/
+    TRACE_SPAN("Queue::enqueue");
+    TRACE_ORDER_BEGIN(newNode->data.getOrderId());
     if (isEmpty()) {
         front = newNode;
         back = newNode;
@@ -36,6 +93,9 @@ void Queue::enqueue(ElementType value) {
         back->next = newNode;
         back = newNode;
     }
+    if (listener != nullptr) {
+        listener->onEnqueued(newNode->data);
+    }
 }
 
 ElementType Queue::dequeue() {
@@ -44,18 +104,20 @@ ElementType Queue::dequeue() {
      *  Removes and returns the front order from the queue.       *
      *                                                            *
      *  Precondition:  The queue is not empty.                    *
-     *  Postcondition: The front order is removed from the queue  *
+     *  Postcondition: The front order is moved out of the queue  *
      *                 and returned.                              *
      *------------------------------------------------------------*/
     assert(!isEmpty());
+    TRACE_SPAN("Queue::dequeue");
+    TRACE_ORDER_STEP("dequeued", front->data.getOrderId());
     NodePtr temp = front;
-    ElementType data = temp->data;
+    ElementType data = std::move(temp->data);
     front = front->next;
     delete temp;
     return data;
 }
 
-ElementType Queue::peek() {
+const ElementType &Queue::peek() {
     /*------------------------------------------------------------*
      *  peek                                                      *
      *  Returns the front order in the queue without removing it. *
@@ -94,7 +156,7 @@ void Queue::clear() {
     }
 }
 
-void Queue::print() {
+void Queue::print(const DynamicArrayList &menu) {
     /*------------------------------------------------------------*
      *  print                                                     *
      *  Prints the orders in the queue.                           *
@@ -103,14 +165,20 @@ void Queue::print() {
      *  Postcondition: The orders in the queue are printed to the *
      *                 console.                                   *
      *------------------------------------------------------------*/
-    NodePtr current = front;
-    while (current != nullptr) {
-        cout << current->data.toString() << " ";
-        current = current->next;
+    for (const ElementType &order : *this) {
+        cout << order.toString(menu) << " ";
     }
     cout << endl;
 }
 
+Queue::const_iterator Queue::begin() const {
+    return const_iterator(front);
+}
+
+Queue::const_iterator Queue::end() const {
+    return const_iterator(nullptr);
+}
+
 int Queue::size() {
     /*------------------------------------------------------------*
      *  size                                                      *
@@ -120,13 +188,46 @@ int Queue::size() {
      *  Postcondition: Returns the number of orders currently in  *
      *                 the queue.                                 *
      *------------------------------------------------------------*/
-    int count = 0;
-    NodePtr current = front;
-    while (current != nullptr) {
-        count++;
-        current = current->next;
+    return (int) distance(begin(), end());
+}
+
+void Queue::addOrder(const DynamicArrayList &menu) {
+    /*------------------------------------------------------------*
+     *  addOrder                                                  *
+     *  Reads the customer name and item IDs (0 to finish) and    *
+     *  builds the order directly in a new node.                  *
+     *                                                            *
+     *  Precondition:  menu holds the items that can be ordered.  *
+     *  Postcondition: A new active order is at the back of the   *
+     *                 queue.                                     *
+     *------------------------------------------------------------*/
+    string customerName;
+    cout << "Enter the customer name: ";
+    cin.ignore();
+    getline(cin, customerName);
+
+    menu.display();
+    Order order(customerName, OrderLines());
+    while (true) {
+        int id;
+        cout << "Enter a menu item ID to add (0 to finish): ";
+        if (!(cin >> id) || id == 0) {
+            break;
+        }
+        int index = menu.findById(id);
+        if (index == -1) {
+            cout << "Menu item with ID " << id << " not found." << endl;
+            continue;
+        }
+        order.addItem(menu.getMenuItem(index)); // the same item again is one more unit on its line
     }
-    return count;
+
+    if (order.getLines().empty()) {
+        cout << "Order has no items and was not added." << endl;
+        return;
+    }
+    const ElementType &added = emplace(std::move(order));
+    cout << "Order " << added.getOrderId() << " added to the queue." << endl;
 }
 
 void Queue::processNextOrder(Stack* stack){
@@ -137,10 +238,102 @@ void Queue::processNextOrder(Stack* stack){
      *  Precondition:  The queue is not empty.                    *
      *  Postcondition: The next order in the queue is processed.  *
      *------------------------------------------------------------*/
-    try {
-        ElementType order = dequeue();
-        stack->push(order);
-    } catch (const runtime_error &e) {
-        cerr << "Error: " << e.what() << endl;
+    // Relink the front node rather than copying its order
+    if (processNextOrders(stack, 1) == 0) {
+        cout << "No active orders to process." << endl;
+    }
+}
+
+int Queue::processNextOrders(Stack* stack, int n) {
+    /*------------------------------------------------------------*
+     *  processNextOrders                                         *
+     *  Detaches up to n nodes from the front of the queue and    *
+     *  splices them onto the stack, which updates its revenue    *
+     *  aggregates in a single pass over them.                    *
+     *                                                            *
+     *  Precondition:  stack is a valid Stack object and n >= 0.  *
+     *  Postcondition: The moved orders are on the stack and      *
+     *                 their count is returned.                   *
+     *------------------------------------------------------------*/
+    if (n <= 0 || isEmpty()) {
+        return 0;
+    }
+    LatencyHistogram::Timer timer(processLatency);
+    TRACE_SPAN("Queue::processNextOrders");
+
+    NodePtr first = front;
+    NodePtr last = front;
+    for (int count = 1; count < n && last->next != nullptr; count++) {
+        last = last->next;
+    }
+
+    front = last->next;
+    if (front == nullptr) {
+        back = nullptr;
+    }
+    return stack->appendChain(first, last);
+}
+
+int Queue::drainAll(Stack* stack) {
+    /*------------------------------------------------------------*
+     *  drainAll                                                  *
+     *  Splices the whole chain onto the stack in O(1); the only  *
+     *  walk is the stack's one pass updating its aggregates.     *
+     *                                                            *
+     *  Precondition:  stack is a valid Stack object.             *
+     *  Postcondition: The queue is empty and the number of moved *
+     *                 orders is returned.                        *
+     *------------------------------------------------------------*/
+    NodePtr first = front;
+    NodePtr last = back;
+    front = nullptr;
+    back = nullptr;
+    return stack->appendChain(first, last);
+}
+
+void Queue::relocate() {
+    NodePtr node = front;
+    front = nullptr;
+    back = nullptr;
+    while (node != nullptr) {
+        NodePtr moved = new (nodeMemory) Node(std::move(node->data));
+        if (back == nullptr) {
+            front = moved;
+        } else {
+            back->next = moved;
+        }
+        back = moved;
+        NodePtr next = node->next;
+        delete node;
+        node = next;
     }
-}
\ No newline at end of file
+}
+
+bool Queue::removeOrder(int64_t orderId) {
+    /*------------------------------------------------------------*
+     *  removeOrder                                               *
+     *  Unlinks and frees the first node holding orderId.         *
+     *------------------------------------------------------------*/
+    NodePtr previous = nullptr;
+    for (NodePtr node = front; node != nullptr; previous = node, node = node->next) {
+        if (node->data.getOrderId() != orderId) {
+            continue;
+        }
+        if (previous == nullptr) {
+            front = node->next;
+        } else {
+            previous->next = node->next;
+        }
+        if (back == node) {
+            back = previous;
+        }
+        TRACE_ORDER_END(orderId);
+        delete node;
+        return true;
+    }
+    return false;
+}
+
+void Queue::setListener(OrderListener *listener) {
+    this->listener = listener;
+}
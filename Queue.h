@@ -3,6 +3,7 @@
 
 #include "Order.h" // Include Order.h before using ElementType
 #include "Stack.h"
+#include "OrderListener.h"
 
 
 #include <iostream>
@@ -17,12 +18,35 @@ using namespace std;
  *------------------------------------------------------------------------*/
 class Queue {
 public:
+    typedef OrderChainIterator const_iterator; // iterates front to back
+
     /*------------------------------------------------------------------------*
      *  Queue                                                                 *
      *  Default constructor. Initializes an empty Queue object.               *
      *------------------------------------------------------------------------*/
     Queue();
 
+    /*------------------------------------------------------------------------*
+     *  Queue                                                                 *
+     *  Move constructor. Takes over the node chain of another Queue.         *
+     *                                                                        *
+     *  Precondition:  queue is a valid Queue object.                         *
+     *  Postcondition: This queue owns queue's orders; queue is left empty.   *
+     *------------------------------------------------------------------------*/
+    Queue(Queue &&queue) noexcept;
+
+    /*------------------------------------------------------------------------*
+     *  operator=                                                             *
+     *  Move assignment. Releases this queue's orders and takes over those    *
+     *  of queue.                                                             *
+     *------------------------------------------------------------------------*/
+    Queue &operator=(Queue &&queue) noexcept;
+
+    // Active orders are moved between containers, never duplicated
+    Queue(const Queue &queue) = delete;
+
+    Queue &operator=(const Queue &queue) = delete;
+
     /*------------------------------------------------------------------------*
      *  ~Queue                                                                *
      *  Destructor. Deallocates the memory used by the queue.                 *
@@ -36,14 +60,32 @@ public:
      *  Precondition:  value is a valid Order object.                         *
      *  Postcondition: value is added to the back of the queue.               *
      *------------------------------------------------------------------------*/
-    void enqueue(ElementType value);
+    void enqueue(const ElementType &value);
+
+    void enqueue(ElementType &&value);
+
+    /*------------------------------------------------------------------------*
+     *  emplace                                                               *
+     *  Builds an order in place at the back of the queue from Order          *
+     *  constructor arguments.                                                *
+     *                                                                        *
+     *  Precondition:  args are valid arguments for an Order constructor.     *
+     *  Postcondition: The new order is at the back of the queue and is       *
+     *                 returned.                                              *
+     *------------------------------------------------------------------------*/
+    template <typename... Args>
+    ElementType &emplace(Args &&... args) {
+        NodePtr newNode = new (nodeMemory) Node(in_place, std::forward<Args>(args)...);
+        linkBack(newNode);
+        return newNode->data;
+    }
 
     /*------------------------------------------------------------------------*
      *  dequeue                                                               *
      *  Removes and returns the front order from the queue.                   *
      *                                                                        *
      *  Precondition:  The queue is not empty.                                *
-     *  Postcondition: The front order is removed from the queue and          *
+     *  Postcondition: The front order is moved out of the queue and          *
      *                 returned.                                              *
      *------------------------------------------------------------------------*/
     ElementType dequeue();
@@ -55,7 +97,7 @@ public:
      *  Precondition:  The queue is not empty.                                *
      *  Postcondition: The front order is returned without removing it.       *
      *------------------------------------------------------------------------*/
-    ElementType peek();
+    const ElementType &peek();
 
     /*------------------------------------------------------------------------*
      *  isEmpty                                                               *
@@ -76,14 +118,25 @@ public:
      *------------------------------------------------------------------------*/
     int size();
 
+    /*------------------------------------------------------------------------*
+     *  begin / end                                                           *
+     *  Read-only iteration over the active orders, front to back.            *
+     *                                                                        *
+     *  Precondition:  The queue is not modified while iterating.             *
+     *  Postcondition: The queue is unchanged.                                *
+     *------------------------------------------------------------------------*/
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
     /*------------------------------------------------------------------------*
      *  print                                                                 *
-     *  Prints the orders in the queue.                                       *
+     *  Prints the orders in the queue, with item names looked up in menu.    *
      *                                                                        *
      *  Precondition: None.                                                   *
      *  Postcondition: The orders in the queue are printed to the console.    *
      *------------------------------------------------------------------------*/
-    void print();
+    void print(const DynamicArrayList &menu);
 
     /*------------------------------------------------------------------------*
      *  clear                                                                 *
@@ -94,6 +147,16 @@ public:
      *------------------------------------------------------------------------*/
     void clear();
 
+    /*------------------------------------------------------------------------*
+     *  addOrder                                                              *
+     *  Prompts the user for a customer name and the IDs of the ordered menu *
+     *  items, then adds the new order to the back of the queue.              *
+     *                                                                        *
+     *  Precondition:  menu holds the items that can be ordered.              *
+     *  Postcondition: A new active order is at the back of the queue.        *
+     *------------------------------------------------------------------------*/
+    void addOrder(const DynamicArrayList &menu);
+
     /*------------------------------------------------------------------------*
      *  processNextOrder                                                      *
      *  Processes the next order in the queue.                                *
@@ -103,29 +166,80 @@ public:
      *------------------------------------------------------------------------*/
     void processNextOrder(Stack* stack);
 
+    /*------------------------------------------------------------------------*
+     *  processNextOrders                                                     *
+     *  Moves up to n orders from the front of the queue onto the stack by    *
+     *  relinking their nodes. No order is copied or reallocated.             *
+     *                                                                        *
+     *  Precondition:  stack is a valid Stack object and n >= 0.              *
+     *  Postcondition: The first min(n, size()) orders are on the stack in    *
+     *                 queue order, and the number of moved orders is        *
+     *                 returned.                                              *
+     *------------------------------------------------------------------------*/
+    int processNextOrders(Stack* stack, int n);
+
+    /*------------------------------------------------------------------------*
+     *  drainAll                                                              *
+     *  Moves every order in the queue onto the stack with a single splice.   *
+     *                                                                        *
+     *  Precondition:  stack is a valid Stack object.                         *
+     *  Postcondition: The queue is empty, its orders are on the stack in    *
+     *                 queue order, and the number of moved orders is        *
+     *                 returned.                                              *
+     *------------------------------------------------------------------------*/
+    int drainAll(Stack* stack);
+
+    /*------------------------------------------------------------------------*
+     *  removeOrder                                                           *
+     *  Removes the first order with the given ID, wherever it is queued.     *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: Returns true if an order was found and removed.        *
+     *------------------------------------------------------------------------*/
+    bool removeOrder(int64_t orderId);
+
+    /*------------------------------------------------------------------------*
+     *  setListener                                                           *
+     *  Registers the observer told about every order linked into the queue,  *
+     *  or removes it when given nullptr.                                     *
+     *                                                                        *
+     *  Precondition:  listener outlives the queue or is replaced first.      *
+     *  Postcondition: Later enqueues are reported to listener.               *
+     *------------------------------------------------------------------------*/
+    void setListener(OrderListener *listener);
+
+    /*------------------------------------------------------------------------*
+     *  relocate                                                              *
+     *  Moves every order into a newly allocated node, so the queue no        *
+     *  longer uses memory of the shift arena that was current when its      *
+     *  nodes were made.                                                      *
+     *                                                                        *
+     *  Precondition:  No other thread uses the queue.                        *
+     *  Postcondition: Same orders in the same order; the listener is not    *
+     *                 told, nothing was enqueued.                            *
+     *------------------------------------------------------------------------*/
+    void relocate();
+
 private:
-    struct Node {
-        ElementType data; // Data stored in the node
-
-        Node *next; // Pointer to the next node in the queue
-
-        /*------------------------------------------------------------*
-         *  Node                                                      *
-         *  Parameterized constructor. Initializes a Node object with *
-         *  the provided data.                                        *
-         *                                                            *
-         *  Precondition:  data is a valid ElementType.               *
-         *  Postcondition: A new Node object is created with the data *
-         *                 and next pointer set.                      *
-         *------------------------------------------------------------*/
-        Node(ElementType data) : data(data), next(nullptr){
-        }
-    };
+    typedef OrderNode Node; // Node type shared with Stack
 
     typedef Node *NodePtr; // Pointer to a Node
 
+    static CountingResource nodeMemory; // nodes of every queue, until they are spliced onto a stack
+
     NodePtr front; // Pointer to the front of the queue
     NodePtr back; // Pointer to the back of the queue
+
+    OrderListener *listener; // Told about each enqueued order, may be nullptr
+
+    /*------------------------------------------------------------------------*
+     *  linkBack                                                              *
+     *  Links an already built node at the back of the queue.                 *
+     *                                                                        *
+     *  Precondition:  newNode is not part of any container.                  *
+     *  Postcondition: newNode is the back of the queue.                      *
+     *------------------------------------------------------------------------*/
+    void linkBack(NodePtr newNode);
 };
 
 
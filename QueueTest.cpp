@@ -0,0 +1,62 @@
+#include <vector>
+
+#include "Queue.h"
+#include "Stack.h"
+#include "TestCheck.h"
+#include "TestOrders.h"
+
+using namespace std;
+
+namespace {
+    // Queues orders 1..count; order i has i % 3 + 1 lines
+    double fill(Queue &queue, int count) {
+        double revenue = 0;
+        for (int i = 1; i <= count; i++) {
+            Order order = testOrder(i, "Ada", i % 3 + 1);
+            revenue += order.getTotalAmount();
+            queue.enqueue(std::move(order));
+        }
+        return revenue;
+    }
+
+    void testProcessNextOrders() {
+        Queue queue;
+        Stack stack;
+        double revenue = fill(queue, 10);
+        CHECK(queue.processNextOrders(&stack, 0) == 0 && stack.getSize() == 0);
+        CHECK(queue.processNextOrders(&stack, 3) == 3);
+        CHECK(orderIds(stack) == vector<int64_t>({1, 2, 3}));
+        CHECK(orderIds(queue) == vector<int64_t>({4, 5, 6, 7, 8, 9, 10}));
+
+        // Asking for more than is queued moves what there is
+        CHECK(queue.processNextOrders(&stack, 50) == 7);
+        CHECK(queue.isEmpty() && queue.size() == 0 && stack.getSize() == 10);
+        CHECK(stack.getTotalRevenue() == revenue);
+        CHECK(queue.processNextOrders(&stack, 1) == 0);
+
+        // The emptied queue links new orders from scratch
+        fill(queue, 2);
+        CHECK(queue.size() == 2 && queue.peek().getOrderId() == 1);
+    }
+
+    void testDrainAll() {
+        Queue queue;
+        Stack stack;
+        stack.push(testOrder(100, "Grace", 1));
+        double revenue = stack.getTotalRevenue() + fill(queue, 1000);
+        CHECK(queue.drainAll(&stack) == 1000);
+        CHECK(queue.isEmpty() && stack.getSize() == 1001);
+        CHECK(stack.getTotalRevenue() == revenue);
+        CHECK(stack.getRollup().lastDays(1).orders == 1001);
+
+        vector<int64_t> ids = orderIds(stack);
+        CHECK(ids.front() == 100 && ids[1] == 1 && ids.back() == 1000);
+        CHECK(queue.drainAll(&stack) == 0 && stack.getSize() == 1001);
+    }
+}
+
+int main() {
+    testProcessNextOrders();
+    testDrainAll();
+    return testResult();
+}
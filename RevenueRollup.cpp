@@ -0,0 +1,122 @@
+#include "RevenueRollup.h"
+#include "LocalTime.h"
+
+#include <iomanip>
+#include <iostream>
+
+RevenueRollup::Ring::Ring(int size, long long width, bool local)
+    : slots(size, Bucket{0, 0, 0}), numbers(size, -1), width(width), local(local) {
+}
+
+long long RevenueRollup::Ring::numberOf(time_t when) const {
+    return (local ? localSeconds(when) : (long long) when) / width;
+}
+
+void RevenueRollup::Ring::add(time_t when, double revenue, int orders) {
+    /*------------------------------------------------------------*
+     *  add                                                       *
+     *  A slot still holding an older bucket number is stale and  *
+     *  is reset before it is reused. A record older than the     *
+     *  bucket in its slot is older than the ring covers, and is  *
+     *  dropped rather than wiping the newer bucket.              *
+     *------------------------------------------------------------*/
+    long long number = numberOf(when);
+    int slot = (int) (number % (long long) slots.size());
+    if (number < numbers[slot]) {
+        return;
+    }
+    if (number > numbers[slot]) {
+        numbers[slot] = number;
+        slots[slot].revenue = 0;
+        slots[slot].orders = 0;
+    }
+    slots[slot].revenue += revenue;
+    slots[slot].orders += orders;
+}
+
+RevenueRollup::Bucket RevenueRollup::Ring::at(long long number) const {
+    int slot = (int) (number % (long long) slots.size());
+    Bucket bucket{local ? fromLocalSeconds(number * width) : (time_t) (number * width), 0, 0};
+    if (numbers[slot] == number) {
+        bucket.revenue = slots[slot].revenue;
+        bucket.orders = slots[slot].orders;
+    }
+    return bucket;
+}
+
+RevenueRollup::Bucket RevenueRollup::Ring::sum(time_t now, int count) const {
+    if (count > (int) slots.size()) {
+        count = (int) slots.size();
+    }
+    long long newest = numberOf(now);
+    Bucket total = at(newest - count + 1);
+    for (long long number = newest - count + 2; number <= newest; number++) {
+        Bucket bucket = at(number);
+        total.revenue += bucket.revenue;
+        total.orders += bucket.orders;
+    }
+    return total;
+}
+
+RevenueRollup::RevenueRollup()
+    : minutes(MINUTE_BUCKETS, 60, false), hours(HOUR_BUCKETS, 3600, true), days(DAY_BUCKETS, 86400, true) {
+}
+
+void RevenueRollup::record(time_t when, double revenue, int orders) {
+    minutes.add(when, revenue, orders);
+    hours.add(when, revenue, orders);
+    days.add(when, revenue, orders);
+}
+
+RevenueRollup::Bucket RevenueRollup::lastMinutes(int count, time_t now) const {
+    return minutes.sum(now, count);
+}
+
+RevenueRollup::Bucket RevenueRollup::lastHours(int count, time_t now) const {
+    return hours.sum(now, count);
+}
+
+RevenueRollup::Bucket RevenueRollup::lastDays(int count, time_t now) const {
+    return days.sum(now, count);
+}
+
+vector<RevenueRollup::Bucket> RevenueRollup::todayByHour(time_t now) const {
+    /*------------------------------------------------------------*
+     *  todayByHour                                               *
+     *  Hours are counted on the wall clock: on the day clocks go *
+     *  forward the skipped hour is returned empty, and on the    *
+     *  day they go back the repeated hour shares one bucket.     *
+     *------------------------------------------------------------*/
+    long long localTime = localSeconds(now);
+    long long midnightHour = localTime / 86400 * 24;
+    vector<Bucket> result;
+    for (long long number = midnightHour; number <= localTime / 3600; number++) {
+        result.push_back(hours.at(number));
+    }
+    return result;
+}
+
+void RevenueRollup::display(time_t now) const {
+    Bucket quarter = lastMinutes(15, now);
+    Bucket hour = lastMinutes(60, now);
+    Bucket today = lastDays(1, now);
+
+    cout << fixed << setprecision(2);
+    cout << "Last 15 minutes: $" << quarter.revenue << " from " << quarter.orders
+         << " orders (avg $" << quarter.averageTicket() << ")" << endl;
+    cout << "Last hour:       $" << hour.revenue << " from " << hour.orders
+         << " orders (avg $" << hour.averageTicket() << ")" << endl;
+    cout << "Today:           $" << today.revenue << " from " << today.orders
+         << " orders (avg $" << today.averageTicket() << ")" << endl;
+
+    cout << "Today by hour:" << endl;
+    vector<Bucket> byHour = todayByHour(now);
+    for (int hourOfDay = 0; hourOfDay < (int) byHour.size(); hourOfDay++) {
+        if (byHour[hourOfDay].orders == 0) {
+            continue;
+        }
+        cout << "  " << setw(2) << setfill('0') << hourOfDay << ":00  $" << setfill(' ')
+             << byHour[hourOfDay].revenue << " from " << byHour[hourOfDay].orders << " orders" << endl;
+    }
+    cout << defaultfloat << setprecision(6);
+}
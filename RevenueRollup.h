@@ -0,0 +1,106 @@
+#ifndef REVENUEROLLUP_H
+#define REVENUEROLLUP_H
+
+#include <ctime>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  RevenueRollup                                                         *
+ *  Revenue and order counts per minute, per hour and per day, kept in    *
+ *  fixed-size rings of buckets. Recording an order touches one bucket    *
+ *  per ring, and a query reads only the buckets it covers, never the     *
+ *  orders themselves. Hour and day buckets follow the local wall clock, *
+ *  so a day starts at local midnight also after a daylight saving        *
+ *  change; minute buckets count elapsed minutes.                         *
+ *------------------------------------------------------------------------*/
+class RevenueRollup {
+public:
+    /*------------------------------------------------------------------------*
+     *  Bucket                                                                *
+     *  Totals of one time slot. start is the local time at which it begins. *
+     *------------------------------------------------------------------------*/
+    struct Bucket {
+        time_t start;
+        double revenue;
+        int orders;
+
+        double averageTicket() const { return orders == 0 ? 0 : revenue / orders; }
+    };
+
+    static const int MINUTE_BUCKETS = 60; // the last hour, minute by minute
+    static const int HOUR_BUCKETS = 48; // the last two days, hour by hour
+    static const int DAY_BUCKETS = 31; // the last month, day by day
+
+    /*------------------------------------------------------------------------*
+     *  RevenueRollup                                                         *
+     *  Default constructor. Starts with every bucket empty.                  *
+     *------------------------------------------------------------------------*/
+    RevenueRollup();
+
+    /*------------------------------------------------------------------------*
+     *  record                                                                *
+     *  Adds completed revenue to the minute, hour and day buckets of when.   *
+     *                                                                        *
+     *  Precondition:  when is not older than the oldest day bucket.          *
+     *  Postcondition: Every ring covering when includes the revenue.         *
+     *------------------------------------------------------------------------*/
+    void record(time_t when, double revenue, int orders = 1);
+
+    /*------------------------------------------------------------------------*
+     *  lastMinutes / lastHours / lastDays                                    *
+     *  Totals of the last count buckets of a ring, the current partial one   *
+     *  included. count is capped at the size of the ring.                    *
+     *                                                                        *
+     *  Precondition:  count > 0.                                             *
+     *  Postcondition: A bucket summing the covered range is returned; its   *
+     *                 start is the start of the oldest covered bucket.       *
+     *------------------------------------------------------------------------*/
+    Bucket lastMinutes(int count, time_t now = time(0)) const;
+
+    Bucket lastHours(int count, time_t now = time(0)) const;
+
+    Bucket lastDays(int count, time_t now = time(0)) const;
+
+    /*------------------------------------------------------------------------*
+     *  todayByHour                                                           *
+     *  Returns one bucket per hour from local midnight up to now.            *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: Hours without orders are returned with zero totals.    *
+     *------------------------------------------------------------------------*/
+    vector<Bucket> todayByHour(time_t now = time(0)) const;
+
+    /*------------------------------------------------------------------------*
+     *  display                                                               *
+     *  Prints the last 15 minutes, the last hour, today and today by hour.   *
+     *------------------------------------------------------------------------*/
+    void display(time_t now = time(0)) const;
+
+private:
+    // A ring of buckets of width seconds; slot i holds bucket numbers == i mod size
+    struct Ring {
+        vector<Bucket> slots;
+        vector<long long> numbers; // bucket number stored in each slot, -1 if unused
+        long long width;
+        bool local; // buckets numbered on the local wall clock rather than UTC
+
+        Ring(int size, long long width, bool local);
+
+        // Bucket number of a point in time
+        long long numberOf(time_t when) const;
+
+        void add(time_t when, double revenue, int orders);
+
+        Bucket sum(time_t now, int count) const;
+
+        Bucket at(long long number) const;
+    };
+
+    Ring minutes; // per-minute ring
+    Ring hours; // per-hour ring
+    Ring days; // per-day ring
+};
+
+#endif //REVENUEROLLUP_H
@@ -0,0 +1,67 @@
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+#include "RevenueRollup.h"
+#include "TestCheck.h"
+
+using namespace std;
+
+namespace {
+    // A local wall-clock time in the test's time zone
+    time_t localAt(int year, int month, int day, int hour, int minute) {
+        tm fields{};
+        fields.tm_year = year - 1900;
+        fields.tm_mon = month - 1;
+        fields.tm_mday = day;
+        fields.tm_hour = hour;
+        fields.tm_min = minute;
+        fields.tm_isdst = -1;
+        return mktime(&fields);
+    }
+
+    // Late in the evening of a winter day and just after midnight of a summer day,
+    // which a single offset for the whole year puts on the wrong day
+    void testDaysFollowTheOffsetOfTheirDate() {
+        RevenueRollup winter;
+        winter.record(localAt(2024, 1, 15, 23, 30), 10);
+        RevenueRollup::Bucket winterDay = winter.lastDays(1, localAt(2024, 1, 15, 23, 45));
+        CHECK(winterDay.orders == 1 && winterDay.start == localAt(2024, 1, 15, 0, 0));
+        vector<RevenueRollup::Bucket> winterHours = winter.todayByHour(localAt(2024, 1, 15, 23, 45));
+        CHECK(winterHours.size() == 24 && winterHours[23].orders == 1);
+
+        RevenueRollup summer;
+        summer.record(localAt(2024, 7, 15, 0, 30), 20);
+        RevenueRollup::Bucket summerDay = summer.lastDays(1, localAt(2024, 7, 15, 0, 45));
+        CHECK(summerDay.orders == 1 && summerDay.start == localAt(2024, 7, 15, 0, 0));
+        vector<RevenueRollup::Bucket> summerHours = summer.todayByHour(localAt(2024, 7, 15, 0, 45));
+        CHECK(summerHours.size() == 1 && summerHours[0].orders == 1 && summerHours[0].revenue == 20);
+    }
+
+    // Clocks go forward at 2:00 on 2024-03-10, a day of 23 hours
+    void testAcrossTheChange() {
+        RevenueRollup rollup;
+        rollup.record(localAt(2024, 3, 9, 23, 0), 5);
+        rollup.record(localAt(2024, 3, 10, 1, 50), 7);
+        rollup.record(localAt(2024, 3, 10, 23, 30), 9);
+
+        time_t now = localAt(2024, 3, 10, 23, 45);
+        CHECK(rollup.lastDays(1, now).orders == 2 && rollup.lastDays(1, now).revenue == 16);
+        CHECK(rollup.lastDays(2, now).orders == 3);
+
+        vector<RevenueRollup::Bucket> byHour = rollup.todayByHour(now);
+        CHECK(byHour.size() == 24);
+        CHECK(byHour[1].orders == 1 && byHour[2].orders == 0 && byHour[23].orders == 1);
+
+        // Minutes count elapsed time: 1:50 is twenty minutes before 3:10 that day
+        CHECK(rollup.lastMinutes(30, localAt(2024, 3, 10, 3, 10)).orders == 1);
+    }
+}
+
+int main() {
+    setenv("TZ", "EST5EDT,M3.2.0,M11.1.0", 1);
+    tzset();
+    testDaysFollowTheOffsetOfTheirDate();
+    testAcrossTheChange();
+    return testResult();
+}
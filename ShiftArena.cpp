@@ -0,0 +1,105 @@
+#include "ShiftArena.h"
+
+#include <new>
+
+namespace {
+    // Placed in front of every node; keeps the node max-aligned
+    struct alignas(max_align_t) NodeHeader {
+        ShiftArena *arena; // where the node came from, nullptr for the heap
+        CountingResource *memory; // structure the node is charged to, may be nullptr
+    };
+}
+
+atomic<ShiftArena *> ShiftArena::current(nullptr);
+
+ShiftArena::ShiftArena(size_t blockBytes) : blocks(blockBytes), liveCount(0), allocatedBytes(0) {
+}
+
+bool ShiftArena::release() {
+    lock_guard<mutex> guard(lock);
+    if (liveCount > 0) {
+        return false;
+    }
+    blocks.release();
+    allocatedBytes = 0;
+    return true;
+}
+
+size_t ShiftArena::getLiveCount() const {
+    lock_guard<mutex> guard(lock);
+    return liveCount;
+}
+
+size_t ShiftArena::getAllocatedBytes() const {
+    lock_guard<mutex> guard(lock);
+    return allocatedBytes;
+}
+
+void ShiftArena::setCurrent(ShiftArena *arena) {
+    current.store(arena, memory_order_release);
+}
+
+ShiftArena *ShiftArena::getCurrent() {
+    return current.load(memory_order_acquire);
+}
+
+void *ShiftArena::allocateNode(size_t size, CountingResource *memory) {
+    ShiftArena *arena = getCurrent();
+    size_t bytes = sizeof(NodeHeader) + size;
+    void *block = arena != nullptr ? arena->allocate(bytes, alignof(NodeHeader)) : ::operator new(bytes);
+    NodeHeader *header = new(block) NodeHeader{arena, memory};
+    if (memory != nullptr) {
+        memory->recordAllocation(bytes);
+    }
+    return header + 1;
+}
+
+void ShiftArena::deallocateNode(void *node, size_t size) {
+    if (node == nullptr) {
+        return;
+    }
+    NodeHeader *header = static_cast<NodeHeader *>(node) - 1;
+    size_t bytes = sizeof(NodeHeader) + size;
+    if (header->memory != nullptr) {
+        header->memory->recordDeallocation(bytes);
+    }
+    if (header->arena != nullptr) {
+        header->arena->deallocate(header, bytes, alignof(NodeHeader));
+    } else {
+        ::operator delete(header);
+    }
+}
+
+void ShiftArena::chargeNode(void *node, size_t size, CountingResource *memory) {
+    NodeHeader *header = static_cast<NodeHeader *>(node) - 1;
+    if (header->memory == memory) {
+        return;
+    }
+    size_t bytes = sizeof(NodeHeader) + size;
+    if (header->memory == nullptr) {
+        memory->recordAllocation(bytes); // an uncharged node is new to the books
+    } else if (memory == nullptr) {
+        header->memory->recordDeallocation(bytes);
+    } else {
+        header->memory->moveTo(*memory, bytes, 1);
+    }
+    header->memory = memory;
+}
+
+void *ShiftArena::do_allocate(size_t bytes, size_t alignment) {
+    lock_guard<mutex> guard(lock);
+    void *block = blocks.allocate(bytes, alignment);
+    liveCount++;
+    allocatedBytes += bytes;
+    return block;
+}
+
+void ShiftArena::do_deallocate(void *, size_t, size_t) {
+    // Monotonic: the memory comes back with release()
+    lock_guard<mutex> guard(lock);
+    liveCount--;
+}
+
+bool ShiftArena::do_is_equal(const pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,109 @@
+#ifndef SHIFTARENA_H
+#define SHIFTARENA_H
+
+#include "CountingResource.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  ShiftArena                                                            *
+ *  Monotonic memory for the orders of one shift. Allocating bumps a      *
+ *  pointer through large blocks; freeing does nothing until release()   *
+ *  hands every block back at once when the shift closes, so a long      *
+ *  shift neither pays per-order heap calls nor fragments the heap.       *
+ *                                                                        *
+ *  Opt-in: order nodes come from the arena made current with            *
+ *  setCurrent(), and from the heap while none is. Memory freed during   *
+ *  the shift (deleted orders, orders spilled to disk) is only reused     *
+ *  after the release, so enable it for shifts that close regularly.      *
+ *------------------------------------------------------------------------*/
+class ShiftArena : public pmr::memory_resource {
+public:
+    /*------------------------------------------------------------------------*
+     *  ShiftArena                                                            *
+     *  Parameterized constructor. Blocks start at blockBytes and grow        *
+     *  geometrically.                                                        *
+     *                                                                        *
+     *  Precondition:  blockBytes > 0.                                        *
+     *  Postcondition: Nothing is allocated until the first order.            *
+     *------------------------------------------------------------------------*/
+    explicit ShiftArena(size_t blockBytes = 64 * 1024);
+
+    ShiftArena(const ShiftArena &arena) = delete;
+
+    ShiftArena &operator=(const ShiftArena &arena) = delete;
+
+    /*------------------------------------------------------------------------*
+     *  release                                                               *
+     *  Frees every block at once. Refused while an allocation is still in   *
+     *  use, e.g. an active order that was not moved off the arena.          *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: Returns true if the memory was freed; the arena can   *
+     *                 then serve the next shift.                             *
+     *------------------------------------------------------------------------*/
+    bool release();
+
+    // Allocations not yet given back
+    size_t getLiveCount() const;
+
+    // Bytes handed out since the last release
+    size_t getAllocatedBytes() const;
+
+    /*------------------------------------------------------------------------*
+     *  setCurrent                                                            *
+     *  Makes arena the source of new order nodes; nullptr returns to the    *
+     *  heap. Nodes already allocated keep their memory.                      *
+     *                                                                        *
+     *  Precondition:  arena outlives every node allocated from it.           *
+     *  Postcondition: allocateNode uses arena.                               *
+     *------------------------------------------------------------------------*/
+    static void setCurrent(ShiftArena *arena);
+
+    static ShiftArena *getCurrent();
+
+    /*------------------------------------------------------------------------*
+     *  allocateNode / deallocateNode                                         *
+     *  Allocate from the current arena, or the heap, with a small header     *
+     *  recording which, so a node is freed to wherever it came from even if *
+     *  the current arena changed in between. The header also records the    *
+     *  structure the node is charged to, if any, which is told about the    *
+     *  free. size is the node's own, as given to allocateNode.               *
+     *------------------------------------------------------------------------*/
+    static void *allocateNode(size_t size, CountingResource *memory = nullptr);
+
+    static void deallocateNode(void *node, size_t size);
+
+    /*------------------------------------------------------------------------*
+     *  chargeNode                                                            *
+     *  Moves a node of size bytes to memory's account, e.g. when it is      *
+     *  relinked into another container.                                      *
+     *                                                                        *
+     *  Precondition:  node came from allocateNode with the same size.        *
+     *  Postcondition: memory, not the previous structure, holds the node.   *
+     *------------------------------------------------------------------------*/
+    static void chargeNode(void *node, size_t size, CountingResource *memory);
+
+protected:
+    // pmr::memory_resource
+    void *do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void *block, size_t bytes, size_t alignment) override;
+
+    bool do_is_equal(const pmr::memory_resource &other) const noexcept override;
+
+private:
+    mutable mutex lock; // the monotonic resource is not thread-safe
+    pmr::monotonic_buffer_resource blocks; // the shift's memory
+    size_t liveCount; // allocations not yet given back
+    size_t allocatedBytes; // bytes handed out since the last release
+
+    static atomic<ShiftArena *> current; // source of new nodes, nullptr for the heap
+};
+
+#endif //SHIFTARENA_H
@@ -0,0 +1,67 @@
+#include <vector>
+
+#include "Queue.h"
+#include "ShiftArena.h"
+#include "Stack.h"
+#include "TestCheck.h"
+#include "TestOrders.h"
+
+using namespace std;
+
+namespace {
+    // A shift's order nodes come from the arena and go back in one release once none is live
+    void testShift() {
+        ShiftArena arena(4096);
+        ShiftArena::setCurrent(&arena);
+        Queue queue;
+        {
+            Stack stack;
+            for (int i = 1; i <= 100; i++) {
+                queue.enqueue(testOrder(i, "Ada", 3));
+            }
+            CHECK(arena.getLiveCount() == 100 && arena.getAllocatedBytes() > 100 * sizeof(Order));
+            CHECK(queue.processNextOrders(&stack, 60) == 60); // spliced nodes keep their memory
+            CHECK(arena.getLiveCount() == 100);
+            CHECK(!arena.release()); // orders still live in it
+        }
+        CHECK(arena.getLiveCount() == 40);
+
+        // Closing the shift moves the orders still active to the heap
+        ShiftArena::setCurrent(nullptr);
+        queue.relocate();
+        CHECK(arena.getLiveCount() == 0);
+        CHECK(arena.release() && arena.getAllocatedBytes() == 0);
+        vector<int64_t> ids = orderIds(queue);
+        CHECK(ids.size() == 40 && ids.front() == 61 && ids.back() == 100);
+        CHECK(queue.peek().getLines().size() == 3 && queue.peek().getCustomerName() == "Ada");
+
+        // Without a current arena nodes come from the heap; the next shift uses the arena again
+        queue.enqueue(testOrder(101, "Grace"));
+        CHECK(arena.getLiveCount() == 0);
+        ShiftArena::setCurrent(&arena);
+        queue.enqueue(testOrder(102, "Grace"));
+        CHECK(arena.getLiveCount() == 1);
+        queue.clear();
+        CHECK(arena.getLiveCount() == 0);
+        ShiftArena::setCurrent(nullptr);
+    }
+
+    // As a memory_resource the arena counts allocations the same way
+    void testMemoryResource() {
+        ShiftArena arena;
+        void *first = arena.allocate(100, 8);
+        void *second = arena.allocate(3000, 64);
+        CHECK(first != second && (size_t) second % 64 == 0);
+        CHECK(arena.getLiveCount() == 2 && arena.getAllocatedBytes() >= 3100);
+        arena.deallocate(first, 100, 8);
+        CHECK(!arena.release());
+        arena.deallocate(second, 3000, 64);
+        CHECK(arena.release() && arena.getLiveCount() == 0);
+    }
+}
+
+int main() {
+    testShift();
+    testMemoryResource();
+    return testResult();
+}
@@ -0,0 +1,154 @@
+#ifndef SMALLVECTOR_H
+#define SMALLVECTOR_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  SmallVector                                                           *
+ *  Growable array that keeps its first N elements inside the object and  *
+ *  only moves to the heap beyond that. Elements must be trivially        *
+ *  copyable, so copying, moving and growing are plain memcpy calls.      *
+ *------------------------------------------------------------------------*/
+template <typename T, size_t N>
+class SmallVector {
+    static_assert(is_trivially_copyable<T>::value, "SmallVector holds trivially copyable elements only");
+
+public:
+    typedef T *iterator;
+    typedef const T *const_iterator;
+
+    SmallVector() : items(inlineItems()), count(0), capacity(N) {
+    }
+
+    SmallVector(const SmallVector &other) : items(inlineItems()), count(0), capacity(N) {
+        assign(other);
+    }
+
+    SmallVector(SmallVector &&other) noexcept : items(inlineItems()), count(0), capacity(N) {
+        take(other);
+    }
+
+    SmallVector &operator=(const SmallVector &other) {
+        if (this != &other) {
+            count = 0;
+            assign(other);
+        }
+        return *this;
+    }
+
+    SmallVector &operator=(SmallVector &&other) noexcept {
+        if (this != &other) {
+            release();
+            take(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        release();
+    }
+
+    // Appends value, moving to (a larger) heap block when full
+    void push_back(const T &value) {
+        if (count == capacity) {
+            reserve(capacity * 2);
+        }
+        items[count++] = value;
+    }
+
+    // Makes room for at least wanted elements
+    void reserve(size_t wanted) {
+        if (wanted <= capacity) {
+            return;
+        }
+        T *grown = static_cast<T *>(::operator new(wanted * sizeof(T)));
+        memcpy(static_cast<void *>(grown), items, count * sizeof(T));
+        if (!isInline()) {
+            ::operator delete(items);
+        }
+        items = grown;
+        capacity = (uint32_t) wanted;
+    }
+
+    void clear() { count = 0; }
+
+    T &operator[](size_t index) {
+        assert(index < count);
+        return items[index];
+    }
+
+    const T &operator[](size_t index) const {
+        assert(index < count);
+        return items[index];
+    }
+
+    size_t size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+    // True while the elements fit in the object itself
+    bool isInline() const { return items == inlineItems(); }
+
+    // Bytes held on the heap, 0 while inline
+    size_t heapBytes() const { return isInline() ? 0 : capacity * sizeof(T); }
+
+    iterator begin() { return items; }
+
+    iterator end() { return items + count; }
+
+    const_iterator begin() const { return items; }
+
+    const_iterator end() const { return items + count; }
+
+private:
+    alignas(T) unsigned char storage[N * sizeof(T)]; // the inline elements
+    T *items; // storage, or the heap block once grown
+    uint32_t count; // elements in use
+    uint32_t capacity; // elements items can hold
+
+    T *inlineItems() { return reinterpret_cast<T *>(storage); }
+
+    const T *inlineItems() const { return reinterpret_cast<const T *>(storage); }
+
+    // Copies other's elements after ours were dropped
+    void assign(const SmallVector &other) {
+        reserve(other.count);
+        memcpy(static_cast<void *>(items), other.items, other.count * sizeof(T));
+        count = other.count;
+    }
+
+    // Takes other's elements (its heap block if it has one), leaving it empty
+    void take(SmallVector &other) {
+        if (other.isInline()) {
+            items = inlineItems();
+            capacity = N;
+            memcpy(static_cast<void *>(items), other.items, other.count * sizeof(T));
+        } else {
+            items = other.items;
+            capacity = other.capacity;
+            other.items = other.inlineItems();
+            other.capacity = N;
+        }
+        count = other.count;
+        other.count = 0;
+    }
+
+    // Frees the heap block, if any, and goes back to inline storage
+    void release() {
+        if (!isInline()) {
+            ::operator delete(items);
+        }
+        items = inlineItems();
+        capacity = N;
+        count = 0;
+    }
+};
+
+#endif //SMALLVECTOR_H
@@ -1,112 +1,278 @@
 #include "Stack.h"
 #include "FileHandler.h"
+#include "LatencyHistogram.h"
+#include "ParallelOps.h"
+#include "Trace.h"
 
+namespace {
+    LatencyHistogram saveLatency("Stack::saveCompletedOrders");
+}
+
+CountingResource Stack::nodeMemory("Stack");
 
 Stack::Stack() {
     setStack(nullptr, nullptr);
+    total = 0;
+    memoryBudget = 0;
+    residentBytes = 0;
+    residentCount = 0;
+    listener = nullptr;
 }
 
 Stack::Stack(const Stack& other) {
-    currentOrder = nullptr; // Initialize the new stack's top to nullptr
-    if (other.currentOrder != nullptr) {
-        NodePtr current = other.currentOrder;
-        NodePtr temp = new Node(current->data); // Create the first node
-        currentOrder = temp;
-        current = current->next;
-        while (current != nullptr) {
-            temp->next = new Node(current->data); // Create subsequent nodes
-            temp = temp->next;
-            current = current->next;
+    setStack(nullptr, nullptr); // Initialize the new stack's top to nullptr
+    total = other.total;
+    rollup = other.rollup;
+    bestSellers = other.bestSellers;
+    customers = other.customers;
+    history = other.history;
+    lineItems = other.lineItems;
+    memoryBudget = other.memoryBudget;
+    residentBytes = 0;
+    residentCount = 0;
+    listener = nullptr; // the copy is a different container
+    // Copy both tiers of other into memory, then spill again if that is too much
+    for (const ElementType &order : other) {
+        NodePtr temp = new (nodeMemory) Node(order);
+        if (currentOrder == nullptr) {
+            currentOrder = temp; // Create the first node
+        } else {
+            back->next = temp; // Create subsequent nodes
         }
         back = temp; // Set the back pointer to the last node
+        residentBytes += footprint(order);
+        residentCount++;
+    }
+    spillOverBudget();
+}
+
+Stack::Stack(Stack&& other) noexcept {
+    setStack(other.currentOrder, other.back);
+    total = other.total;
+    swap(rollup, other.rollup); // leaves other with our empty rings, which stay usable
+    swap(bestSellers, other.bestSellers);
+    customers = std::move(other.customers);
+    history = std::move(other.history);
+    lineItems = std::move(other.lineItems);
+    memoryBudget = other.memoryBudget;
+    residentBytes = other.residentBytes;
+    residentCount = other.residentCount;
+    cold = std::move(other.cold);
+    listener = other.listener;
+    other.setStack(nullptr, nullptr);
+    other.total = 0;
+    other.residentBytes = 0;
+    other.residentCount = 0;
+}
+
+Stack& Stack::operator=(const Stack& other) {
+    if (this != &other) {
+        Stack copy(other); // Build the copy before releasing our own nodes
+        *this = std::move(copy);
     }
+    return *this;
+}
+
+Stack& Stack::operator=(Stack&& other) noexcept {
+    if (this != &other) {
+        releaseNodes();
+        setStack(other.currentOrder, other.back);
+        total = other.total;
+        swap(rollup, other.rollup);
+        swap(bestSellers, other.bestSellers);
+        customers = std::move(other.customers);
+        history = std::move(other.history);
+        lineItems = std::move(other.lineItems);
+        memoryBudget = other.memoryBudget;
+        residentBytes = other.residentBytes;
+        residentCount = other.residentCount;
+        cold = std::move(other.cold);
+        listener = other.listener;
+        other.setStack(nullptr, nullptr);
+        other.total = 0;
+        other.residentBytes = 0;
+        other.residentCount = 0;
+    }
+    return *this;
 }
 
 Stack::~Stack() {
+    releaseNodes();
+}
+
+void Stack::releaseNodes() {
     while ( currentOrder != nullptr ) {
         NodePtr temp = currentOrder;
         currentOrder = currentOrder->next;
         delete temp;
     }
+    back = nullptr;
+    residentBytes = 0;
+    residentCount = 0;
 }
 
-void Stack::push(const ElementType &order) {
-    if ( currentOrder == nullptr ) {
-        currentOrder = new Node(order);
-        back = currentOrder;
-    } else {
-        back->next = new Node(order);
-        back = back->next;
-        total += order.getTotalAmount();
+void Stack::setMemoryBudget(size_t bytes) {
+    memoryBudget = bytes;
+    spillOverBudget();
+}
+
+size_t Stack::getResidentBytes() const {
+    return residentBytes;
+}
+
+void Stack::setListener(OrderListener *listener) {
+    this->listener = listener;
+}
+
+mutex &Stack::getAppendLock() {
+    return appendLock;
+}
+
+size_t Stack::footprint(const ElementType &order) {
+    return sizeof(Node) + order.getCustomerName().size() + order.getLines().heapBytes();
+}
+
+void Stack::spillOverBudget() {
+    if (memoryBudget == 0 || residentBytes <= memoryBudget) {
+        return;
+    }
+    // Detach the oldest nodes until a quarter of the budget is free again
+    size_t target = memoryBudget - memoryBudget / 4;
+    NodePtr first = currentOrder;
+    NodePtr last = nullptr;
+    size_t count = 0;
+    while (currentOrder != nullptr && residentBytes > target) {
+        residentBytes -= footprint(currentOrder->data);
+        residentCount--;
+        last = currentOrder;
+        currentOrder = currentOrder->next;
+        count++;
+    }
+    last->next = nullptr;
+    if (currentOrder == nullptr) {
+        back = nullptr;
+    }
+
+    if (!cold) {
+        cold = make_unique<OrderSegments>();
     }
+    cold->spill(first, count);
+}
+
+void Stack::push(const ElementType &order) {
+    TRACE_SPAN("Stack::push");
+    NodePtr node = new (nodeMemory) Node(order);
+    appendChain(node, node);
+}
+
+void Stack::push(ElementType &&order) {
+    TRACE_SPAN("Stack::push");
+    NodePtr node = new (nodeMemory) Node(std::move(order));
+    appendChain(node, node);
 }
 
 ElementType Stack::pop() {
+    if (cold && cold->getOrderCount() > 0) {
+        return cold->popOldest();
+    }
     if (currentOrder == nullptr ) {
-        throw "Stack is empty!";
+        throw runtime_error("Stack is empty!");
     }
-    ElementType order = currentOrder->data;
+    residentBytes -= footprint(currentOrder->data);
+    residentCount--;
+    ElementType order = std::move(currentOrder->data);
     NodePtr temp = currentOrder;
     currentOrder = currentOrder->next;
+    if (currentOrder == nullptr) {
+        back = nullptr;
+    }
     delete temp;
     return order;
 }
 
-ElementType Stack::getCurrentOrder() const {
+const ElementType &Stack::getCurrentOrder() const {
+    if (cold && cold->getOrderCount() > 0) {
+        return cold->peekOldest();
+    }
     if ( currentOrder == nullptr ) {
         throw runtime_error("Stack is empty!");
     }
     return currentOrder->data;
 }
 
+bool Stack::isEmpty() const {
+    return getSize() == 0;
+}
+
 int Stack::getSize() const {
-    if ( currentOrder == nullptr ) {
-        return 0;
-    }
-    int size = 1;
-    NodePtr temp = currentOrder;
-    while ( temp -> next != nullptr ) {
-        size++;
-        temp = temp->next;
+    return (int) (cold ? cold->getOrderCount() : 0) + residentCount;
+}
+
+Stack::const_iterator Stack::begin() const {
+    if (!cold) {
+        return const_iterator(nullptr, 0, 0, currentOrder);
     }
-    return size;
+    cold->flush(); // spilled chains are only readable once written
+    return const_iterator(cold.get(), 0, cold->getSegmentCount(), currentOrder);
+}
+
+Stack::const_iterator Stack::end() const {
+    size_t segmentCount = cold ? cold->getSegmentCount() : 0;
+    return const_iterator(cold.get(), segmentCount, segmentCount, nullptr);
 }
 
 double Stack::getTotalRevenue() const {
     return total;
 }
 
-void Stack::saveCompletedOrders() {
+const RevenueRollup &Stack::getRollup() const {
+    return rollup;
+}
+
+const BestSellers &Stack::getBestSellers() const {
+    return bestSellers;
+}
+
+const LineItemColumns &Stack::getLineItems() const {
+    return lineItems;
+}
+
+const StringInterner &Stack::getCustomers() const {
+    return customers;
+}
+
+const vector<int64_t> &Stack::findCustomerOrders(const string &customerName) const {
+    uint32_t customer;
+    if (!customers.find(customerName, customer)) {
+        return history.ordersOf(UINT32_MAX); // nobody by that name: empty history
+    }
+    return history.ordersOf(customer);
+}
+
+void Stack::saveCompletedOrders(const DynamicArrayList &menu) {
+    LatencyHistogram::Timer timer(saveLatency);
+    TRACE_SPAN("Stack::saveCompletedOrders");
     FileHandler fileHandler("completed_orders.txt"); // Create a FileHandler object
 
     // Read the file content into the lines array
     fileHandler.read();
 
-    // Modify the total revenue line in memory
-    string totalRevenueLine = fileHandler.getLines()[0];
-    totalRevenueLine = "Total Revenue = " + to_string(total);
-    fileHandler.getLines()[0] = totalRevenueLine;
+    // Rebuild the file in memory: the updated total revenue line, the orders
+    // saved earlier, then every order on the stack read in place
+    ostringstream content;
+    content << "Total Revenue = " << to_string(total);
+    for (int i = 1; i < fileHandler.getSize(); i++) {
+        content << "\n" << fileHandler.getLines()[i];
+    }
+    for (const ElementType &order : *this) {
+        content << "\n" << order.toString(menu);
+    }
 
-    // Write the modified lines array back to the file
-    ofstream outFile("completed_orders.txt", ios::trunc);
-    if (outFile.is_open()) {
-        for (int i = 0; i < fileHandler.getSize(); i++) {
-            outFile << fileHandler.getLines()[i] << "\n";
-        }
-        outFile.close();
-    } else {
-        cerr << "Unable to open file for writing.\n";
-    }
-    // Append the completed orders to the file
-    NodePtr current = currentOrder;
-    while (current != nullptr) {
-        try {
-            ElementType data = pop(); // Get the next completed order
-            fileHandler.append(data.toString()); // Append the order to the file
-        } catch (const char* message) {
-            cerr << "Error: " << message << endl;
-        }
-        current = currentOrder; // Move to the next order
+    // Write it back in one go; the saved orders now live in the file only
+    fileHandler.write(content.str());
+    releaseNodes();
+    if (cold) {
+        cold->clear();
     }
 }
 
@@ -116,6 +282,51 @@ void Stack::setStack(NodePtr currentOrder, NodePtr back) {
     this->back = back;
 }
 
+int Stack::appendChain(NodePtr first, NodePtr last) {
+    // Relink the chain instead of copying its orders into new nodes
+    if (first == nullptr) {
+        return 0;
+    }
+    last->next = nullptr;
+
+    // One pass over the new orders feeds every aggregate
+    time_t completedAt = time(0); // the whole chain completes now
+    double revenue = 0;
+    int count = 0;
+    for (NodePtr node = first; node != nullptr; node = node->next) {
+        ShiftArena::chargeNode(node, sizeof(Node), &nodeMemory); // a queue's node is the stack's from now on
+        revenue += node->data.getTotalAmount();
+        residentBytes += footprint(node->data);
+        recordCompletion(node->data, completedAt);
+        TRACE_ORDER_END(node->data.getOrderId());
+        if (listener != nullptr) {
+            listener->onCompleted(node->data);
+        }
+        count++;
+    }
+
+    if (currentOrder == nullptr) {
+        currentOrder = first;
+    } else {
+        back->next = first;
+    }
+    back = last;
+    residentCount += count;
+    total += revenue;
+    rollup.record(completedAt, revenue, count);
+    spillOverBudget();
+    return count;
+}
+
+void Stack::recordCompletion(const ElementType &order, time_t completedAt) {
+    for (const OrderLine &line : order.getLines()) {
+        bestSellers.record(line.menuItemId, line.quantity, completedAt);
+    }
+    uint32_t customer = customers.intern(order.getCustomerName());
+    history.add(customer, order.getOrderId());
+    lineItems.append(order, completedAt, customer);
+}
+
 void Stack::calculateTotalRevenue() {
     /*------------------------------------------------------------------------*
      *  calculateTotalRevenue                                                 *
@@ -125,18 +336,28 @@ void Stack::calculateTotalRevenue() {
      *  Postcondition: The total revenue for all completed orders is          *
      *                 calculated and returned.                               *
      *------------------------------------------------------------------------*/
-    Stack completedOrdersCopy = *this ; // Create a copy of the stack
-    FileHandler fileHandler("completed_orders.txt"); // Create a FileHandler object
-    completedOrdersCopy.loadTotalRevenue(); // Load the total revenue from the file
-    double totalRevenue = completedOrdersCopy.getTotalRevenue();// Calculate the total revenue
-    int size = completedOrdersCopy.getSize(); // Get the number of orders
+    double totalRevenue = 0;
+    readSavedRevenue(totalRevenue); // Revenue of the orders already saved to file
+    totalRevenue += Order::calculateTotalRevenue(*this); // Orders still on the stack
+    total = totalRevenue; // Set the total revenue
+}
 
-    // Calculate the total revenue
-    for (int i = 0; i < size; i++) {
-        ElementType order = completedOrdersCopy.pop();
-        totalRevenue += order.getTotalAmount();
+bool Stack::readSavedRevenue(double &revenue) {
+    FileHandler fileHandler("completed_orders.txt"); // Create a FileHandler object
+    fileHandler.read();
+    if (fileHandler.getLines() == nullptr || fileHandler.getSize() == 0) {
+        return false;
     }
-    total = totalRevenue; // Set the total revenue
+    return parseSavedRevenue(fileHandler.getLines()[0], revenue);
+}
+
+bool Stack::parseSavedRevenue(const string &line, double &revenue) {
+    // Parse the total revenue from the first line
+    string note;
+    stringstream ss(line);
+    getline(ss, note, '=');
+    ss >> revenue;
+    return !ss.fail();
 }
 
 void Stack::loadTotalRevenue() {
@@ -147,21 +368,30 @@ void Stack::loadTotalRevenue() {
      *  Precondition:                                                         *
      *  Postcondition: The total revenue is read from the file.               *
      *------------------------------------------------------------------------*/
+    TRACE_SPAN("Stack::loadTotalRevenue");
     FileHandler fileHandler("completed_orders.txt"); // Create a FileHandler object
-
-    // Read the file content into the lines array
-    if (fileHandler.getLines() == nullptr || fileHandler.getSize() == 0) {
+    fileHandler.read();
+    double TotalRevenue;
+    if (fileHandler.getLines() == nullptr || fileHandler.getSize() == 0
+        || !parseSavedRevenue(fileHandler.getLines()[0], TotalRevenue)) {
         cerr << "No data to load. Ensure the file has been read first.\n";
         return;
     }
-
-    // Parse the total revenue from the first line
-    string note;
-    double TotalRevenue;
-    string line = fileHandler.getLines()[0];
-    stringstream ss(line);
-    getline(ss ,note , '=');
-    ss >> TotalRevenue;
-
     total = TotalRevenue;// Set the total revenue
-}
\ No newline at end of file
+
+    // Index the saved orders by customer from their "Order ID: ..., Customer Name: ..." lines
+    const string idField = "Order ID: ";
+    const string nameField = ", Customer Name: ";
+    string *lines = fileHandler.getLines();
+    for (int i = 1; i < fileHandler.getSize(); i++) {
+        if (lines[i].compare(0, idField.size(), idField) != 0) {
+            continue;
+        }
+        size_t nameStart = lines[i].find(nameField);
+        if (nameStart == string::npos) {
+            continue;
+        }
+        int64_t orderId = strtoll(lines[i].c_str() + idField.size(), nullptr, 10);
+        history.add(customers.intern(lines[i].substr(nameStart + nameField.size())), orderId);
+    }
+}
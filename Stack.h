@@ -2,19 +2,183 @@
 #define STACK_H
 
 #include "Order.h" // Include Order.h before using ElementType
+#include "RevenueRollup.h"
+#include "BestSellers.h"
+#include "CustomerIndex.h"
+#include "OrderListener.h"
+#include "OrderSegments.h"
+#include "LineItemColumns.h"
+#include "StringInterner.h"
+#include "ShiftArena.h"
+#include "ParallelOps.h"
 
 #include <iostream>
 #include <sstream>
+#include <cstddef>
 #include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
 
 typedef Order ElementType; // type of elements stored in the stack
 
+/*------------------------------------------------------------------------*
+ *  OrderNode                                                             *
+ *  Singly linked node shared by Queue and Stack, so that a chain of      *
+ *  orders can be relinked from one container into the other without     *
+ *  copying or reallocating the orders it holds.                          *
+ *------------------------------------------------------------------------*/
+struct OrderNode {
+    ElementType data; // order stored in the node
+    OrderNode *next; // pointer to the next node in the chain
+
+    OrderNode(const ElementType &data, OrderNode *next = nullptr) : data(data), next(next) {
+    }
+
+    OrderNode(ElementType &&data, OrderNode *next = nullptr) : data(std::move(data)), next(next) {
+    }
+
+    // Builds the order directly inside the node from Order constructor arguments
+    template <typename... Args>
+    explicit OrderNode(in_place_t, Args &&... args) : data(std::forward<Args>(args)...), next(nullptr) {
+    }
+
+    // Nodes come from the current shift arena, or the heap if there is none
+    static void *operator new(size_t size) { return ShiftArena::allocateNode(size); }
+
+    // new (memory) OrderNode(...) charges the node to a container's account
+    static void *operator new(size_t size, CountingResource &memory) { return ShiftArena::allocateNode(size, &memory); }
+
+    static void operator delete(void *node, size_t size) { ShiftArena::deallocateNode(node, size); }
+
+    // Frees the node if its constructor throws
+    static void operator delete(void *node, CountingResource &) { ShiftArena::deallocateNode(node, sizeof(OrderNode)); }
+};
+
+/*------------------------------------------------------------------------*
+ *  OrderChainIterator                                                    *
+ *  Read-only forward iterator over a chain of OrderNodes. Lets Queue and *
+ *  Stack be traversed, and handed to standard algorithms, without        *
+ *  popping or copying any order.                                         *
+ *------------------------------------------------------------------------*/
+class OrderChainIterator {
+public:
+    typedef forward_iterator_tag iterator_category;
+    typedef ElementType value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const ElementType *pointer;
+    typedef const ElementType &reference;
+
+    OrderChainIterator(const OrderNode *node = nullptr) : node(node) {
+    }
+
+    reference operator*() const { return node->data; }
+
+    pointer operator->() const { return &node->data; }
+
+    OrderChainIterator &operator++() {
+        node = node->next;
+        return *this;
+    }
+
+    OrderChainIterator operator++(int) {
+        OrderChainIterator previous = *this;
+        node = node->next;
+        return previous;
+    }
+
+    bool operator==(const OrderChainIterator &other) const { return node == other.node; }
+
+    bool operator!=(const OrderChainIterator &other) const { return node != other.node; }
+
+private:
+    const OrderNode *node; // Current node, nullptr at the end
+};
+
+/*------------------------------------------------------------------------*
+ *  CompletedOrderIterator                                                *
+ *  Read-only forward iterator over both tiers of the completed orders:   *
+ *  the spilled segments, oldest first, then the chain still in memory.   *
+ *  A segment is loaded when the iterator enters it and shared by every   *
+ *  iterator positioned inside it.                                        *
+ *------------------------------------------------------------------------*/
+class CompletedOrderIterator {
+public:
+    typedef forward_iterator_tag iterator_category;
+    typedef ElementType value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const ElementType *pointer;
+    typedef const ElementType &reference;
+
+    CompletedOrderIterator() : cold(nullptr), segment(0), index(0) {
+    }
+
+    // Starts at segment (== segmentCount for the memory tier), then continues into hot
+    CompletedOrderIterator(const OrderSegments *cold, size_t segment, size_t segmentCount, const OrderNode *hot)
+        : cold(cold), segment(segment), segmentCount(segmentCount), index(0), hot(hot) {
+        enterSegment();
+    }
+
+    reference operator*() const { return orders ? (*orders)[index] : *hot; }
+
+    pointer operator->() const { return &**this; }
+
+    CompletedOrderIterator &operator++() {
+        if (orders) {
+            if (++index == orders->size()) {
+                segment++;
+                index = 0;
+                enterSegment();
+            }
+        } else {
+            ++hot;
+        }
+        return *this;
+    }
+
+    CompletedOrderIterator operator++(int) {
+        CompletedOrderIterator previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    bool operator==(const CompletedOrderIterator &other) const {
+        return segment == other.segment && index == other.index && hot == other.hot;
+    }
+
+    bool operator!=(const CompletedOrderIterator &other) const { return !(*this == other); }
+
+private:
+    const OrderSegments *cold; // spilled tier
+    size_t segment; // current segment, segmentCount once in memory
+    size_t segmentCount = 0; // segments that existed when iteration began
+    size_t index; // position inside the current segment, after its popped orders
+    shared_ptr<const vector<ElementType>> orders; // current segment, null once in memory
+    OrderChainIterator hot; // position in the memory tier
+
+    // Loads the first non-empty segment from the current one on, if any
+    void enterSegment() {
+        orders.reset();
+        for (; segment < segmentCount; segment++) {
+            orders = cold->load(segment, index);
+            if (index < orders->size()) {
+                return;
+            }
+        }
+        index = 0;
+        orders.reset();
+    }
+};
+
 /*------------------------------------------------------------------------*
  *  Stack                                                                 *
  *  Represents a stack data structure that stores orders.                 *
  *------------------------------------------------------------------------*/
 class Stack {
 public:
+    typedef CompletedOrderIterator const_iterator; // iterates oldest to newest, across both tiers
+
     /*------------------------------------------------------------------------*
      *  Stack                                                                 *
      *  Default constructor. Initializes an empty Stack object.               *
@@ -32,6 +196,27 @@ public:
      *------------------------------------------------------------------------*/
     Stack(const Stack &stack);
 
+    /*------------------------------------------------------------------------*
+     *  Stack                                                                 *
+     *  Move constructor. Takes over the node chain of another Stack.         *
+     *                                                                        *
+     *  Precondition:  stack is a valid Stack object.                         *
+     *  Postcondition: This stack owns stack's orders; stack is left empty.   *
+     *------------------------------------------------------------------------*/
+    Stack(Stack &&stack) noexcept;
+
+    /*------------------------------------------------------------------------*
+     *  operator=                                                             *
+     *  Copy and move assignment, with the same semantics as the copy and     *
+     *  move constructors.                                                    *
+     *                                                                        *
+     *  Precondition:  stack is a valid Stack object.                         *
+     *  Postcondition: This stack holds the orders and total of stack.        *
+     *------------------------------------------------------------------------*/
+    Stack &operator=(const Stack &stack);
+
+    Stack &operator=(Stack &&stack) noexcept;
+
     /*------------------------------------------------------------------------*
      *  ~Stack                                                                *
      *  Destructor. Deletes the Stack object.                                 *
@@ -57,28 +242,50 @@ public:
      *------------------------------------------------------------------------*/
     void push(const ElementType &order);
 
+    void push(ElementType &&order);
+
+    /*------------------------------------------------------------------------*
+     *  emplace                                                               *
+     *  Builds an order in place on top of the stack from Order constructor   *
+     *  arguments.                                                            *
+     *                                                                        *
+     *  Precondition:  args are valid arguments for an Order constructor.     *
+     *  Postcondition: The new order is on top of the stack and returned.     *
+     *------------------------------------------------------------------------*/
+    template <typename... Args>
+    ElementType &emplace(Args &&... args) {
+        NodePtr node = new (nodeMemory) Node(in_place, std::forward<Args>(args)...);
+        appendChain(node, node);
+        return node->data;
+    }
+
     /*------------------------------------------------------------------------*
      *  pop                                                                   *
-     *  Removes and returns the top order from the stack.                     *
+     *  Removes and returns the top order from the stack. Spilled orders are *
+     *  the oldest, so they are popped first, from their segments.           *
      *                                                                        *
-     *  Precondition:  The stack is not empty.                                *
+     *  Precondition:  The stack is not empty; throws runtime_error if it is. *
      *  Postcondition: The top order is removed from the stack and returned.  *
      *------------------------------------------------------------------------*/
     ElementType pop();
 
     /*------------------------------------------------------------------------*
      *  getCurrentOrder                                                       *
-     *  Returns the current order being processed.                            *
+     *  Returns the current order being processed, the one pop would return. *
+     *  A spilled order is read from its segment once, which then stays in   *
+     *  memory until it is popped empty, so repeated and concurrent calls    *
+     *  return the same order without reading the disk.                      *
      *                                                                        *
      *  Precondition:  The stack is initialized.                              *
-     *  Postcondition: The current order being processed is returned.         *
+     *  Postcondition: The current order is returned; it stays valid until   *
+     *                 the stack is next changed.                             *
      *  Warning: Use try & catch when calling it in case of an Empty Stack.   *
      *------------------------------------------------------------------------*/
-    ElementType getCurrentOrder() const;
+    const ElementType &getCurrentOrder() const;
 
     /*------------------------------------------------------------------------*
      *  getSize                                                               *
-     *  Returns the number of orders in the stack.                            *
+     *  Returns the number of orders in the stack, spilled or in memory.      *
      *                                                                        *
      *  Precondition:  The stack is initialized.                              *
      *  Postcondition: The number of orders in the stack is returned.         *
@@ -86,6 +293,69 @@ public:
      *------------------------------------------------------------------------*/
     int getSize() const;
 
+    /*------------------------------------------------------------------------*
+     *  begin / end                                                           *
+     *  Read-only iteration over the completed orders, from the oldest to     *
+     *  the most recently pushed. begin waits for spills still being written *
+     *  so that the iteration covers the whole history.                       *
+     *                                                                        *
+     *  Precondition:  The stack is not modified while iterating.             *
+     *  Postcondition: The stack is unchanged.                                *
+     *------------------------------------------------------------------------*/
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
+    /*------------------------------------------------------------------------*
+     *  parallelReduce                                                        *
+     *  Reduces every completed order like parallelReduce over begin() and   *
+     *  end(), but splits the work along the tiers: one job per spilled      *
+     *  segment, so each is read and decoded once, and chunks of at least    *
+     *  minChunk orders of the chain in memory.                               *
+     *                                                                        *
+     *  Precondition:  map and combine are safe to call concurrently and      *
+     *                 combine is associative. The stack is not modified     *
+     *                 meanwhile.                                             *
+     *  Postcondition: The orders, oldest first, reduced onto init are       *
+     *                 returned.                                              *
+     *------------------------------------------------------------------------*/
+    template <typename T, typename Map, typename Combine>
+    T parallelReduce(T init, Map map, Combine combine, size_t minChunk = 1024) const {
+        size_t segmentCount = 0;
+        if (cold) {
+            cold->flush(); // spilled chains are only readable once written
+            segmentCount = cold->getSegmentCount();
+        }
+        ThreadPool &pool = ThreadPool::shared();
+        vector<OrderChainIterator> bounds = splitRange(OrderChainIterator(currentOrder), OrderChainIterator(),
+                                                       pool.getConcurrency(), minChunk);
+        size_t chunks = bounds.size() - 1;
+
+        vector<optional<T>> partial(segmentCount + chunks); // segments first, then the chunks, oldest first
+        vector<function<void()>> jobs;
+        for (size_t s = 0; s < segmentCount; s++) {
+            jobs.push_back([&, s] {
+                size_t first;
+                shared_ptr<const vector<ElementType>> orders = cold->load(s, first);
+                partial[s] = reduceChunk<T>(orders->begin() + (ptrdiff_t) first, orders->end(), map, combine);
+            });
+        }
+        for (size_t c = 0; c < chunks; c++) {
+            jobs.push_back([&, c] {
+                partial[segmentCount + c] = reduceChunk<T>(bounds[c], bounds[c + 1], map, combine);
+            });
+        }
+        pool.runAll(jobs);
+
+        T result = init;
+        for (const optional<T> &value : partial) {
+            if (value.has_value()) {
+                result = combine(result, *value);
+            }
+        }
+        return result;
+    }
+
     /*------------------------------------------------------------------------*
      *  getTotalRevenue                                                       *
      *  Returns the total revenue from all completed orders.                  *
@@ -96,6 +366,85 @@ public:
      *------------------------------------------------------------------------*/
     double getTotalRevenue() const;
 
+    /*------------------------------------------------------------------------*
+     *  getRollup                                                             *
+     *  Returns the per-minute, per-hour and per-day revenue rollups of the   *
+     *  orders pushed since the program started.                              *
+     *                                                                        *
+     *  Precondition:  The stack is initialized.                              *
+     *  Postcondition: The rollups are returned; queries on them cost         *
+     *                 O(buckets), independent of the number of orders.       *
+     *------------------------------------------------------------------------*/
+    const RevenueRollup &getRollup() const;
+
+    /*------------------------------------------------------------------------*
+     *  getBestSellers                                                        *
+     *  Returns the streaming top-k of menu items sold in completed orders,   *
+     *  counted since local midnight.                                         *
+     *                                                                        *
+     *  Precondition:  The stack is initialized.                              *
+     *  Postcondition: The heavy hitters are returned in constant time.       *
+     *------------------------------------------------------------------------*/
+    const BestSellers &getBestSellers() const;
+
+    /*------------------------------------------------------------------------*
+     *  getLineItems / getCustomers                                           *
+     *  Returns the column store holding one row per item of every order     *
+     *  pushed since the program started, and the interner that resolves its *
+     *  customer handles back to names.                                       *
+     *                                                                        *
+     *  Precondition:  The stack is initialized.                              *
+     *  Postcondition: The columns and names are returned for analytics.      *
+     *------------------------------------------------------------------------*/
+    const LineItemColumns &getLineItems() const;
+
+    const StringInterner &getCustomers() const;
+
+    /*------------------------------------------------------------------------*
+     *  findCustomerOrders                                                    *
+     *  Returns the ids of every completed order of a customer, both the      *
+     *  ones loaded from file and the ones pushed since, oldest first.        *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: The history is returned without scanning any order;   *
+     *                 it is empty if the customer never completed an order.  *
+     *------------------------------------------------------------------------*/
+    const vector<int64_t> &findCustomerOrders(const string &customerName) const;
+
+    /*------------------------------------------------------------------------*
+     *  setMemoryBudget                                                       *
+     *  Limits the memory used by the orders kept in RAM. When a push takes   *
+     *  the stack over the budget, its oldest orders are spilled to disk      *
+     *  segments in the background until a quarter of the budget is free.    *
+     *  A budget of 0 keeps every order in memory.                            *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: The stack's resident orders fit the budget.            *
+     *------------------------------------------------------------------------*/
+    void setMemoryBudget(size_t bytes);
+
+    // Estimated bytes used by the orders currently in memory
+    size_t getResidentBytes() const;
+
+    /*------------------------------------------------------------------------*
+     *  setListener                                                           *
+     *  Registers the observer told about every order completed onto the     *
+     *  stack, or removes it when given nullptr.                              *
+     *                                                                        *
+     *  Precondition:  listener outlives the stack or is replaced first.      *
+     *  Postcondition: Later completions are reported to listener.            *
+     *------------------------------------------------------------------------*/
+    void setListener(OrderListener *listener);
+
+    /*------------------------------------------------------------------------*
+     *  getAppendLock                                                         *
+     *  The lock every thread holds while it adds orders to the stack, so    *
+     *  that pipeline workers and station consumers archiving at the same   *
+     *  time never splice onto it together. Not copied or moved with the     *
+     *  stack's orders.                                                       *
+     *------------------------------------------------------------------------*/
+    mutex &getAppendLock();
+
 
     /*------------------------------------------------------------------------*
      *  processNextOrder                                                      *
@@ -108,16 +457,18 @@ public:
 
     /*------------------------------------------------------------------------*
      *  saveCompletedOrders                                                   *
-     *  Saves the completed orders to a file.                                 *
+     *  Saves the completed orders to a file, naming their items from menu.   *
      *                                                                        *
      *  Precondition:  The stack is initialized.                              *
      *  Postcondition: The completed orders are saved to a file.              *
      *------------------------------------------------------------------------*/
-    void saveCompletedOrders();
+    void saveCompletedOrders(const DynamicArrayList &menu);
 
     /*------------------------------------------------------------------------*
      *  calculateTotalRevenue                                                 *
-     *  Calculates the total revenue from all completed orders.               *
+     *  Calculates the total revenue from all completed orders: the revenue  *
+     *  already saved to file plus the orders still on the stack, summed in   *
+     *  parallel without copying or popping them.                             *
      *                                                                        *
      *  Precondition:  completedOrders is a valid Stack object.               *
      *  Postcondition: The total revenue for all completed orders is          *
@@ -127,32 +478,52 @@ public:
 
     /*------------------------------------------------------------------------*
      *  loadTotalRevenue                                                      *
-     *  Loads the total revenue from a file.                                  *
+     *  Loads the total revenue from a file, and indexes the orders saved in  *
+     *  it by customer name.                                                  *
      *                                                                        *
      *  Precondition: fileHandler has read the data from a valid file.        *
-     *  Postcondition: The total revenue is read from the file.               *
+     *  Postcondition: The total revenue is read from the file and the saved  *
+     *                 orders are in the customer index.                      *
      *------------------------------------------------------------------------*/
     void loadTotalRevenue();
 
 private:
-    struct Node {
-        ElementType data; // order stored in the node
-        Node *next; // pointer to the next node in the stack
+    friend class Queue; // Queue splices its node chains onto the stack
 
-        Node(const ElementType &data, Node *next = nullptr) {
-            this->data = data;
-            this->next = next;
-        }
-    };
+    typedef OrderNode Node; // node type shared with Queue
 
     typedef Node *NodePtr; // pointer to a Node object
 
+    static CountingResource nodeMemory; // nodes of every stack, including those spliced from queues
+
     NodePtr currentOrder; // pointer to the current order being processed
 
     NodePtr back; // pointer to the last node in the stack
 
     double total; // total price of all completed orders
 
+    size_t memoryBudget; // most bytes of orders kept in memory, 0 for no limit
+
+    size_t residentBytes; // estimated bytes of the orders in memory
+
+    int residentCount; // number of orders in memory
+
+    unique_ptr<OrderSegments> cold; // orders spilled out of memory, oldest first
+
+    OrderListener *listener; // told about each completed order, may be nullptr
+
+    mutex appendLock; // held by threads adding orders concurrently
+
+    RevenueRollup rollup; // time-bucketed revenue, updated on every push
+
+    BestSellers bestSellers; // top-k menu items, fed on every push
+
+    StringInterner customers; // customer names, interned for history and lineItems
+
+    CustomerIndex history; // order ids of each customer, fed on push and on load
+
+    LineItemColumns lineItems; // columnar copy of completed line items
+
     /*------------------------------------------------------------------------*
      *  setStack                                                              *
      *  Sets the stack to the given order and back pointers.                  *
@@ -161,6 +532,54 @@ private:
      *  Postcondition: The stack is set to the given order and back pointers. *
      *------------------------------------------------------------------------*/
     void setStack(NodePtr currentOrder, NodePtr back);
+
+    /*------------------------------------------------------------------------*
+     *  releaseNodes                                                          *
+     *  Deletes every node of the stack, leaving it empty. The total is kept. *
+     *------------------------------------------------------------------------*/
+    void releaseNodes();
+
+    /*------------------------------------------------------------------------*
+     *  spillOverBudget                                                       *
+     *  Hands the oldest in-memory orders to the cold tier while the stack   *
+     *  is over its memory budget.                                            *
+     *------------------------------------------------------------------------*/
+    void spillOverBudget();
+
+    // Estimated bytes one order occupies in memory, node included
+    static size_t footprint(const ElementType &order);
+
+    /*------------------------------------------------------------------------*
+     *  readSavedRevenue                                                      *
+     *  Reads the revenue recorded on the first line of the completed orders  *
+     *  file.                                                                 *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: Returns true and sets revenue if the file holds a      *
+     *                 total, false otherwise.                                *
+     *------------------------------------------------------------------------*/
+    static bool readSavedRevenue(double &revenue);
+
+    // Parses the "Total Revenue = X" line of the completed orders file
+    static bool parseSavedRevenue(const string &line, double &revenue);
+
+    /*------------------------------------------------------------------------*
+     *  appendChain                                                           *
+     *  Links an already built chain of nodes onto the top of the stack and   *
+     *  records its orders in the aggregates, in a single pass over it.       *
+     *                                                                        *
+     *  Precondition:  first..last is a chain that is no longer owned by any  *
+     *                 other container.                                       *
+     *  Postcondition: The stack owns the chain, every aggregate includes     *
+     *                 its orders, and the number of orders is returned.      *
+     *------------------------------------------------------------------------*/
+    int appendChain(NodePtr first, NodePtr last);
+
+    /*------------------------------------------------------------------------*
+     *  recordCompletion                                                      *
+     *  Feeds one completed order to the per-order aggregates.                *
+     *------------------------------------------------------------------------*/
+    void recordCompletion(const ElementType &order, time_t completedAt);
 };
 
 
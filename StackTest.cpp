@@ -0,0 +1,72 @@
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Stack.h"
+#include "TestCheck.h"
+#include "TestOrders.h"
+
+using namespace std;
+
+namespace {
+    // Pushes orders 1..count onto a stack that spills most of them
+    void fillSpilled(Stack &stack, int count) {
+        stack.setMemoryBudget(16 * 1024);
+        for (int i = 1; i <= count; i++) {
+            stack.push(testOrder(i, "Ada", 3));
+        }
+    }
+
+    void testSpillKeepsOrder() {
+        Stack stack;
+        fillSpilled(stack, 3000);
+        CHECK(stack.getSize() == 3000);
+        CHECK(stack.getResidentBytes() <= 16 * 1024);
+        vector<int64_t> ids = orderIds(stack);
+        CHECK(ids.size() == 3000 && ids.front() == 1 && ids.back() == 3000);
+
+        // Pops run oldest first through the spilled segments into the chain in memory
+        bool ordered = true;
+        for (int i = 1; i <= 3000; i++) {
+            ordered = ordered && stack.getCurrentOrder().getOrderId() == i && stack.pop().getOrderId() == i;
+        }
+        CHECK(ordered);
+        CHECK(stack.isEmpty());
+        CHECK_THROWS(stack.pop(), runtime_error);
+        CHECK_THROWS(stack.getCurrentOrder(), runtime_error);
+    }
+
+    // A peeked spilled order stays put however often, and from however many threads, it is peeked
+    void testPeekIsStable() {
+        Stack stack;
+        fillSpilled(stack, 3000);
+        const Order &first = stack.getCurrentOrder();
+        CHECK(first.getOrderId() == 1);
+
+        vector<const Order *> seen(8);
+        vector<thread> readers;
+        for (size_t i = 0; i < seen.size(); i++) {
+            readers.emplace_back([&stack, &seen, i] {
+                for (int round = 0; round < 100; round++) {
+                    seen[i] = &stack.getCurrentOrder();
+                }
+            });
+        }
+        for (thread &reader : readers) {
+            reader.join();
+        }
+        for (const Order *order : seen) {
+            CHECK(order == &first);
+        }
+        CHECK(first.getOrderId() == 1 && first.getCustomerName() == "Ada");
+
+        stack.pop();
+        CHECK(stack.getCurrentOrder().getOrderId() == 2);
+    }
+}
+
+int main() {
+    testSpillKeepsOrder();
+    testPeekIsStable();
+    return testResult();
+}
@@ -0,0 +1,211 @@
+#include "StationQueues.h"
+
+StationQueues::StationQueues(const DynamicArrayList &menu, Stack &completedOrders)
+    : consumersRunning(false), completedOrders(completedOrders) {
+    /*------------------------------------------------------------*
+     *  StationQueues                                             *
+     *  Station 0 takes orders whose items are not on the menu.   *
+     *------------------------------------------------------------*/
+    addStation("General");
+    updateMenu(menu);
+}
+
+StationQueues::~StationQueues() {
+    stopConsumers();
+}
+
+void StationQueues::updateMenu(const DynamicArrayList &menu) {
+    unique_lock<shared_mutex> routing(routingLock);
+    stationByItem.clear();
+    for (int i = 0; i < menu.getSize(); i++) {
+        const MenuItem &item = menu.getMenuItem(i);
+        stationByItem[item.getId()] = addStation(item.getCategory());
+    }
+}
+
+int StationQueues::addStation(const string &category) {
+    auto found = stationByCategory.find(category);
+    if (found != stationByCategory.end()) {
+        return found->second;
+    }
+    int index = (int) stations.size();
+    stationByCategory[category] = index;
+    stations.push_back(make_unique<Station>());
+    stations.back()->category = category;
+    if (consumersRunning) {
+        startConsumer(*stations.back());
+    }
+    return index;
+}
+
+int StationQueues::stationFor(const Order &order) const {
+    shared_lock<shared_mutex> routing(routingLock);
+    return route(order);
+}
+
+int StationQueues::route(const Order &order) const {
+    /*------------------------------------------------------------*
+     *  route                                                     *
+     *  Orders touch few stations, so the unit counts are kept    *
+     *  in a small list in line order; the first maximum wins.   *
+     *------------------------------------------------------------*/
+    vector<pair<int, long>> units; // station, units ordered from it
+    for (const OrderLine &line : order.getLines()) {
+        auto found = stationByItem.find(line.menuItemId);
+        int station = found == stationByItem.end() ? 0 : found->second;
+        size_t i = 0;
+        while (i < units.size() && units[i].first != station) {
+            i++;
+        }
+        if (i == units.size()) {
+            units.emplace_back(station, 0);
+        }
+        units[i].second += line.quantity;
+    }
+
+    int best = 0;
+    long bestUnits = 0;
+    for (const pair<int, long> &entry : units) {
+        if (entry.second > bestUnits) {
+            best = entry.first;
+            bestUnits = entry.second;
+        }
+    }
+    return best;
+}
+
+int StationQueues::enqueue(Order &&order) {
+    /*------------------------------------------------------------*
+     *  enqueue                                                   *
+     *  Routing only shares the routing lock, so enqueues to      *
+     *  different stations contend on nothing but their own      *
+     *  station's lock.                                           *
+     *------------------------------------------------------------*/
+    int index;
+    Station *station;
+    {
+        shared_lock<shared_mutex> routing(routingLock);
+        index = route(order);
+        station = stations[index].get();
+    }
+    {
+        lock_guard<mutex> lock(station->lock);
+        station->orders.enqueue(std::move(order));
+    }
+    station->ready.notify_one();
+    return index;
+}
+
+void StationQueues::startConsumers() {
+    unique_lock<shared_mutex> routing(routingLock);
+    if (consumersRunning) {
+        return;
+    }
+    consumersRunning = true;
+    for (unique_ptr<Station> &station : stations) {
+        startConsumer(*station);
+    }
+}
+
+void StationQueues::startConsumer(Station &station) {
+    {
+        lock_guard<mutex> lock(station.lock);
+        station.stopping = false;
+    }
+    Station *target = &station;
+    station.consumer = thread([this, target] { consumeLoop(*target); });
+}
+
+void StationQueues::stopConsumers() {
+    unique_lock<shared_mutex> routing(routingLock);
+    consumersRunning = false;
+    for (unique_ptr<Station> &station : stations) {
+        if (!station->consumer.joinable()) {
+            continue;
+        }
+        {
+            lock_guard<mutex> lock(station->lock);
+            station->stopping = true;
+        }
+        station->ready.notify_all();
+        station->consumer.join();
+    }
+}
+
+void StationQueues::waitIdle() {
+    shared_lock<shared_mutex> routing(routingLock);
+    for (unique_ptr<Station> &station : stations) {
+        unique_lock<mutex> lock(station->lock);
+        station->drained.wait(lock, [&station] { return station->orders.isEmpty(); });
+    }
+}
+
+void StationQueues::consumeLoop(Station &station) {
+    /*------------------------------------------------------------*
+     *  consumeLoop                                               *
+     *  Waits for orders on its own station only and splices      *
+     *  everything queued there onto the completed stack at once. *
+     *------------------------------------------------------------*/
+    unique_lock<mutex> lock(station.lock);
+    while (true) {
+        station.ready.wait(lock, [&station] { return station.stopping || !station.orders.isEmpty(); });
+        if (!station.orders.isEmpty()) {
+            lock_guard<mutex> completedLock(completedOrders.getAppendLock());
+            station.orders.drainAll(&completedOrders);
+        }
+        station.drained.notify_all();
+        if (station.stopping) {
+            return;
+        }
+    }
+}
+
+void StationQueues::print(const DynamicArrayList &menu) {
+    shared_lock<shared_mutex> routing(routingLock);
+    for (unique_ptr<Station> &station : stations) {
+        lock_guard<mutex> lock(station->lock);
+        if (station->orders.isEmpty()) {
+            continue;
+        }
+        cout << "--- Station: " << station->category << " (" << station->orders.size() << " orders) ---" << endl;
+        station->orders.print(menu);
+    }
+}
+
+void StationQueues::forEachOrder(const function<void(const Order &)> &visit) {
+    shared_lock<shared_mutex> routing(routingLock);
+    for (unique_ptr<Station> &station : stations) {
+        lock_guard<mutex> lock(station->lock);
+        for (const Order &order : station->orders) {
+            visit(order);
+        }
+    }
+}
+
+void StationQueues::relocate() {
+    shared_lock<shared_mutex> routing(routingLock);
+    for (unique_ptr<Station> &station : stations) {
+        lock_guard<mutex> lock(station->lock);
+        station->orders.relocate();
+    }
+}
+
+int StationQueues::getStationCount() const {
+    shared_lock<shared_mutex> routing(routingLock);
+    return (int) stations.size();
+}
+
+string StationQueues::getStationName(int station) const {
+    shared_lock<shared_mutex> routing(routingLock);
+    return stations[station]->category;
+}
+
+int StationQueues::size(int station) {
+    Station *target;
+    {
+        shared_lock<shared_mutex> routing(routingLock);
+        target = stations[station].get();
+    }
+    lock_guard<mutex> lock(target->lock);
+    return target->orders.size();
+}
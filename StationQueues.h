@@ -0,0 +1,180 @@
+#ifndef STATIONQUEUES_H
+#define STATIONQUEUES_H
+
+#include "DynamicArrayList.h"
+#include "Queue.h"
+#include "Stack.h"
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  StationQueues                                                         *
+ *  Active orders sharded into one Queue per kitchen station. Stations    *
+ *  are the menu categories (MenuItem::getCategory: Soft Drink, Hot       *
+ *  Drink, Juice, Salad, ...), and each has its own lock and its own      *
+ *  consumer, so stations never contend on a shared head pointer.         *
+ *                                                                        *
+ *  An order is a single ticket, so it goes whole to one station: the    *
+ *  one whose items make up most of its units, ties going to the station *
+ *  of the earlier line.                                                  *
+ *------------------------------------------------------------------------*/
+class StationQueues {
+public:
+    /*------------------------------------------------------------------------*
+     *  StationQueues                                                         *
+     *  Parameterized constructor. Creates station 0 ("General") for items   *
+     *  not on the menu, plus one station per distinct category in menu.      *
+     *  Stations consume into completedOrders.                                *
+     *                                                                        *
+     *  Precondition:  completedOrders outlives this object; other threads   *
+     *                 add to it under its append lock while consumers run.  *
+     *  Postcondition: One empty queue exists per station.                    *
+     *------------------------------------------------------------------------*/
+    StationQueues(const DynamicArrayList &menu, Stack &completedOrders);
+
+    /*------------------------------------------------------------------------*
+     *  ~StationQueues                                                        *
+     *  Destructor. Stops the consumers and frees any orders still queued.    *
+     *------------------------------------------------------------------------*/
+    ~StationQueues();
+
+    StationQueues(const StationQueues &stations) = delete;
+
+    StationQueues &operator=(const StationQueues &stations) = delete;
+
+    /*------------------------------------------------------------------------*
+     *  updateMenu                                                            *
+     *  Rebuilds the routing after the menu changed. New categories get a    *
+     *  station of their own, with a consumer if the consumers are running; *
+     *  stations whose category left the menu stay, empty.                   *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: Orders are routed by the categories of menu.           *
+     *------------------------------------------------------------------------*/
+    void updateMenu(const DynamicArrayList &menu);
+
+    /*------------------------------------------------------------------------*
+     *  stationFor                                                            *
+     *  Returns the station an order is routed to: the station with the most *
+     *  of its units, ties going to the earlier line. Items not on the menu  *
+     *  count for station 0, as does an order without lines.                  *
+     *                                                                        *
+     *  Precondition:  order is a valid Order object.                         *
+     *  Postcondition: A valid station index is returned.                     *
+     *------------------------------------------------------------------------*/
+    int stationFor(const Order &order) const;
+
+    /*------------------------------------------------------------------------*
+     *  enqueue                                                               *
+     *  Routes an order to its station and adds it to that station's queue.   *
+     *                                                                        *
+     *  Precondition:  order is a valid Order object.                         *
+     *  Postcondition: The order is at the back of its station's queue and   *
+     *                 the station index is returned.                         *
+     *------------------------------------------------------------------------*/
+    int enqueue(Order &&order);
+
+    /*------------------------------------------------------------------------*
+     *  startConsumers                                                        *
+     *  Starts one background consumer per station that moves its station's *
+     *  orders onto the completed stack as soon as they arrive. They keep    *
+     *  running until stopConsumers or the destructor.                        *
+     *                                                                        *
+     *  Precondition:  The consumers are not already running.                 *
+     *  Postcondition: Every station is drained by its own thread.            *
+     *------------------------------------------------------------------------*/
+    void startConsumers();
+
+    /*------------------------------------------------------------------------*
+     *  stopConsumers                                                         *
+     *  Stops and joins the background consumers, if running. Each drains    *
+     *  what its station holds before it exits.                               *
+     *------------------------------------------------------------------------*/
+    void stopConsumers();
+
+    /*------------------------------------------------------------------------*
+     *  waitIdle                                                              *
+     *  Waits until the consumers have emptied every station, so the caller  *
+     *  can read the completed stack without racing them.                     *
+     *                                                                        *
+     *  Precondition:  The consumers are running, or the stations are empty. *
+     *  Postcondition: Every order enqueued before the call is completed.     *
+     *------------------------------------------------------------------------*/
+    void waitIdle();
+
+    /*------------------------------------------------------------------------*
+     *  print                                                                 *
+     *  Merged view of every station queue, station by station, with item    *
+     *  names looked up in menu.                                              *
+     *                                                                        *
+     *  Precondition: None.                                                   *
+     *  Postcondition: The queued orders are printed to the console.          *
+     *------------------------------------------------------------------------*/
+    void print(const DynamicArrayList &menu);
+
+    /*------------------------------------------------------------------------*
+     *  forEachOrder                                                          *
+     *  Calls visit on every queued order, station by station, each station  *
+     *  locked while it is visited.                                           *
+     *                                                                        *
+     *  Precondition:  visit does not modify the stations.                    *
+     *  Postcondition: The stations are unchanged.                            *
+     *------------------------------------------------------------------------*/
+    void forEachOrder(const function<void(const Order &)> &visit);
+
+    // Queue::relocate on every station, each station locked in turn
+    void relocate();
+
+    // Station information, each read under the routing lock
+    int getStationCount() const;
+
+    string getStationName(int station) const;
+
+    int size(int station);
+
+private:
+    // One station: its queue, its lock and its consumer, on separate cache lines
+    struct alignas(64) Station {
+        string category; // Menu category served by the station
+        Queue orders; // Active orders of the station
+        mutex lock; // Guards orders and stopping
+        condition_variable ready; // Signalled when orders gains an order
+        condition_variable drained; // Signalled when the consumer has emptied orders
+        thread consumer; // Background consumer, if started
+        bool stopping = false; // Asks the consumer to exit
+    };
+
+    // Guards the three members below and consumersRunning. Stations are only ever added, so a Station
+    // found under it stays valid after it is released.
+    mutable shared_mutex routingLock;
+    vector<unique_ptr<Station>> stations; // Index 0 is the General station
+    unordered_map<string, int> stationByCategory; // Category -> station
+    unordered_map<int, int> stationByItem; // Menu item ID -> station, rebuilt by updateMenu
+    bool consumersRunning; // Set between startConsumers and stopConsumers
+
+    Stack &completedOrders; // Where consumed orders are archived, under its append lock
+
+    // stationFor, with routingLock already held
+    int route(const Order &order) const;
+
+    // Body of one station's consumer thread
+    void consumeLoop(Station &station);
+
+    // Returns the station of category, adding it (and its consumer, if running) if needed; under routingLock
+    int addStation(const string &category);
+
+    // Starts the consumer thread of one station
+    void startConsumer(Station &station);
+};
+
+#endif //STATIONQUEUES_H
@@ -0,0 +1,92 @@
+#include <string>
+
+#include "StationQueues.h"
+#include "TestCheck.h"
+#include "TestOrders.h"
+
+using namespace std;
+
+namespace {
+    // Items 1-2 are pizzas, 3-4 drinks; the names say nothing about the category
+    void fillMenu(DynamicArrayList &menu) {
+        menu.add(MenuItem(1, "Margherita", "Tomato and basil", 8.99, "Pizza"));
+        menu.add(MenuItem(2, "Funghi", "Mushrooms", 9.49, "Pizza"));
+        menu.add(MenuItem(3, "Cola", "Chilled", 1.5, "Soft Drink"));
+        menu.add(MenuItem(4, "Tonic", "Chilled", 2.0, "Soft Drink"));
+    }
+
+    Order orderOf(int64_t orderId, const OrderLines &lines) {
+        return Order(orderId, "Ada", lines, 0, false);
+    }
+
+    void testRouting() {
+        DynamicArrayList menu;
+        fillMenu(menu);
+        Stack completed;
+        StationQueues stations(menu, completed);
+        CHECK(stations.getStationCount() == 3); // General, Pizza, Soft Drink
+        CHECK(stations.getStationName(1) == "Pizza" && stations.getStationName(2) == "Soft Drink");
+
+        OrderLines pizzas;
+        pizzas.push_back(OrderLine{1, 1, 899});
+        pizzas.push_back(OrderLine{2, 1, 949});
+        CHECK(stations.stationFor(orderOf(1, pizzas)) == 1);
+
+        // Most units decide, whatever the first line is
+        OrderLines mostlyDrinks;
+        mostlyDrinks.push_back(OrderLine{1, 1, 899});
+        mostlyDrinks.push_back(OrderLine{3, 2, 150});
+        mostlyDrinks.push_back(OrderLine{4, 1, 200});
+        CHECK(stations.stationFor(orderOf(2, mostlyDrinks)) == 2);
+
+        // A tie goes to the earlier line
+        OrderLines tie;
+        tie.push_back(OrderLine{3, 1, 150});
+        tie.push_back(OrderLine{1, 1, 899});
+        CHECK(stations.stationFor(orderOf(3, tie)) == 2);
+
+        OrderLines unknown;
+        unknown.push_back(OrderLine{99, 1, 100});
+        CHECK(stations.stationFor(orderOf(4, unknown)) == 0);
+        CHECK(stations.stationFor(orderOf(5, OrderLines())) == 0);
+
+        // Items added later are routed once the menu is updated
+        menu.add(MenuItem(5, "Minestrone", "Vegetable", 4.5, "Soup"));
+        OrderLines soup;
+        soup.push_back(OrderLine{5, 1, 450});
+        CHECK(stations.stationFor(orderOf(6, soup)) == 0);
+        stations.updateMenu(menu);
+        CHECK(stations.getStationCount() == 4 && stations.stationFor(orderOf(6, soup)) == 3);
+    }
+
+    // Consumers started once keep completing orders, including at stations added while they run
+    void testConsumers() {
+        DynamicArrayList menu;
+        fillMenu(menu);
+        Stack completed;
+        StationQueues stations(menu, completed);
+        stations.startConsumers();
+
+        for (int i = 0; i < 200; i++) {
+            Order order = testOrder(i + 1, "Grace", i % 4 + 1);
+            stations.enqueue(std::move(order));
+        }
+        stations.waitIdle();
+        CHECK(completed.getSize() == 200);
+
+        menu.add(MenuItem(5, "Minestrone", "Vegetable", 4.5, "Soup"));
+        stations.updateMenu(menu);
+        OrderLines soup;
+        soup.push_back(OrderLine{5, 3, 450});
+        CHECK(stations.enqueue(orderOf(500, soup)) == 3);
+        stations.waitIdle();
+        CHECK(completed.getSize() == 201 && stations.size(3) == 0);
+        stations.stopConsumers();
+    }
+}
+
+int main() {
+    testRouting();
+    testConsumers();
+    return testResult();
+}
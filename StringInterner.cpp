@@ -0,0 +1,29 @@
+#include "StringInterner.h"
+
+uint32_t StringInterner::intern(const string &value) {
+    auto found = handles.find(value);
+    if (found != handles.end()) {
+        return found->second;
+    }
+    uint32_t handle = (uint32_t) values.size();
+    values.push_back(value);
+    handles.emplace(value, handle);
+    return handle;
+}
+
+bool StringInterner::find(const string &value, uint32_t &handle) const {
+    auto found = handles.find(value);
+    if (found == handles.end()) {
+        return false;
+    }
+    handle = found->second;
+    return true;
+}
+
+const string &StringInterner::lookup(uint32_t handle) const {
+    return values[handle];
+}
+
+uint32_t StringInterner::getSize() const {
+    return (uint32_t) values.size();
+}
@@ -0,0 +1,53 @@
+#ifndef STRINGINTERNER_H
+#define STRINGINTERNER_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  StringInterner                                                        *
+ *  Maps each distinct string to a small dense handle (0, 1, 2, ...), so  *
+ *  repeated values such as customer names are stored once and compared  *
+ *  or grouped as integers.                                               *
+ *------------------------------------------------------------------------*/
+class StringInterner {
+public:
+    /*------------------------------------------------------------------------*
+     *  intern                                                                *
+     *  Returns the handle of value, assigning the next handle if it is new.  *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: lookup(returned handle) == value.                      *
+     *------------------------------------------------------------------------*/
+    uint32_t intern(const string &value);
+
+    /*------------------------------------------------------------------------*
+     *  find                                                                  *
+     *  Looks up the handle of value without interning it.                    *
+     *                                                                        *
+     *  Precondition:  None.                                                  *
+     *  Postcondition: Returns true and sets handle if value is interned.     *
+     *------------------------------------------------------------------------*/
+    bool find(const string &value, uint32_t &handle) const;
+
+    /*------------------------------------------------------------------------*
+     *  lookup                                                                *
+     *  Returns the string of a handle.                                       *
+     *                                                                        *
+     *  Precondition:  handle < getSize().                                    *
+     *------------------------------------------------------------------------*/
+    const string &lookup(uint32_t handle) const;
+
+    // Number of distinct strings interned
+    uint32_t getSize() const;
+
+private:
+    vector<string> values; // values[handle] is the interned string
+    unordered_map<string, uint32_t> handles; // string -> handle
+};
+
+#endif //STRINGINTERNER_H
@@ -0,0 +1,52 @@
+#ifndef TESTCHECK_H
+#define TESTCHECK_H
+
+#include <iostream>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  CHECK                                                                 *
+ *  Test assertion that also runs in Release builds. A failed check is   *
+ *  reported with its location and counted; a test program returns       *
+ *  testResult() from main, so CTest sees the failure.                    *
+ *------------------------------------------------------------------------*/
+inline int &testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << endl; \
+            testFailures()++;                                                             \
+        }                                                                                 \
+    } while (false)
+
+// Runs statement and checks that it throws an exception of the given type
+#define CHECK_THROWS(statement, type)                                                      \
+    do {                                                                                   \
+        bool thrown = false;                                                               \
+        try {                                                                              \
+            statement;                                                                     \
+        } catch (const type &) {                                                           \
+            thrown = true;                                                                 \
+        }                                                                                  \
+        if (!thrown) {                                                                     \
+            cerr << __FILE__ << ":" << __LINE__ << ": did not throw " #type ": " #statement \
+                 << endl;                                                                  \
+            testFailures()++;                                                              \
+        }                                                                                  \
+    } while (false)
+
+// Exit status of a test program: 0 if every check passed
+inline int testResult() {
+    if (testFailures() > 0) {
+        cerr << testFailures() << " check(s) failed" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+#endif //TESTCHECK_H
@@ -0,0 +1,39 @@
+#ifndef TESTORDERS_H
+#define TESTORDERS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Order.h"
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  testOrder                                                             *
+ *  Order fixture shared by the tests. Line i orders item i + 1, with    *
+ *  quantity i % 4 + 1, at unitPriceCents; the total is the sum of the    *
+ *  lines.                                                                *
+ *------------------------------------------------------------------------*/
+inline Order testOrder(int64_t orderId, const string &customerName, int lineCount = 2, int64_t unitPriceCents = 250,
+                       bool completed = false) {
+    OrderLines lines;
+    int64_t totalCents = 0;
+    for (int i = 0; i < lineCount; i++) {
+        lines.push_back(OrderLine{i + 1, i % 4 + 1, unitPriceCents});
+        totalCents += (i % 4 + 1) * unitPriceCents;
+    }
+    return Order(orderId, customerName, lines, totalCents / 100.0, completed);
+}
+
+// IDs of the orders of a Queue or Stack, in iteration order
+template <typename Container>
+vector<int64_t> orderIds(const Container &orders) {
+    vector<int64_t> ids;
+    for (const Order &order : orders) {
+        ids.push_back(order.getOrderId());
+    }
+    return ids;
+}
+
+#endif //TESTORDERS_H
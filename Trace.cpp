@@ -0,0 +1,151 @@
+#include "Trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    struct Event {
+        const char *name;
+        uint64_t start; // nanoseconds since the trace epoch
+        uint64_t duration; // spans only
+        int64_t orderId; // lifecycle events only
+        char phase; // X span, b/n/e order begin, step and end
+    };
+
+    // One thread's events; the thread appends, dump copies them out
+    struct Buffer {
+        int thread;
+        mutex lock;
+        vector<Event> events;
+        uint64_t dropped = 0;
+    };
+
+    struct Registry {
+        mutex lock;
+        vector<shared_ptr<Buffer>> buffers; // kept after their thread ends
+    };
+
+    Registry &registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+
+    uint64_t now() {
+        return (uint64_t) chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+    }
+
+    Buffer &localBuffer() {
+        thread_local shared_ptr<Buffer> buffer;
+        if (!buffer) {
+            buffer = make_shared<Buffer>();
+            Registry &buffers = registry();
+            lock_guard<mutex> guard(buffers.lock);
+            buffer->thread = (int) buffers.buffers.size() + 1;
+            buffers.buffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+
+    void append(const Event &event) {
+        Buffer &buffer = localBuffer();
+        lock_guard<mutex> guard(buffer.lock); // only contended while a dump copies the buffer
+        if (buffer.events.size() < Trace::maxEventsPerThread) {
+            buffer.events.push_back(event);
+        } else {
+            buffer.dropped++;
+        }
+    }
+
+    // Nanoseconds as the microseconds the trace format counts in
+    string micros(uint64_t nanoseconds) {
+        char text[32];
+        snprintf(text, sizeof(text), "%llu.%03llu", (unsigned long long) (nanoseconds / 1000),
+                 (unsigned long long) (nanoseconds % 1000));
+        return text;
+    }
+}
+
+Trace::Span::Span(const char *name) : name(name), start(now()) {
+}
+
+Trace::Span::~Span() {
+    uint64_t end = now();
+    append(Event{name, start, end - start, 0, 'X'});
+}
+
+void Trace::orderBegin(int64_t orderId) {
+    append(Event{"order", now(), 0, orderId, 'b'});
+}
+
+void Trace::orderStep(const char *name, int64_t orderId) {
+    append(Event{name, now(), 0, orderId, 'n'});
+}
+
+void Trace::orderEnd(int64_t orderId) {
+    append(Event{"order", now(), 0, orderId, 'e'});
+}
+
+bool Trace::dump(const string &path) {
+    vector<shared_ptr<Buffer>> buffers;
+    {
+        Registry &all = registry();
+        lock_guard<mutex> guard(all.lock);
+        buffers = all.buffers;
+    }
+
+    ofstream out(path, ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n"
+        << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"orders\"}}";
+    for (const shared_ptr<Buffer> &buffer : buffers) {
+        vector<Event> events;
+        {
+            lock_guard<mutex> guard(buffer->lock);
+            events = buffer->events;
+        }
+        string thread = to_string(buffer->thread);
+        for (const Event &event : events) {
+            out << ",\n{\"name\": \"" << event.name << "\", \"ph\": \"" << event.phase << "\", \"ts\": "
+                << micros(event.start) << ", \"pid\": 1, \"tid\": " << thread;
+            if (event.phase == 'X') {
+                out << ", \"cat\": \"span\", \"dur\": " << micros(event.duration) << "}";
+            } else {
+                // Quoted: order IDs do not fit the doubles JSON numbers are read as
+                out << ", \"cat\": \"order\", \"id\": \"" << event.orderId << "\", \"args\": {\"order\": \""
+                    << event.orderId << "\"}}";
+            }
+        }
+    }
+    out << "\n]}\n";
+    return (bool) out;
+}
+
+uint64_t Trace::getEventCount() {
+    Registry &all = registry();
+    lock_guard<mutex> guard(all.lock);
+    uint64_t count = 0;
+    for (const shared_ptr<Buffer> &buffer : all.buffers) {
+        lock_guard<mutex> bufferGuard(buffer->lock);
+        count += buffer->events.size();
+    }
+    return count;
+}
+
+uint64_t Trace::getDroppedCount() {
+    Registry &all = registry();
+    lock_guard<mutex> guard(all.lock);
+    uint64_t count = 0;
+    for (const shared_ptr<Buffer> &buffer : all.buffers) {
+        lock_guard<mutex> bufferGuard(buffer->lock);
+        count += buffer->dropped;
+    }
+    return count;
+}
@@ -0,0 +1,94 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  Trace                                                                 *
+ *  Records where orders spend their time, for a trace viewer such as    *
+ *  chrome://tracing or Perfetto:                                         *
+ *                                                                        *
+ *    - spans: a named operation on one thread, from start to end,       *
+ *      e.g. Queue::enqueue or DynamicArrayList::loadMenu;               *
+ *    - order lifecycles: one async track per order, from its enqueue,   *
+ *      through steps such as its dequeue, to its push onto the          *
+ *      completed orders.                                                 *
+ *                                                                        *
+ *  Tracing is compiled in only with ORDERS_TRACING defined (the CMake   *
+ *  option of the same name). Code records through the TRACE_ macros     *
+ *  below, which otherwise expand to nothing: their arguments are not    *
+ *  even evaluated.                                                       *
+ *                                                                        *
+ *  Each thread appends to a buffer of its own; dump writes every        *
+ *  buffer as Chrome trace-event JSON.                                    *
+ *------------------------------------------------------------------------*/
+class Trace {
+public:
+#ifdef ORDERS_TRACING
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    // Events a thread keeps; later ones are counted as dropped
+    static const size_t maxEventsPerThread = 1 << 20;
+
+    // Records the time from its construction to its destruction as a span
+    class Span {
+    public:
+        explicit Span(const char *name);
+
+        ~Span();
+
+        Span(const Span &span) = delete;
+
+        Span &operator=(const Span &span) = delete;
+
+    private:
+        const char *name;
+        uint64_t start;
+    };
+
+    // Order lifecycle events; name must be a string literal, it is kept by address
+    static void orderBegin(int64_t orderId);
+
+    static void orderStep(const char *name, int64_t orderId);
+
+    static void orderEnd(int64_t orderId);
+
+    /*------------------------------------------------------------------------*
+     *  dump                                                                  *
+     *  Writes every event recorded so far, of every thread, to path as      *
+     *  Chrome trace-event JSON.                                              *
+     *                                                                        *
+     *  Precondition:  None; threads may go on recording.                     *
+     *  Postcondition: Returns false if path could not be written. Events    *
+     *                 recorded meanwhile may or may not be included.         *
+     *------------------------------------------------------------------------*/
+    static bool dump(const string &path);
+
+    // Events recorded and dropped since start
+    static uint64_t getEventCount();
+
+    static uint64_t getDroppedCount();
+};
+
+#define TRACE_JOIN_NAME(prefix, line) prefix##line
+#define TRACE_SPAN_NAME(prefix, line) TRACE_JOIN_NAME(prefix, line)
+
+#ifdef ORDERS_TRACING
+#define TRACE_SPAN(name) Trace::Span TRACE_SPAN_NAME(traceSpan, __LINE__)(name)
+#define TRACE_ORDER_BEGIN(orderId) Trace::orderBegin(orderId)
+#define TRACE_ORDER_STEP(name, orderId) Trace::orderStep(name, orderId)
+#define TRACE_ORDER_END(orderId) Trace::orderEnd(orderId)
+#else
+#define TRACE_SPAN(name) ((void) 0)
+#define TRACE_ORDER_BEGIN(orderId) ((void) 0)
+#define TRACE_ORDER_STEP(name, orderId) ((void) 0)
+#define TRACE_ORDER_END(orderId) ((void) 0)
+#endif
+
+#endif //TRACE_H
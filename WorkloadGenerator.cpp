@@ -0,0 +1,211 @@
+#include "WorkloadGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+    const double opening = 11 * 3600; // seconds after midnight
+    const double closing = 22 * 3600;
+    const double dayLength = 24 * 3600;
+
+    // A category of the catalog: how often it occurs, its price range and name parts
+    struct Category {
+        const char *name;
+        double share;
+        double minPrice;
+        double maxPrice;
+        vector<const char *> styles;
+        vector<const char *> dishes;
+        vector<const char *> sides;
+    };
+
+    const vector<Category> categories = {
+        {"Starter", 0.20, 4, 12,
+         {"Crispy", "Spicy", "Garlic", "Smoked", "Grilled", "Stuffed", "Honey", "Salt and Pepper"},
+         {"Chicken Wings", "Calamari", "Bruschetta", "Spring Rolls", "Nachos", "Mushrooms", "Prawns", "Soup"},
+         {"aioli", "sweet chili", "salsa", "herbs", "lime", "blue cheese dip"}},
+        {"Main", 0.35, 9, 28,
+         {"Classic", "Roasted", "Braised", "Pan Seared", "Cajun", "Teriyaki", "Herb Crusted", "BBQ"},
+         {"Burger", "Steak", "Salmon", "Chicken", "Pork Ribs", "Lamb Shank", "Risotto", "Pasta", "Curry", "Tacos"},
+         {"fries", "mashed potatoes", "seasonal vegetables", "rice", "salad", "coleslaw"}},
+        {"Pizza", 0.15, 10, 20,
+         {"Margherita", "Pepperoni", "Hawaiian", "Four Cheese", "Veggie", "Meat Lovers", "Truffle", "Diavola"},
+         {"Pizza", "Flatbread", "Calzone"},
+         {"basil", "mozzarella", "olives", "rocket", "chili oil"}},
+        {"Dessert", 0.12, 4, 10,
+         {"Chocolate", "Vanilla", "Salted Caramel", "Lemon", "Berry", "Pistachio"},
+         {"Cheesecake", "Brownie", "Tart", "Ice Cream", "Mousse", "Pudding"},
+         {"cream", "custard", "fresh fruit", "toffee sauce"}},
+        {"Drink", 0.18, 1.5, 6,
+         {"Iced", "Fresh", "Sparkling", "Hot", "Mango", "Peach"},
+         {"Lemonade", "Tea", "Coffee", "Juice", "Soda", "Smoothie"},
+         {"mint", "ginger", "lemon", "honey"}},
+    };
+
+    const vector<const char *> firstNames = {
+        "Maria", "James", "Aisha", "Chen", "Sofia", "Liam", "Priya", "Noah", "Elena", "Omar",
+        "Hana", "Lucas", "Fatima", "Mateo", "Yuki", "Ethan", "Amara", "Leo", "Ines", "Daniel",
+        "Zara", "Marco", "Nadia", "Ivan", "Grace", "Kofi", "Lena", "Diego", "Mei", "Samuel"};
+
+    const vector<const char *> lastNames = {
+        "Garcia", "Smith", "Khan", "Wang", "Rossi", "Murphy", "Patel", "Brown", "Novak", "Haddad",
+        "Tanaka", "Silva", "Ali", "Lopez", "Sato", "Jones", "Okafor", "Martin", "Costa", "Cohen",
+        "Ahmed", "Bianchi", "Popov", "Kim", "Mensah", "Weber", "Diaz", "Nguyen", "Fischer", "Walker"};
+
+    // A normal bump of height 1 centered on peak (seconds after midnight)
+    double bump(double timeOfDay, double peak, double width) {
+        double distance = (timeOfDay - peak) / width;
+        return exp(-0.5 * distance * distance);
+    }
+}
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadProfile &profile)
+    : profile(profile), random(profile.seed) {
+    customerWeights = zipf((size_t) max(profile.customerCount, 1), 1.0);
+}
+
+void WorkloadGenerator::generateMenu(DynamicArrayList &menu) {
+    uniform_real_distribution<double> unit(0, 1);
+    for (int id = 1; id <= profile.menuSize; id++) {
+        double draw = unit(random);
+        const Category *category = &categories.back();
+        for (const Category &candidate : categories) {
+            if (draw < candidate.share) {
+                category = &candidate;
+                break;
+            }
+            draw -= candidate.share;
+        }
+        auto part = [this](const vector<const char *> &parts) {
+            return string(parts[uniform_int_distribution<size_t>(0, parts.size() - 1)(random)]);
+        };
+        string name = part(category->styles) + " " + part(category->dishes);
+        string description = category->name + string(" with ") + part(category->sides);
+
+        // Log-uniform within the range, priced to end in .49 or .99
+        double price = category->minPrice * pow(category->maxPrice / category->minPrice, unit(random));
+        price = max(0.49, round(price * 2) / 2 - 0.01);
+        menu.add(MenuItem(id, name, description, round(price * 100) / 100, category->name));
+    }
+    MenuItem::reserveIdsThrough(profile.menuSize);
+}
+
+WorkloadGenerator::Arrival WorkloadGenerator::next(const DynamicArrayList &menu) {
+    if (itemWeights.size() != (size_t) menu.getSize()) {
+        itemWeights = zipf((size_t) menu.getSize(), profile.popularitySkew);
+    }
+
+    // Thinning: draw arrivals at the peak rate, keep each with probability rate / peak rate
+    double peakRate = profile.ordersPerHour * max(profile.peakFactor, 1.0) / 3600;
+    exponential_distribution<double> gap(peakRate);
+    uniform_real_distribution<double> unit(0, 1);
+    do {
+        clock += gap(random);
+        double timeOfDay = fmod(clock + opening, dayLength);
+        if (timeOfDay >= closing) {
+            clock += dayLength - timeOfDay + opening; // closed: skip to the next opening
+        }
+    } while (unit(random) * peakRate * 3600 > rateAt(clock));
+
+    // 1 + Poisson distinct items, each mostly ordered once
+    poisson_distribution<int> extra(max(profile.basketSize - 1, 0.0));
+    int lineCount = min(1 + (profile.basketSize > 1 ? extra(random) : 0), menu.getSize());
+    Order order(customerName(pick(customerWeights)), OrderLines());
+    vector<size_t> chosen;
+    for (int i = 0; i < lineCount; i++) {
+        chosen.push_back(pickOther(itemWeights, chosen));
+        double draw = unit(random);
+        int quantity = draw < 0.8 ? 1 : draw < 0.95 ? 2 : 3;
+        order.addItem(menu.getMenuItem((int) chosen.back()), quantity);
+    }
+    return Arrival{clock, std::move(order)};
+}
+
+double WorkloadGenerator::rateAt(double time) const {
+    double timeOfDay = fmod(time + opening, dayLength);
+    if (timeOfDay < opening || timeOfDay >= closing) {
+        return 0;
+    }
+    double peak = max(bump(timeOfDay, 12.5 * 3600, 2400), bump(timeOfDay, 19 * 3600, 3600));
+    return profile.ordersPerHour * (1 + (max(profile.peakFactor, 1.0) - 1) * peak);
+}
+
+void WorkloadGenerator::writeMenu(ostream &out, const DynamicArrayList &menu) {
+    char price[32];
+    for (int i = 0; i < menu.getSize(); i++) {
+        const MenuItem &item = menu.getMenuItem(i);
+        snprintf(price, sizeof(price), "%.2f", item.getPrice());
+        out << item.getId() << "," << item.getName() << "," << item.getDescription() << "," << price << ","
+            << item.getCategory() << "\n";
+    }
+}
+
+string WorkloadGenerator::toCommand(const Order &order) {
+    string command = "add-order " + order.getCustomerName();
+    for (const OrderLine &line : order.getLines()) {
+        command += "," + to_string(line.menuItemId);
+        if (line.quantity != 1) {
+            command += "x" + to_string(line.quantity);
+        }
+    }
+    return command;
+}
+
+string WorkloadGenerator::clockTime(double time) {
+    double sinceMidnight = time + opening;
+    int day = (int) (sinceMidnight / dayLength) + 1;
+    int minutes = (int) (fmod(sinceMidnight, dayLength) / 60);
+    char text[32];
+    snprintf(text, sizeof(text), "day %d %02d:%02d", day, minutes / 60, minutes % 60);
+    return text;
+}
+
+size_t WorkloadGenerator::pick(const vector<double> &cumulative) {
+    double draw = uniform_real_distribution<double>(0, cumulative.back())(random);
+    size_t index = upper_bound(cumulative.begin(), cumulative.end(), draw) - cumulative.begin();
+    return min(index, cumulative.size() - 1);
+}
+
+size_t WorkloadGenerator::pickOther(const vector<double> &cumulative, const vector<size_t> &taken) {
+    /*------------------------------------------------------------*
+     *  pickOther                                                 *
+     *  Redraws while the draw is taken, which baskets far        *
+     *  smaller than the menu rarely need. Should the skew make   *
+     *  the remaining items too unlikely, the most popular item   *
+     *  not taken is used instead of drawing on.                  *
+     *------------------------------------------------------------*/
+    for (int attempt = 0; attempt < 32; attempt++) {
+        size_t index = pick(cumulative);
+        if (find(taken.begin(), taken.end(), index) == taken.end()) {
+            return index;
+        }
+    }
+    size_t index = 0;
+    while (find(taken.begin(), taken.end(), index) != taken.end()) {
+        index++;
+    }
+    return index;
+}
+
+string WorkloadGenerator::customerName(size_t customer) const {
+    // Step through the last names with the first ones, so the regulars are not all one family
+    size_t pairs = firstNames.size() * lastNames.size();
+    size_t first = customer % firstNames.size();
+    size_t last = (customer / firstNames.size() + 7 * first) % lastNames.size();
+    string name = string(firstNames[first]) + " " + lastNames[last];
+    if (customer >= pairs) {
+        name += " " + to_string(customer / pairs + 1); // more customers than name pairs
+    }
+    return name;
+}
+
+vector<double> WorkloadGenerator::zipf(size_t count, double exponent) {
+    vector<double> cumulative(count);
+    double total = 0;
+    for (size_t rank = 0; rank < count; rank++) {
+        total += 1 / pow((double) (rank + 1), exponent);
+        cumulative[rank] = total;
+    }
+    return cumulative;
+}
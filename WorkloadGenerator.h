@@ -0,0 +1,115 @@
+#ifndef WORKLOADGENERATOR_H
+#define WORKLOADGENERATOR_H
+
+#include "DynamicArrayList.h"
+#include "Order.h"
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*------------------------------------------------------------------------*
+ *  WorkloadProfile                                                       *
+ *  The shape of a synthetic restaurant: how big the menu is, how fast   *
+ *  and how unevenly orders arrive and how much each one asks for.        *
+ *------------------------------------------------------------------------*/
+struct WorkloadProfile {
+    int menuSize = 200; // items in the generated catalog
+    int orderCount = 10000; // orders in the stream
+    double ordersPerHour = 120; // arrival rate outside the peaks
+    double peakFactor = 4; // arrival rate at the lunch and dinner peaks, as a multiple
+    double basketSize = 2.5; // mean distinct items per order, at least 1
+    double popularitySkew = 1.0; // Zipf exponent: 0 makes every item equally popular
+    int customerCount = 2000; // distinct customers, regulars ordering most often
+    uint64_t seed = 1; // same seed and profile, same catalog and stream
+};
+
+/*------------------------------------------------------------------------*
+ *  WorkloadGenerator                                                     *
+ *  Synthesizes a catalog and an order stream that look like a real      *
+ *  restaurant's, so features can be measured at production volume:      *
+ *                                                                        *
+ *    - items fall into categories (starters, mains, pizzas, desserts,   *
+ *      drinks), each with its own name parts and price range;           *
+ *    - a few items sell most: popularity follows a Zipf distribution;   *
+ *    - orders arrive as a Poisson process whose rate rises to peaks     *
+ *      around 12:30 and 19:00, between opening at 11:00 and closing at  *
+ *      22:00; the stream runs on into the following days if needed;     *
+ *    - baskets hold 1 plus a Poisson count of distinct items, mostly    *
+ *      one of each.                                                     *
+ *                                                                        *
+ *  Everything is drawn from one seeded engine, so a profile always      *
+ *  yields the same workload.                                             *
+ *------------------------------------------------------------------------*/
+class WorkloadGenerator {
+public:
+    // One order of the stream
+    struct Arrival {
+        double time; // seconds since the first opening
+        Order order;
+    };
+
+    /*------------------------------------------------------------------------*
+     *  WorkloadGenerator                                                     *
+     *  Parameterized constructor.                                            *
+     *                                                                        *
+     *  Precondition:  The profile's counts and rates are positive.          *
+     *  Postcondition: The stream starts at the first opening.                *
+     *------------------------------------------------------------------------*/
+    explicit WorkloadGenerator(const WorkloadProfile &profile);
+
+    /*------------------------------------------------------------------------*
+     *  generateMenu                                                          *
+     *  Fills menu with the profile's catalog, its items numbered from 1.     *
+     *                                                                        *
+     *  Precondition:  menu is empty.                                         *
+     *  Postcondition: menu holds profile.menuSize items; later menu items   *
+     *                 get higher IDs.                                        *
+     *------------------------------------------------------------------------*/
+    void generateMenu(DynamicArrayList &menu);
+
+    /*------------------------------------------------------------------------*
+     *  next                                                                  *
+     *  Generates the next order of the stream.                               *
+     *                                                                        *
+     *  Precondition:  menu is not empty and is the same for every call.     *
+     *  Postcondition: Arrival times never decrease.                          *
+     *------------------------------------------------------------------------*/
+    Arrival next(const DynamicArrayList &menu);
+
+    // Arrival rate, in orders per hour, at time seconds since the first opening
+    double rateAt(double time) const;
+
+    // Writes menu in the format of menu.txt
+    static void writeMenu(ostream &out, const DynamicArrayList &menu);
+
+    // The order as an add-order command of CommandScript
+    static string toCommand(const Order &order);
+
+    // Formats time as "day d hh:mm"
+    static string clockTime(double time);
+
+private:
+    WorkloadProfile profile;
+    mt19937_64 random;
+    double clock = 0; // time of the last arrival
+
+    vector<double> itemWeights; // cumulative Zipf weights of the menu positions
+    vector<double> customerWeights; // cumulative Zipf weights of the customers
+
+    // Draws from cumulative weights
+    size_t pick(const vector<double> &cumulative);
+
+    // Draws from cumulative weights an index not in taken; taken leaves one free
+    size_t pickOther(const vector<double> &cumulative, const vector<size_t> &taken);
+
+    string customerName(size_t customer) const;
+
+    static vector<double> zipf(size_t count, double exponent);
+};
+
+#endif //WORKLOADGENERATOR_H
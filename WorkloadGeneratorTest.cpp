@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <set>
+
+#include "TestCheck.h"
+#include "WorkloadGenerator.h"
+
+using namespace std;
+
+namespace {
+    // Baskets hold distinct items even when a few items take nearly every draw
+    void testBasketsHoldDistinctItems() {
+        WorkloadProfile profile;
+        profile.menuSize = 6;
+        profile.basketSize = 5;
+        profile.popularitySkew = 4;
+        WorkloadGenerator generator(profile);
+        DynamicArrayList menu;
+        generator.generateMenu(menu);
+
+        bool distinct = true;
+        bool bounded = true;
+        size_t largest = 0;
+        for (int i = 0; i < 2000; i++) {
+            WorkloadGenerator::Arrival arrival = generator.next(menu);
+            set<int> items;
+            for (const OrderLine &line : arrival.order.getLines()) {
+                items.insert(line.menuItemId);
+                bounded = bounded && line.quantity >= 1 && line.quantity <= 3;
+            }
+            distinct = distinct && items.size() == arrival.order.getLines().size();
+            largest = max(largest, items.size());
+        }
+        CHECK(distinct && bounded);
+        CHECK(largest == 6); // some baskets take the whole menu
+    }
+
+    void testSameSeedSameStream() {
+        WorkloadProfile profile;
+        profile.menuSize = 50;
+        WorkloadGenerator first(profile);
+        WorkloadGenerator second(profile);
+        DynamicArrayList firstMenu;
+        DynamicArrayList secondMenu;
+        first.generateMenu(firstMenu);
+        second.generateMenu(secondMenu);
+
+        bool same = true;
+        for (int i = 0; i < 500; i++) {
+            WorkloadGenerator::Arrival a = first.next(firstMenu);
+            WorkloadGenerator::Arrival b = second.next(secondMenu);
+            same = same && a.time == b.time
+                   && WorkloadGenerator::toCommand(a.order) == WorkloadGenerator::toCommand(b.order);
+        }
+        CHECK(same);
+    }
+}
+
+int main() {
+    testBasketsHoldDistinctItems();
+    testSameSeedSameStream();
+    return testResult();
+}
@@ -0,0 +1,216 @@
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+#include "Benchmark.h"
+#include "CommandScript.h"
+#include "DynamicArrayList.h"
+#include "FileHandler.h"
+#include "Queue.h"
+#include "Stack.h"
+
+using namespace std;
+
+namespace {
+    const vector<long> containerSizes = {16, 1024, 65536};
+    const vector<long> fileSizes = {16, 1024, 16384};
+
+    MenuItem sampleItem(long i) {
+        return MenuItem((int) i + 1, "Item " + to_string(i), "Sample dish", 9.99);
+    }
+
+    Order sampleOrder() {
+        static const MenuItem item = sampleItem(0);
+        static const MenuItem side = sampleItem(1);
+        Order order("Sample customer", OrderLines());
+        order.addItem(item, 2);
+        order.addItem(side);
+        return order;
+    }
+
+    unique_ptr<DynamicArrayList> filledList(long size) {
+        unique_ptr<DynamicArrayList> list = make_unique<DynamicArrayList>();
+        for (long i = 0; i < size; i++) {
+            list->add(sampleItem(i));
+        }
+        return list;
+    }
+
+    unique_ptr<Queue> filledQueue(long size) {
+        unique_ptr<Queue> queue = make_unique<Queue>();
+        for (long i = 0; i < size; i++) {
+            queue->enqueue(sampleOrder());
+        }
+        return queue;
+    }
+
+    unique_ptr<Stack> filledStack(long size) {
+        unique_ptr<Stack> stack = make_unique<Stack>();
+        for (long i = 0; i < size; i++) {
+            stack->push(sampleOrder());
+        }
+        return stack;
+    }
+
+    // Writes a file of lines lines shaped like menu.txt
+    void writeLines(const string &fileName, long lines) {
+        ofstream file(fileName, ios::trunc);
+        for (long i = 0; i < lines; i++) {
+            file << i + 1 << ",Item " << i << ",Sample dish," << 9.99 << "\n";
+        }
+    }
+
+    // Operations that leave the structure as it was can run many times per fixture
+    const uint64_t manyOps = 1 << 20;
+
+    void registerAll(Benchmark &benchmarks) {
+        // DynamicArrayList: filling an empty list, removing from the middle, one doubling
+        benchmarks.add("DynamicArrayList::add", containerSizes, [](Benchmark::State &state) {
+            MenuItem item = sampleItem(0);
+            state.repeat([] { return make_unique<DynamicArrayList>(); },
+                         [&item](unique_ptr<DynamicArrayList> &list, uint64_t) { list->add(item); },
+                         state.size);
+        });
+        benchmarks.add("DynamicArrayList::remove", containerSizes, [](Benchmark::State &state) {
+            state.repeat([&state] { return filledList(state.size); },
+                         [](unique_ptr<DynamicArrayList> &list, uint64_t) { list->remove(list->getSize() / 2); },
+                         state.size);
+        });
+        benchmarks.add("DynamicArrayList::resize", containerSizes, [](Benchmark::State &state) {
+            state.repeat([&state] { return filledList(state.size); },
+                         [](unique_ptr<DynamicArrayList> &list, uint64_t) { list->resize(); }, 1);
+        });
+
+        // Queue: filling an empty queue, draining a full one, asking its size
+        benchmarks.add("Queue::enqueue", containerSizes, [](Benchmark::State &state) {
+            Order order = sampleOrder();
+            state.repeat([] { return make_unique<Queue>(); },
+                         [&order](unique_ptr<Queue> &queue, uint64_t) { queue->enqueue(order); }, state.size);
+        });
+        benchmarks.add("Queue::dequeue", containerSizes, [](Benchmark::State &state) {
+            state.repeat([&state] { return filledQueue(state.size); },
+                         [](unique_ptr<Queue> &queue, uint64_t) { Benchmark::keep(queue->dequeue()); },
+                         state.size);
+        });
+        benchmarks.add("Queue::size", containerSizes, [](Benchmark::State &state) {
+            state.repeat([&state] { return filledQueue(state.size); },
+                         [](unique_ptr<Queue> &queue, uint64_t) { Benchmark::keep(queue->size()); }, manyOps);
+        });
+
+        // Stack: completing orders, taking them back, and the revenue total over all of them
+        benchmarks.add("Stack::push", containerSizes, [](Benchmark::State &state) {
+            Order order = sampleOrder();
+            state.repeat([] { return make_unique<Stack>(); },
+                         [&order](unique_ptr<Stack> &stack, uint64_t) { stack->push(order); }, state.size);
+        });
+        benchmarks.add("Stack::pop", containerSizes, [](Benchmark::State &state) {
+            state.repeat([&state] { return filledStack(state.size); },
+                         [](unique_ptr<Stack> &stack, uint64_t) { Benchmark::keep(stack->pop()); }, state.size);
+        });
+        benchmarks.add("Stack::getSize", containerSizes, [](Benchmark::State &state) {
+            state.repeat([&state] { return filledStack(state.size); },
+                         [](unique_ptr<Stack> &stack, uint64_t) { Benchmark::keep(stack->getSize()); }, manyOps);
+        });
+        benchmarks.add("Stack::calculateTotalRevenue", containerSizes, [](Benchmark::State &state) {
+            state.repeat([&state] { return filledStack(state.size); },
+                         [](unique_ptr<Stack> &stack, uint64_t) {
+                             stack->calculateTotalRevenue();
+                             Benchmark::keep(stack->getTotalRevenue());
+                         }, manyOps);
+        });
+
+        // FileHandler: size is the number of lines written, appended or read
+        benchmarks.add("FileHandler::write", fileSizes, [](Benchmark::State &state) {
+            string content;
+            for (long i = 0; i < state.size; i++) {
+                content += to_string(i + 1) + ",Item " + to_string(i) + ",Sample dish,9.99\n";
+            }
+            content.pop_back(); // write adds the last newline
+            state.repeat([] { return make_unique<FileHandler>("bench_write.txt"); },
+                         [&content](unique_ptr<FileHandler> &file, uint64_t) { file->write(content); }, manyOps);
+        });
+        benchmarks.add("FileHandler::append", fileSizes, [](Benchmark::State &state) {
+            state.repeat([] {
+                             remove("bench_append.txt");
+                             return make_unique<FileHandler>("bench_append.txt");
+                         },
+                         [](unique_ptr<FileHandler> &file, uint64_t i) { file->append("Line " + to_string(i)); },
+                         state.size);
+        });
+        benchmarks.add("FileHandler::read", fileSizes, [](Benchmark::State &state) {
+            writeLines("bench_read.txt", state.size);
+            state.repeat([] { return make_unique<FileHandler>("bench_read.txt"); },
+                         [](unique_ptr<FileHandler> &file, uint64_t) { file->read(); }, manyOps);
+        });
+        benchmarks.add("DynamicArrayList::loadMenu", fileSizes, [](Benchmark::State &state) {
+            writeLines("menu.txt", state.size);
+            state.repeat([] { return make_unique<DynamicArrayList>(); },
+                         [](unique_ptr<DynamicArrayList> &list, uint64_t) { list->loadMenu(); }, 1);
+        });
+    }
+}
+
+int main(int argc, char *argv[]) {
+    string jsonPath; // --json: also write the results as JSON to this file (- for stdout)
+    string filter; // --filter: run only benchmarks whose name contains this
+    double minSeconds = 0.2; // --min-time: shortest measured run per benchmark and size
+    bool valid = argc % 2 == 1; // options come in pairs
+    for (int i = 1; valid && i + 1 < argc; i += 2) {
+        string argument = argv[i];
+        if (argument == "--json") {
+            jsonPath = argv[i + 1];
+        } else if (argument == "--filter") {
+            filter = argv[i + 1];
+        } else if (argument == "--min-time") {
+            minSeconds = atof(argv[i + 1]);
+        } else {
+            valid = false;
+        }
+    }
+    if (!valid || minSeconds <= 0) {
+        cerr << "Usage: " << argv[0] << " [--json <file>|-] [--filter <name>] [--min-time <seconds>]" << endl;
+        return 2;
+    }
+
+    ofstream jsonFile; // opened before leaving the working directory
+    if (!jsonPath.empty() && jsonPath != "-") {
+        jsonFile.open(jsonPath);
+        if (!jsonFile) {
+            cerr << "Cannot write " << jsonPath << endl;
+            return 1;
+        }
+    }
+
+    // The file benchmarks, and Stack's revenue total, use fixed names in the working directory
+    filesystem::path original = filesystem::current_path();
+    char scratch[] = "/tmp/order-benchmarks-XXXXXX";
+    if (mkdtemp(scratch) == nullptr) {
+        cerr << "Cannot create a scratch directory." << endl;
+        return 1;
+    }
+    filesystem::current_path(scratch);
+    FileHandler("completed_orders.txt").write("Total Revenue = 0.000000");
+
+    Benchmark benchmarks;
+    registerAll(benchmarks);
+    vector<Benchmark::Result> results;
+    {
+        QuietConsole quiet; // the containers report every order on cout
+        results = benchmarks.run(filter, minSeconds);
+    }
+
+    filesystem::current_path(original);
+    filesystem::remove_all(scratch);
+    if (jsonPath == "-") {
+        Benchmark::printJson(cout, results);
+        return 0;
+    }
+    Benchmark::printTable(cout, results);
+    if (jsonFile.is_open()) {
+        Benchmark::printJson(jsonFile, results);
+    }
+    return 0;
+}
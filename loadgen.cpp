@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "CommandScript.h"
+#include "DynamicArrayList.h"
+#include "OrderCodec.h"
+#include "OrderServer.h"
+#include "Queue.h"
+#include "Stack.h"
+#include "WorkloadGenerator.h"
+
+using namespace std;
+
+namespace {
+    const char *usage =
+        "Usage: loadgen [options] menu <file>        write the catalog in menu.txt format\n"
+        "       loadgen [options] script <file>|-    write the order stream as --script commands\n"
+        "       loadgen [options] drive              run the stream through a Queue and Stack\n"
+        "       loadgen [options] submit <socket>    send the stream to an order server (--serve)\n"
+        "Options: --items N  --orders N  --rate orders/hour  --peak factor  --basket mean items\n"
+        "         --skew zipf exponent  --customers N  --seed N\n"
+        "         --kitchen orders/minute the kitchen completes (script, drive; 0: none)\n"
+        "         --clients N  --batch orders per request  --speed x real time (submit; 0: flat out)\n"
+        "The stream refers to the generated catalog: give the program and the server a menu.txt\n"
+        "written by 'loadgen menu' with the same --items and --seed.\n";
+
+    double secondsSince(chrono::steady_clock::time_point start) {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    // Orders per minute the kitchen completes, turned into whole orders as time passes
+    class Kitchen {
+    public:
+        explicit Kitchen(double perMinute) : perMinute(perMinute) {
+        }
+
+        // Orders completed between the last call and time
+        int advance(double time) {
+            credit += (time - clock) * perMinute / 60;
+            clock = time;
+            int ready = (int) credit;
+            credit -= ready;
+            return ready;
+        }
+
+    private:
+        double perMinute;
+        double clock = 0;
+        double credit = 0;
+    };
+
+    int writeScript(WorkloadGenerator &generator, const DynamicArrayList &menu, const WorkloadProfile &profile,
+                    double kitchenPerMinute, ostream &out) {
+        out << "# " << profile.orderCount << " orders for " << profile.menuSize << " items, seed " << profile.seed
+            << "\n";
+        Kitchen kitchen(kitchenPerMinute);
+        int backlog = 0; // orders the script leaves active
+        for (int i = 0; i < profile.orderCount; i++) {
+            WorkloadGenerator::Arrival arrival = generator.next(menu);
+            int ready = min(kitchen.advance(arrival.time), backlog);
+            if (ready > 0) {
+                out << "process " << ready << "\n";
+                backlog -= ready;
+            }
+            out << WorkloadGenerator::toCommand(arrival.order) << "\n";
+            backlog++;
+        }
+        return out ? 0 : 1;
+    }
+
+    int drive(WorkloadGenerator &generator, const DynamicArrayList &menu, const WorkloadProfile &profile,
+              double kitchenPerMinute) {
+        vector<WorkloadGenerator::Arrival> arrivals;
+        arrivals.reserve(profile.orderCount);
+        size_t lineCount = 0;
+        for (int i = 0; i < profile.orderCount; i++) {
+            arrivals.push_back(generator.next(menu));
+            lineCount += arrivals.back().order.getLines().size();
+        }
+
+        Queue active;
+        Stack completed;
+        Kitchen kitchen(kitchenPerMinute);
+        int backlog = 0; // orders in active, kept here because Queue::size() walks the queue
+        int peakBacklog = 0;
+        double peakTime = 0;
+        chrono::steady_clock::duration enqueueTime{}, processTime{};
+        {
+            QuietConsole quiet; // the containers report every order on cout
+            for (WorkloadGenerator::Arrival &arrival : arrivals) {
+                int ready = kitchen.advance(arrival.time);
+                auto start = chrono::steady_clock::now();
+                if (ready > 0) {
+                    backlog -= active.processNextOrders(&completed, ready);
+                }
+                auto middle = chrono::steady_clock::now();
+                active.enqueue(std::move(arrival.order));
+                auto end = chrono::steady_clock::now();
+                backlog++;
+                processTime += middle - start;
+                enqueueTime += end - middle;
+                if (backlog > peakBacklog) {
+                    peakBacklog = backlog;
+                    peakTime = arrival.time;
+                }
+            }
+        }
+
+        double enqueueSeconds = chrono::duration<double>(enqueueTime).count();
+        double processSeconds = chrono::duration<double>(processTime).count();
+        cout << "Queued " << arrivals.size() << " orders (" << lineCount << " lines), "
+             << (long) (arrivals.size() / max(enqueueSeconds, 1e-9)) << " orders/s" << endl;
+        cout << "Completed " << completed.getSize() << " orders, "
+             << (long) (completed.getSize() / max(processSeconds, 1e-9)) << " orders/s" << endl;
+        cout << "Stream ran to " << WorkloadGenerator::clockTime(arrivals.empty() ? 0 : arrivals.back().time)
+             << "; peak backlog " << peakBacklog << " orders at " << WorkloadGenerator::clockTime(peakTime)
+             << ", " << backlog << " left active" << endl;
+        return 0;
+    }
+
+    int submit(WorkloadGenerator &generator, const DynamicArrayList &menu, const WorkloadProfile &profile,
+               const string &socketPath, int clientCount, int batchSize, double speed) {
+        // Deal the stream out to the clients one batch at a time, in arrival order
+        struct Batch {
+            double time; // arrival of its last order
+            string bytes;
+        };
+        vector<vector<Batch>> batches(clientCount);
+        OrderBatchWriter writer;
+        for (int i = 0; i < profile.orderCount; i++) {
+            WorkloadGenerator::Arrival arrival = generator.next(menu);
+            writer.add(arrival.order);
+            if (writer.getCount() == (uint32_t) batchSize || i == profile.orderCount - 1) {
+                int batch = (i / batchSize) % clientCount;
+                batches[batch].push_back(Batch{arrival.time, writer.finish()});
+            }
+        }
+
+        vector<uint64_t> accepted(clientCount), rejected(clientCount);
+        vector<double> slowest(clientCount), busy(clientCount);
+        vector<string> errors(clientCount);
+        auto start = chrono::steady_clock::now();
+        vector<thread> clients;
+        for (int c = 0; c < clientCount; c++) {
+            clients.emplace_back([&, c] {
+                try {
+                    OrderClient client(socketPath);
+                    for (const Batch &batch : batches[c]) {
+                        if (speed > 0) {
+                            this_thread::sleep_until(start + chrono::duration_cast<chrono::steady_clock::duration>(
+                                                                 chrono::duration<double>(batch.time / speed)));
+                        }
+                        auto sent = chrono::steady_clock::now();
+                        try {
+                            accepted[c] += client.submit(batch.bytes).size();
+                        } catch (const runtime_error &error) {
+                            rejected[c]++;
+                            if (errors[c].empty()) {
+                                errors[c] = error.what();
+                            }
+                        }
+                        double latency = secondsSince(sent);
+                        slowest[c] = max(slowest[c], latency);
+                        busy[c] += latency;
+                    }
+                } catch (const runtime_error &error) {
+                    errors[c] = error.what();
+                }
+            });
+        }
+        for (thread &client : clients) {
+            client.join();
+        }
+        double seconds = secondsSince(start);
+
+        uint64_t acceptedTotal = 0, rejectedTotal = 0, requestCount = 0;
+        double busyTotal = 0, slowestTotal = 0;
+        for (int c = 0; c < clientCount; c++) {
+            acceptedTotal += accepted[c];
+            rejectedTotal += rejected[c];
+            requestCount += batches[c].size();
+            busyTotal += busy[c];
+            slowestTotal = max(slowestTotal, slowest[c]);
+            if (!errors[c].empty()) {
+                cerr << "Client " << c << ": " << errors[c] << endl;
+            }
+        }
+        cout << "Accepted " << acceptedTotal << " orders in " << seconds << " s ("
+             << (long) (acceptedTotal / max(seconds, 1e-9)) << " orders/s), " << rejectedTotal
+             << " batches rejected" << endl;
+        cout << "Request latency: mean " << busyTotal / max(requestCount, (uint64_t) 1) * 1e6 << " us, max "
+             << slowestTotal * 1e6 << " us over " << requestCount << " requests" << endl;
+        return rejectedTotal == 0 && acceptedTotal == (uint64_t) profile.orderCount ? 0 : 1;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    WorkloadProfile profile;
+    double kitchenPerMinute = 20;
+    int clientCount = 4;
+    int batchSize = 50;
+    double speed = 0;
+    vector<string> operands;
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument.rfind("--", 0) != 0) {
+            operands.push_back(argument);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            cerr << usage;
+            return 2;
+        }
+        double value = atof(argv[++i]);
+        if (argument == "--items") {
+            profile.menuSize = (int) value;
+        } else if (argument == "--orders") {
+            profile.orderCount = (int) value;
+        } else if (argument == "--rate") {
+            profile.ordersPerHour = value;
+        } else if (argument == "--peak") {
+            profile.peakFactor = value;
+        } else if (argument == "--basket") {
+            profile.basketSize = value;
+        } else if (argument == "--skew") {
+            profile.popularitySkew = value;
+        } else if (argument == "--customers") {
+            profile.customerCount = (int) value;
+        } else if (argument == "--seed") {
+            profile.seed = strtoull(argv[i], nullptr, 10);
+        } else if (argument == "--kitchen") {
+            kitchenPerMinute = value;
+        } else if (argument == "--clients") {
+            clientCount = (int) value;
+        } else if (argument == "--batch") {
+            batchSize = (int) value;
+        } else if (argument == "--speed") {
+            speed = value;
+        } else {
+            cerr << usage;
+            return 2;
+        }
+    }
+    if (operands.empty() || profile.menuSize <= 0 || profile.orderCount < 0 || profile.ordersPerHour <= 0
+        || profile.customerCount <= 0 || clientCount <= 0 || batchSize <= 0 || kitchenPerMinute < 0) {
+        cerr << usage;
+        return 2;
+    }
+
+    WorkloadGenerator generator(profile);
+    DynamicArrayList menu;
+    generator.generateMenu(menu);
+    const string &command = operands[0];
+
+    if (command == "drive" && operands.size() == 1) {
+        return drive(generator, menu, profile, kitchenPerMinute);
+    }
+    if (command == "submit" && operands.size() == 2) {
+        try {
+            return submit(generator, menu, profile, operands[1], clientCount, batchSize, speed);
+        } catch (const runtime_error &error) {
+            cerr << error.what() << endl;
+            return 1;
+        }
+    }
+    if ((command == "menu" || command == "script") && operands.size() == 2) {
+        ofstream file;
+        if (operands[1] != "-") {
+            file.open(operands[1]);
+            if (!file) {
+                cerr << "Cannot write " << operands[1] << endl;
+                return 1;
+            }
+        }
+        ostream &out = operands[1] == "-" ? cout : file;
+        if (command == "menu") {
+            WorkloadGenerator::writeMenu(out, menu);
+            return out ? 0 : 1;
+        }
+        return writeScript(generator, menu, profile, kitchenPerMinute, out);
+    }
+    cerr << usage;
+    return 2;
+}
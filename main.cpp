@@ -1,26 +1,176 @@
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
 
+#include "CommandScript.h"
+#include "CountingResource.h"
 #include "DynamicArrayList.h"
+#include "Journal.h"
+#include "KitchenFeed.h"
+#include "LatencyHistogram.h"
+#include "Logger.h"
+#include "MenuCatalog.h"
+#include "OrderIdGenerator.h"
 #include "Stack.h"
 #include "Queue.h"
+#include "OrderPipeline.h"
+#include "OrderServer.h"
+#include "ShiftArena.h"
+#include "StationQueues.h"
+#include "Trace.h"
 
 using namespace std;
 
-int main() {
+namespace {
+    const char *tracePath = "orders.trace.json";
+
+    // Writes the trace of the run so far, if tracing was compiled in
+    void writeTrace() {
+        if (Trace::enabled && !Trace::dump(tracePath)) {
+            cerr << "Could not write the trace to " << tracePath << "." << endl;
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    string scriptPath; // --script: run the commands of this file (- for stdin) instead of the menu
+    string socketPath; // --serve: take orders from POS clients on this socket instead of the menu
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "--script" && i + 1 < argc && socketPath.empty()) {
+            scriptPath = argv[++i];
+        } else if (argument == "--serve" && i + 1 < argc && scriptPath.empty()) {
+            socketPath = argv[++i];
+        } else {
+            cerr << "Usage: " << argv[0] << " [--script <file>|- | --serve <socket>]" << endl;
+            return 2;
+        }
+    }
+    bool batch = !scriptPath.empty();
+    bool serving = !socketPath.empty();
+    unique_ptr<QuietConsole> quiet; // a script runs without console output
+    if (batch) {
+        quiet = make_unique<QuietConsole>();
+        Logger::setSink(nullptr); // its messages are dropped rather than written to the silenced console
+    }
+
+    // Terminals sharing the order files must be numbered apart so their order IDs never collide
+    if (const char *terminal = getenv("ORDER_TERMINAL")) {
+        int number = atoi(terminal);
+        if (number < 0 || number >= (1 << OrderIdGenerator::terminalBits)) {
+            cerr << "ORDER_TERMINAL must be between 0 and 63." << endl;
+            return 1;
+        }
+        OrderIdGenerator::setTerminal(number);
+    }
+    ShiftArena shiftArena; // declared before the containers, whose nodes may live in it
+    if (getenv("ORDER_SHIFT_ARENA") != nullptr) {
+        ShiftArena::setCurrent(&shiftArena);
+    }
+    // Declared before the containers: they report to it until they are destroyed. A script can
+    // simply be run again, so it skips the per-record sync and checkpoints when it ends instead;
+    // the server syncs once per batch of requests before it answers them.
+    Journal journal("orders.ckpt", "orders.wal", 1000, !batch && !serving);
+    unique_ptr<KitchenFeed> kitchenFeed; // order stream for kitchen displays, if shared memory is available
+    try {
+        kitchenFeed = make_unique<KitchenFeed>();
+    } catch (const runtime_error &error) {
+        cerr << error.what() << "; kitchen displays get no orders." << endl;
+    }
+    OrderListenerGroup listeners; // everyone told about the order lifecycle
+    listeners.add(&journal);
+    if (kitchenFeed) {
+        listeners.add(kitchenFeed.get());
+    }
     DynamicArrayList menu = DynamicArrayList();
-    cout << "Loading menu items from file...\n";
-    menu.loadMenu();
-    cout << "Menu items loaded successfully!\n";
     Stack completedOrders = Stack();
     cout << "Loading completed orders from file...\n";
     completedOrders.loadTotalRevenue();
+    completedOrders.setMemoryBudget(64 * 1024 * 1024); // older orders spill to disk past 64 MB
     cout << "Completed orders loaded successfully!\n";
     Queue activeorders = Queue();
     cout << "Loading active orders from file...\n";
+    bool recovered;
+    try {
+        recovered = journal.recover(menu, activeorders, completedOrders);
+    } catch (const runtime_error &error) {
+        cerr << error.what() << endl;
+        return 1;
+    }
+    if (recovered) {
+        cout << "Recovered the menu and " << activeorders.size() << " active orders from the journal.\n";
+    } else {
+        cout << "Loading menu items from file...\n";
+        menu.loadMenu();
+        cout << "Menu items loaded successfully!\n";
+    }
+    MenuCatalog catalog(menu); // published copy read by the pipeline workers
+    OrderPipeline pipeline(completedOrders, &catalog);
+    StationQueues stations(menu, completedOrders);
+    stations.startConsumers(); // each station drains its own queue for the whole session
+
+    // Snapshot of everything the journal would otherwise have to replay
+    auto takeCheckpoint = [&] {
+        vector<const Order *> active;
+        for (const Order &order : activeorders) {
+            active.push_back(&order);
+        }
+        stations.forEachOrder([&active](const Order &order) { active.push_back(&order); });
+        journal.checkpoint(menu, active);
+    };
+    takeCheckpoint();
+    activeorders.setListener(&listeners);
+    completedOrders.setListener(&listeners);
+
+    if (batch) {
+        ifstream file;
+        if (scriptPath != "-") {
+            file.open(scriptPath);
+            if (!file) {
+                cerr << "Cannot open the script " << scriptPath << endl;
+                return 1;
+            }
+        }
+        CommandScript script(menu, catalog, activeorders, completedOrders, pipeline, journal, takeCheckpoint);
+        int failed = script.run(scriptPath == "-" ? cin : file);
+        takeCheckpoint();
+        quiet.reset();
+        script.printSummary(cout);
+        LatencyHistogram::printAll(cout);
+        CountingResource::printAll(cout);
+        writeTrace();
+        return failed == 0 ? 0 : 1;
+    }
+
+    if (serving) {
+        try {
+            OrderServer server(socketPath, menu, activeorders, [&] {
+                journal.sync();
+                if (journal.checkpointDue()) {
+                    takeCheckpoint();
+                }
+            });
+            cout << "Serving orders on " << socketPath << " until interrupted." << endl;
+            server.run();
+            takeCheckpoint();
+            writeTrace();
+            cout << "Accepted " << server.getAcceptedCount() << " orders, rejected " << server.getRejectedCount()
+                 << ", from " << server.getConnectionCount() << " connections." << endl;
+        } catch (const runtime_error &error) {
+            cerr << error.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
 
     cout << "--- Restaurant Order Management System ---" << endl;
 
     while (true) {
+        Logger::flush(); // the last choice's messages come before the menu
+        if (journal.checkpointDue()) {
+            takeCheckpoint();
+        }
         cout << "1. Display Menu" << endl;
         cout << "2. Add Menu Item" << endl;
         cout << "3. Delete Menu Item" << endl;
@@ -32,6 +182,17 @@ int main() {
         cout << "9. Calculate Total Amount of Sold Orders" << endl;
         cout << "10. Save Completed Orders to File" << endl;
         cout << "11. Exit" << endl;
+        cout << "12. Process All Orders Through Pipeline" << endl;
+        cout << "13. Route Active Orders to Stations" << endl;
+        cout << "14. Show Stations" << endl;
+        cout << "15. Show Revenue Rollups" << endl;
+        cout << "16. Show Today's Best Sellers" << endl;
+        cout << "17. Show Sales Analytics" << endl;
+        cout << "18. Find Customer Order History" << endl;
+        cout << "19. Close Shift" << endl;
+        cout << "20. Show Operation Latencies" << endl;
+        cout << "21. Write Trace" << endl;
+        cout << "22. Show Memory Usage" << endl;
         cout << "Enter your choice: ";
         int choice;
         cin >> choice;
@@ -41,33 +202,171 @@ int main() {
             case 1:
                 menu.display();
                 break;
-            case 2:
-                menu.addMenuItem();
+            case 2: {
+                int id = menu.addMenuItem();
+                journal.menuItemAdded(menu.getMenuItem(menu.findById(id)));
+                catalog.publish(menu);
+                stations.updateMenu(menu);
                 break;
-            case 3:
-                menu.deleteMenuItem();
+            }
+            case 3: {
+                int id = menu.deleteMenuItem();
+                if (id != -1) {
+                    journal.menuItemDeleted(id);
+                }
+                catalog.publish(menu);
+                stations.updateMenu(menu);
                 break;
+            }
             case 4:
                 menu.resetMenu();
+                journal.menuReset();
+                catalog.publish(menu);
+                stations.updateMenu(menu);
                 break;
             case 5:
+                activeorders.addOrder(menu);
                 break;
             case 6:
                 activeorders.processNextOrder(&completedOrders);
                 break;
             case 7:
+                activeorders.print(menu);
+                stations.print(menu);
                 break;
             case 8:
                 break;
             case 9:
                 completedOrders.calculateTotalRevenue();
+                cout << "Total revenue: $" << completedOrders.getTotalRevenue() << endl;
                 break;
             case 10:
-                completedOrders.saveCompletedOrders();
+                completedOrders.saveCompletedOrders(menu);
+                journal.completedSaved();
+                takeCheckpoint();
                 break;
             case 11:
+                takeCheckpoint();
+                writeTrace();
                 cout << "Exiting program..." << endl;
                 return 0;
+            case 12: {
+                int before = pipeline.getCompletedCount();
+                while (!activeorders.isEmpty()) {
+                    pipeline.submit(activeorders.dequeue());
+                }
+                pipeline.waitIdle();
+                cout << pipeline.getCompletedCount() - before << " orders processed through the pipeline." << endl;
+                break;
+            }
+            case 13: {
+                // Every station's consumer completes its own orders in parallel; back here once all are done
+                int before = completedOrders.getSize();
+                while (!activeorders.isEmpty()) {
+                    stations.enqueue(activeorders.dequeue());
+                }
+                stations.waitIdle();
+                cout << completedOrders.getSize() - before << " orders completed by the station consumers." << endl;
+                break;
+            }
+            case 14:
+                for (int i = 0; i < stations.getStationCount(); i++) {
+                    cout << i << ". " << stations.getStationName(i) << " (" << stations.size(i) << " orders)" << endl;
+                }
+                break;
+            case 15:
+                completedOrders.getRollup().display();
+                break;
+            case 16:
+                for (const BestSellers::Entry &entry : completedOrders.getBestSellers().topSorted()) {
+                    int index = menu.findById(entry.itemId);
+                    string name = index == -1 ? "Item " + to_string(entry.itemId)
+                                              : menu.getMenuItem(index).getName() + " (" + menu.getMenuItem(index).getDescription() + ")";
+                    cout << name << ": ~" << entry.count << " sold" << endl;
+                }
+                break;
+            case 17: {
+                const LineItemColumns &lines = completedOrders.getLineItems();
+                cout << "Revenue by item:" << endl;
+                vector<int64_t> byItem = lines.revenueByItem();
+                for (size_t id = 0; id < byItem.size(); id++) {
+                    if (byItem[id] != 0) {
+                        int index = menu.findById((int) id);
+                        string name = index == -1 ? "Item " + to_string(id) : menu.getMenuItem(index).getName();
+                        cout << "  " << name << ": $" << byItem[id] / 100.0 << endl;
+                    }
+                }
+                cout << "Revenue by hour of day:" << endl;
+                vector<int64_t> byHour = lines.revenueByHour();
+                for (int hour = 0; hour < 24; hour++) {
+                    if (byHour[hour] != 0) {
+                        cout << "  " << hour << ":00: $" << byHour[hour] / 100.0 << endl;
+                    }
+                }
+                cout << "Revenue by customer:" << endl;
+                vector<int64_t> byCustomer = lines.revenueByCustomer();
+                for (uint32_t handle = 0; handle < byCustomer.size(); handle++) {
+                    if (byCustomer[handle] != 0) {
+                        cout << "  " << completedOrders.getCustomers().lookup(handle) << ": $" << byCustomer[handle] / 100.0 << endl;
+                    }
+                }
+                break;
+            }
+            case 18: {
+                string customerName;
+                cout << "Enter the customer name: ";
+                cin.ignore();
+                getline(cin, customerName);
+                const vector<int64_t> &orderIds = completedOrders.findCustomerOrders(customerName);
+                if (orderIds.empty()) {
+                    cout << "No completed orders for " << customerName << "." << endl;
+                    break;
+                }
+                cout << customerName << " has " << orderIds.size() << " completed order(s):" << endl;
+                for (int64_t orderId : orderIds) {
+                    cout << "  Order ID: " << orderId << endl;
+                }
+                break;
+            }
+            case 19: {
+                // Persist the shift's orders, then give its memory back in one go
+                completedOrders.saveCompletedOrders(menu);
+                journal.completedSaved();
+                ShiftArena *arena = ShiftArena::getCurrent();
+                if (arena != nullptr) {
+                    ShiftArena::setCurrent(nullptr); // orders still active move to the heap
+                    activeorders.relocate();
+                    stations.relocate();
+                    size_t bytes = arena->getAllocatedBytes();
+                    if (arena->release()) {
+                        cout << "Released " << bytes << " bytes of order memory." << endl;
+                    } else {
+                        cout << arena->getLiveCount() << " orders still use the shift memory; it was kept." << endl;
+                    }
+                    ShiftArena::setCurrent(arena);
+                }
+                takeCheckpoint();
+                cout << "Shift closed." << endl;
+                break;
+            }
+            case 20:
+                LatencyHistogram::printAll(cout);
+                break;
+            case 21:
+                if (!Trace::enabled) {
+                    cout << "Tracing is not compiled in; configure with -DORDERS_TRACING=ON." << endl;
+                    break;
+                }
+                writeTrace();
+                cout << Trace::getEventCount() << " events written to " << tracePath;
+                if (Trace::getDroppedCount() > 0) {
+                    cout << ", " << Trace::getDroppedCount() << " dropped";
+                }
+                cout << "." << endl;
+                break;
+            case 22:
+                CountingResource::printAll(cout);
+                break;
             default:
                 cout << "Invalid choice. Please try again." << endl;
         }